@@ -0,0 +1,154 @@
+#include "adaptiverouting.h"
+#include "edge.h"
+#include "node.h"
+#include "networkscene.h"
+#include "routingstate.h"
+#include "topologysnapshot.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// Покоління порівнюються лише над тими самими вузлами в тому самому порядку
+bool comparable(const RoutingGeneration *x, const RoutingGeneration *y)
+{
+    if (!x || !y || x->results.empty() || y->results.empty()) return false;
+    if (x->snapshot->nodeCount() != y->snapshot->nodeCount()) return false;
+
+    for (quint32 i = 0; i < x->snapshot->nodeCount(); ++i)
+        if (x->snapshot->nodes()[i].id != y->snapshot->nodes()[i].id) return false;
+
+    return true;
+}
+
+}
+
+AdaptiveRouting::AdaptiveRouting(NetworkScene *scene, RoutingState *state, QObject *parent)
+    : QObject(parent), scene(scene), state(state), utilizationSum(0)
+{
+    timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, &AdaptiveRouting::measure);
+    connect(state, &RoutingState::published, this, &AdaptiveRouting::onPublished);
+}
+
+void AdaptiveRouting::start(const AdaptiveParams& newParams)
+{
+    stop();
+
+    params = newParams;
+    counters = AdaptiveStats();
+    utilizationSum = 0;
+    previous = state->current();
+    older.reset();
+
+    for (Node *node : scene->nodes())
+        for (Edge *edge : node->edges())
+            if (edge->sourceNode() == node)
+                edge->load() = LinkLoad{0, 0, 0, -params.holdMs};
+
+    clock.start();
+    timer->start(params.intervalMs);
+}
+
+void AdaptiveRouting::stop()
+{
+    if (!timer->isActive()) return;
+    timer->stop();
+
+    bool changed = false;
+    for (Node *node : scene->nodes())
+    {
+        for (Edge *edge : node->edges())
+        {
+            if (edge->sourceNode() != node) continue;
+
+            changed = changed || edge->load().cost != 0;
+            edge->load() = LinkLoad();
+            edge->update();
+        }
+    }
+
+    if (changed) scene->touchTopology();
+}
+
+void AdaptiveRouting::measure()
+{
+    double seconds = params.intervalMs / 1000.0;
+    qint64 now = clock.elapsed();
+    double peak = 0;
+    int changed = 0;
+
+    for (Node *node : scene->nodes())
+    {
+        for (Edge *edge : node->edges())
+        {
+            if (edge->sourceNode() != node) continue;
+
+            LinkLoad& load = edge->load();
+            double sample = load.carriedBytes / (params.capacity * seconds);
+            load.carriedBytes = 0;
+            load.smoothed = params.smoothing * sample + (1 - params.smoothing) * load.smoothed;
+            peak = std::max(peak, load.smoothed);
+
+            int base = edge->getWeight();
+            int ceiling = qRound(qMin<double>(base * params.maxFactor, maxLinkWeight));
+            int target = qBound(base, qRound(qMin<double>(base * (1 + params.gain * load.smoothed), ceiling)), ceiling);
+            int current = edge->getCost();
+
+            // Зона нечутливості й мінімальний час утримання гасять коливання вартості
+            if (target == current || qAbs(target - current) < params.hysteresis * current) continue;
+            if (now - load.lastChange < params.holdMs) continue;
+
+            load.cost = target == base ? 0 : target;
+            load.lastChange = now;
+            edge->update();
+            changed++;
+        }
+    }
+
+    counters.measurements++;
+    counters.peakUtilization = std::max(counters.peakUtilization, peak);
+    utilizationSum += peak;
+    counters.meanPeakUtilization = utilizationSum / counters.measurements;
+
+    if (changed == 0) return;
+
+    counters.costChanges += changed;
+    scene->touchTopology();
+}
+
+void AdaptiveRouting::onPublished()
+{
+    if (!timer->isActive()) return;
+
+    std::shared_ptr<const RoutingGeneration> generation = state->current();
+    if (!generation || generation == previous) return;
+
+    counters.generations++;
+    counters.reusedTrees += generation->reusedTrees;
+    counters.computedTrees += (qint64)generation->results.size() - generation->reusedTrees;
+
+    if (comparable(previous.get(), generation.get()))
+    {
+        bool history = comparable(older.get(), generation.get());
+        int n = (int)generation->results.size();
+
+        for (int s = 0; s < n; ++s)
+        {
+            const std::vector<int>& now = generation->results[s]->firstHop;
+            const std::vector<int>& before = previous->results[s]->firstHop;
+
+            for (int d = 0; d < n; ++d)
+            {
+                if (now[d] == before[d]) continue;
+
+                counters.routeChanges++;
+                if (history && older->results[s]->firstHop[d] == now[d]) counters.flaps++;
+            }
+        }
+    }
+
+    older = previous;
+    previous = generation;
+}
@@ -0,0 +1,71 @@
+#ifndef ADAPTIVEROUTING_H
+#define ADAPTIVEROUTING_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <memory>
+
+class NetworkScene;
+class RoutingState;
+struct RoutingGeneration;
+
+struct AdaptiveParams
+{
+    int intervalMs = 1000;          // період вимірювання
+    double capacity = 20000;        // номінальна пропускна здатність каналу, байт/с
+    double smoothing = 0.3;         // вага нового вимірювання в EWMA
+    double gain = 4.0;              // вартість = вага * (1 + gain * утилізація)
+    double maxFactor = 10.0;        // вартість не більша за вагу * maxFactor
+    double hysteresis = 0.25;       // відносна зміна, менша за цю, ігнорується
+    int holdMs = 3000;              // мінімальний час між змінами вартості одного каналу
+};
+
+struct AdaptiveStats
+{
+    qint64 measurements = 0;
+    qint64 costChanges = 0;
+    qint64 generations = 0;
+    qint64 reusedTrees = 0;
+    qint64 computedTrees = 0;
+    qint64 routeChanges = 0;        // пари (джерело, призначення), у яких змінився наступний крок
+    qint64 flaps = 0;               // повернення до кроку, що був два покоління тому (A -> B -> A)
+    double peakUtilization = 0;     // найбільша згладжена утилізація каналу
+    double meanPeakUtilization = 0; // середній за вимірювання максимум по каналах
+};
+
+// Періодично переводить виміряне навантаження каналів у їхні вартості й рахує, як часто через це
+// змінюються маршрути. Вартості змінюються пакетом, тож на одне вимірювання припадає один перерахунок
+class AdaptiveRouting : public QObject
+{
+    Q_OBJECT
+
+public:
+    AdaptiveRouting(NetworkScene *scene, RoutingState *state, QObject *parent = nullptr);
+
+    bool isActive() const { return timer->isActive(); }
+    const AdaptiveStats& stats() const { return counters; }
+
+    void start(const AdaptiveParams& params);
+
+    // Повертає всім каналам їхні налаштовані ваги
+    void stop();
+
+private:
+    NetworkScene *scene;
+    RoutingState *state;
+    QTimer *timer;
+    QElapsedTimer clock;
+
+    AdaptiveParams params;
+    AdaptiveStats counters;
+    double utilizationSum;
+
+    std::shared_ptr<const RoutingGeneration> previous;
+    std::shared_ptr<const RoutingGeneration> older;
+
+    void measure();
+    void onPublished();
+};
+
+#endif // ADAPTIVEROUTING_H
@@ -0,0 +1,172 @@
+#include "capacityplanner.h"
+
+#include <algorithm>
+#include <climits>
+#include <queue>
+
+namespace
+{
+
+const double epsilon = 1e-9;
+
+}
+
+CapacityPlanner::CapacityPlanner(const Topology& topology, bool minHops)
+    : edges(topology.edges), minHops(minHops), nodeCount((int)topology.nodes.size()), active(0)
+{
+    arcOffsets.assign(nodeCount + 1, 0);
+    for (const TopologyEdge& e : edges)
+    {
+        if (e.source == e.dest) continue;
+        arcOffsets[e.source + 1]++;
+        arcOffsets[e.dest + 1]++;
+    }
+    for (int i = 0; i < nodeCount; ++i)
+        arcOffsets[i + 1] += arcOffsets[i];
+
+    arcs.resize(arcOffsets[nodeCount]);
+    std::vector<int> fill(arcOffsets.begin(), arcOffsets.end() - 1);
+    for (int i = 0; i < (int)edges.size(); ++i)
+    {
+        const TopologyEdge& e = edges[i];
+        if (e.source == e.dest) continue;
+        arcs[fill[e.source]++] = {e.dest, i};
+        arcs[fill[e.dest]++] = {e.source, i};
+    }
+
+    byPriority.assign(edges.size(), {});
+    onLink.resize(edges.size());
+}
+
+double CapacityPlanner::reserved(int edge) const
+{
+    double total = 0;
+    for (double bandwidth : byPriority[edge])
+        total += bandwidth;
+    return total;
+}
+
+// Витіснити можна лише канали з пріоритетом утримання, нижчим (числово більшим) за пріоритет встановлення
+double CapacityPlanner::available(int edge, int setupPriority, bool preempt) const
+{
+    if (!preempt) return edges[edge].capacity - reserved(edge);
+
+    double held = 0;
+    for (int p = 0; p <= setupPriority && p < priorityLevels; ++p)
+        held += byPriority[edge][p];
+    return edges[edge].capacity - held;
+}
+
+bool CapacityPlanner::route(const CircuitRequest& request, bool preempt, Admission& admission) const
+{
+    std::vector<long long> dist(nodeCount, LLONG_MAX);
+    std::vector<int> parentEdge(nodeCount, -1);
+    std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> heap;
+
+    dist[request.source] = 0;
+    heap.push({0, request.source});
+
+    while (!heap.empty())
+    {
+        auto [d, u] = heap.top();
+        heap.pop();
+        if (d > dist[u]) continue;
+        if (u == request.dest) break;
+
+        for (int a = arcOffsets[u]; a < arcOffsets[u + 1]; ++a)
+        {
+            const Arc& arc = arcs[a];
+            if (available(arc.edge, request.setupPriority, preempt) + epsilon < request.bandwidth) continue;
+
+            long long candidate = d + (minHops ? 1 : edges[arc.edge].weight);
+            if (candidate >= dist[arc.neighbor]) continue;
+
+            dist[arc.neighbor] = candidate;
+            parentEdge[arc.neighbor] = arc.edge;
+            heap.push({candidate, arc.neighbor});
+        }
+    }
+
+    if (dist[request.dest] == LLONG_MAX) return false;
+
+    admission.cost = (int)dist[request.dest];
+    admission.path.clear();
+    admission.links.clear();
+
+    for (int v = request.dest; v != request.source;)
+    {
+        int e = parentEdge[v];
+        admission.path.push_back(v);
+        admission.links.push_back(e);
+        v = edges[e].source == v ? edges[e].dest : edges[e].source;
+    }
+    admission.path.push_back(request.source);
+
+    std::reverse(admission.path.begin(), admission.path.end());
+    std::reverse(admission.links.begin(), admission.links.end());
+    return true;
+}
+
+// Спершу шлях шукається лише по вільній смузі; витіснення - тільки коли без нього шляху немає
+Admission CapacityPlanner::admit(const CircuitRequest& request)
+{
+    Admission admission;
+    if (request.source < 0 || request.dest < 0 || request.source >= nodeCount || request.dest >= nodeCount) return admission;
+
+    bool found = route(request, false, admission) || route(request, true, admission);
+    if (!found) return admission;
+
+    for (int e : admission.links)
+    {
+        // Першими йдуть канали з найнижчим пріоритетом, серед них - найновіші
+        std::vector<int> victims;
+        for (int c : onLink[e])
+            if (circuits[c].active && circuits[c].request.holdPriority > request.setupPriority)
+                victims.push_back(c);
+
+        std::sort(victims.begin(), victims.end(), [this](int x, int y)
+                  {
+                      int px = circuits[x].request.holdPriority;
+                      int py = circuits[y].request.holdPriority;
+                      return px != py ? px > py : x > y;
+                  });
+
+        for (int c : victims)
+        {
+            if (available(e, request.setupPriority, false) + epsilon >= request.bandwidth) break;
+
+            release(c);
+            admission.preempted.push_back(c);
+        }
+    }
+
+    int id = (int)circuits.size();
+    circuits.push_back({request, admission.links, true});
+    active++;
+
+    for (int e : admission.links)
+    {
+        byPriority[e][std::clamp(request.holdPriority, 0, priorityLevels - 1)] += request.bandwidth;
+        onLink[e].push_back(id);
+    }
+
+    admission.admitted = true;
+    admission.circuit = id;
+    return admission;
+}
+
+void CapacityPlanner::release(int circuit)
+{
+    if (circuit < 0 || circuit >= (int)circuits.size() || !circuits[circuit].active) return;
+
+    Circuit& c = circuits[circuit];
+    c.active = false;
+    active--;
+
+    int priority = std::clamp(c.request.holdPriority, 0, priorityLevels - 1);
+    for (int e : c.links)
+    {
+        byPriority[e][priority] = std::max(0.0, byPriority[e][priority] - c.request.bandwidth);
+        onLink[e].erase(std::remove(onLink[e].begin(), onLink[e].end(), circuit), onLink[e].end());
+    }
+}
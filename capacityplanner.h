@@ -0,0 +1,75 @@
+#ifndef CAPACITYPLANNER_H
+#define CAPACITYPLANNER_H
+
+#include <array>
+#include <vector>
+#include "topology.h"
+
+// Пріоритети як у RSVP-TE: 0 - найвищий, 7 - найнижчий
+struct CircuitRequest
+{
+    int source;                 // індекси у Topology::nodes
+    int dest;
+    double bandwidth;           // Мбіт/с
+    int setupPriority = 7;      // з яким пріоритетом канал може витісняти інші
+    int holdPriority = 7;       // з яким пріоритетом канал утримує смугу
+};
+
+struct Admission
+{
+    bool admitted = false;
+    int circuit = -1;
+    int cost = 0;
+    std::vector<int> path;      // індекси вузлів від джерела
+    std::vector<int> links;     // індекси каналів уздовж шляху
+    std::vector<int> preempted; // витіснені канали
+};
+
+// Допуск віртуальних каналів за смугою (CSPF): канали без достатнього залишку відкидаються,
+// шлях шукається на решті графа, і смуга резервується вздовж нього. Якщо вільної смуги не вистачає,
+// запит може витіснити канали з нижчим пріоритетом утримання
+class CapacityPlanner
+{
+public:
+    static const int priorityLevels = 8;
+
+    explicit CapacityPlanner(const Topology& topology, bool minHops = false);
+
+    Admission admit(const CircuitRequest& request);
+    void release(int circuit);
+
+    double capacity(int edge) const { return edges[edge].capacity; }
+    double reserved(int edge) const;
+    int activeCircuits() const { return active; }
+
+private:
+    struct Circuit
+    {
+        CircuitRequest request;
+        std::vector<int> links;
+        bool active;
+    };
+
+    struct Arc
+    {
+        int neighbor;
+        int edge;
+    };
+
+    std::vector<TopologyEdge> edges;
+    bool minHops;
+    int nodeCount;
+    std::vector<int> arcOffsets;
+    std::vector<Arc> arcs;
+
+    std::vector<std::array<double, priorityLevels>> byPriority;    // смуга каналу за пріоритетом утримання
+    std::vector<std::vector<int>> onLink;
+    std::vector<Circuit> circuits;
+    int active;
+
+    // Смуга для запиту: лише вільна або разом із тією, яку він має право витіснити
+    double available(int edge, int setupPriority, bool preempt) const;
+    bool route(const CircuitRequest& request, bool preempt, Admission& admission) const;
+};
+
+#endif // CAPACITYPLANNER_H
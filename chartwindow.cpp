@@ -1,27 +1,25 @@
 #include "chartwindow.h"
 
+#include <QResizeEvent>
+#include <cmath>
+
 ChartWindow::ChartWindow(QString title, QString xLabel, QString yLabel, QWidget *parent)
-    : QDialog(parent)
+    : QDialog(parent), plottedBudget(0)
 {
     setWindowTitle(title);
     resize(800, 600);
 
-    series = new QLineSeries();
-
     chart = new QChart();
-    chart->addSeries(series);
     chart->setTitle(title);
     chart->setAnimationOptions(QChart::SeriesAnimations);
 
     axisX = new QValueAxis();
     axisX->setTitleText(xLabel);
     chart->addAxis(axisX, Qt::AlignBottom);
-    series->attachAxis(axisX);
 
     axisY = new QValueAxis();
     axisY->setTitleText(yLabel);
     chart->addAxis(axisY, Qt::AlignLeft);
-    series->attachAxis(axisY);
 
     chart->legend()->setVisible(false);
 
@@ -39,25 +37,164 @@ ChartWindow::~ChartWindow()
 
 void ChartWindow::setData(const std::vector<std::pair<double, double>>& data)
 {
-    series->clear();
+    clearSeries();
+    addSeries(QString(), data);
+}
+
+void ChartWindow::addSeries(const QString& name, const std::vector<std::pair<double, double>>& data)
+{
+    QLineSeries *series = new QLineSeries();
+    series->setName(name);
+    chart->addSeries(series);
+    series->attachAxis(axisX);
+    series->attachAxis(axisY);
+
+    seriesList.push_back({series, data});
+
+    chart->legend()->setVisible(seriesList.size() > 1);
+
+    size_t totalPoints = 0;
+    for (const auto& s : seriesList)
+        totalPoints += s.points.size();
+
+    chart->setAnimationOptions(totalPoints > animationThreshold ? QChart::NoAnimation : QChart::SeriesAnimations);
+
+    plottedBudget = pointBudget();
+    series->replace(downsample(data, plottedBudget));
+
+    updateRanges();
+}
+
+void ChartWindow::clearSeries()
+{
+    for (auto& s : seriesList)
+    {
+        chart->removeSeries(s.series);
+        delete s.series;
+    }
+    seriesList.clear();
+    chart->legend()->setVisible(false);
+}
+
+int ChartWindow::pointBudget() const
+{
+    int width = (int)chart->plotArea().width();
+    if (width <= 0) width = chartView->width();
+    if (width <= 0) width = 800;
+
+    // Два відліки на піксель, щоб зберегти піки після проріджування
+    return width * 2;
+}
 
-    if (data.empty()) return;
+void ChartWindow::refreshSeries()
+{
+    for (auto& s : seriesList)
+        s.series->replace(downsample(s.points, plottedBudget));
+}
 
-    double minX = data[0].first;
-    double maxX = data[0].first;
-    double minY = data[0].second;
-    double maxY = data[0].second;
+void ChartWindow::updateRanges()
+{
+    bool first = true;
+    double minX = 0, maxX = 0, maxY = 0;
 
-    for (const auto& point : data)
+    for (const auto& s : seriesList)
     {
-        series->append(point.first, point.second);
+        for (const auto& point : s.points)
+        {
+            if (first)
+            {
+                minX = maxX = point.first;
+                maxY = point.second;
+                first = false;
+                continue;
+            }
 
-        if (point.first < minX) minX = point.first;
-        if (point.first > maxX) maxX = point.first;
-        if (point.second < minY) minY = point.second;
-        if (point.second > maxY) maxY = point.second;
+            if (point.first < minX) minX = point.first;
+            if (point.first > maxX) maxX = point.first;
+            if (point.second > maxY) maxY = point.second;
+        }
     }
 
+    if (first) return;
+
     axisX->setRange(minX, maxX);
     axisY->setRange(0, maxY * 1.1);
 }
+
+void ChartWindow::resizeEvent(QResizeEvent *event)
+{
+    QDialog::resizeEvent(event);
+
+    int budget = pointBudget();
+    if (budget == plottedBudget) return;
+
+    bool wasDownsampled = false;
+    for (const auto& s : seriesList)
+        if ((int)s.points.size() > qMin(budget, plottedBudget)) wasDownsampled = true;
+
+    plottedBudget = budget;
+    if (wasDownsampled) refreshSeries();
+}
+
+// Largest-Triangle-Three-Buckets: зберігає форму кривої, залишаючи threshold точок
+QList<QPointF> ChartWindow::downsample(const std::vector<std::pair<double, double>>& data, int threshold)
+{
+    QList<QPointF> sampled;
+    int n = (int)data.size();
+
+    if (threshold < 3 || n <= threshold)
+    {
+        sampled.reserve(n);
+        for (const auto& point : data)
+            sampled.append(QPointF(point.first, point.second));
+        return sampled;
+    }
+
+    sampled.reserve(threshold);
+    sampled.append(QPointF(data[0].first, data[0].second));
+
+    double every = (double)(n - 2) / (threshold - 2);
+    int a = 0;
+
+    for (int i = 0; i < threshold - 2; ++i)
+    {
+        int avgStart = (int)std::floor((i + 1) * every) + 1;
+        int avgEnd = qMin((int)std::floor((i + 2) * every) + 1, n);
+
+        double avgX = 0;
+        double avgY = 0;
+        for (int j = avgStart; j < avgEnd; ++j)
+        {
+            avgX += data[j].first;
+            avgY += data[j].second;
+        }
+        int avgCount = qMax(avgEnd - avgStart, 1);
+        avgX /= avgCount;
+        avgY /= avgCount;
+
+        int rangeStart = (int)std::floor(i * every) + 1;
+        int rangeEnd = (int)std::floor((i + 1) * every) + 1;
+
+        double ax = data[a].first;
+        double ay = data[a].second;
+
+        double maxArea = -1;
+        int maxIndex = rangeStart;
+
+        for (int j = rangeStart; j < rangeEnd; ++j)
+        {
+            double area = std::fabs((ax - avgX) * (data[j].second - ay) - (ax - data[j].first) * (avgY - ay));
+            if (area > maxArea)
+            {
+                maxArea = area;
+                maxIndex = j;
+            }
+        }
+
+        sampled.append(QPointF(data[maxIndex].first, data[maxIndex].second));
+        a = maxIndex;
+    }
+
+    sampled.append(QPointF(data[n - 1].first, data[n - 1].second));
+    return sampled;
+}
@@ -6,6 +6,7 @@
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
 #include <QVBoxLayout>
+#include <vector>
 
 class ChartWindow : public QDialog
 {
@@ -16,13 +17,34 @@ public:
     ~ChartWindow();
 
     void setData(const std::vector<std::pair<double, double>>& data);
+    void addSeries(const QString& name, const std::vector<std::pair<double, double>>& data);
+    void clearSeries();
+
+    static QList<QPointF> downsample(const std::vector<std::pair<double, double>>& data, int threshold);
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
 
 private:
+    struct SeriesData
+    {
+        QLineSeries *series;
+        std::vector<std::pair<double, double>> points;
+    };
+
+    static const int animationThreshold = 1000;
+
     QChart *chart;
-    QLineSeries *series;
     QChartView *chartView;
     QValueAxis *axisX;
     QValueAxis *axisY;
+
+    std::vector<SeriesData> seriesList;
+    int plottedBudget;
+
+    int pointBudget() const;
+    void refreshSeries();
+    void updateRanges();
 };
 
 #endif // CHARTWINDOW_H
@@ -0,0 +1,81 @@
+#include "congestioncontrol.h"
+
+#include <algorithm>
+#include <limits>
+
+CongestionWindow::CongestionWindow(const CongestionParams& params)
+    : params(params), cwnd(std::max(1.0, params.initialWindow)), ssthresh(params.initialThreshold), srtt(0),
+      baseRtt(std::numeric_limits<double>::infinity()), recoveryEnd(0), nextDelayUpdate(0),
+      reductionCount(0), timeoutCount(0)
+{
+}
+
+void CongestionWindow::onAck(double now, double rtt, bool marked)
+{
+    if (rtt > 0)
+    {
+        srtt = srtt > 0 ? 0.875 * srtt + 0.125 * rtt : rtt;
+        baseRtt = std::min(baseRtt, rtt);
+    }
+
+    if (marked && params.ecn)
+    {
+        reduce(now);
+        return;
+    }
+
+    if (params.algorithm == DelayBasedControl && srtt > 0)
+    {
+        // Скільки пакетів потоку стоїть у чергах: різниця між очікуваною й фактичною швидкістю, помножена на базовий RTT
+        if (now >= nextDelayUpdate)
+        {
+            double queued = cwnd * (1 - baseRtt / srtt);
+            nextDelayUpdate = now + srtt;
+
+            if (inSlowStart())
+            {
+                if (queued > params.delayAlpha) ssthresh = cwnd;
+            }
+            else if (queued < params.delayAlpha)
+            {
+                cwnd += params.additiveIncrease;
+            }
+            else if (queued > params.delayBeta)
+            {
+                cwnd -= params.additiveIncrease;
+            }
+        }
+
+        if (inSlowStart()) cwnd += 1;
+    }
+    else
+    {
+        cwnd += inSlowStart() ? 1 : params.additiveIncrease / cwnd;
+    }
+
+    cwnd = std::clamp(cwnd, 1.0, params.maxWindow);
+}
+
+void CongestionWindow::onLoss(double now)
+{
+    reduce(now);
+}
+
+// Таймаут означає, що ACK-годинник зупинився: вікно починає з повільного старту
+void CongestionWindow::onTimeout(double now)
+{
+    ssthresh = std::max(2.0, cwnd * params.multiplicativeDecrease);
+    cwnd = std::max(1.0, params.initialWindow);
+    recoveryEnd = now + srtt;
+    timeoutCount++;
+}
+
+void CongestionWindow::reduce(double now)
+{
+    if (now < recoveryEnd) return;
+
+    ssthresh = std::max(2.0, cwnd * params.multiplicativeDecrease);
+    cwnd = ssthresh;
+    recoveryEnd = now + srtt;
+    reductionCount++;
+}
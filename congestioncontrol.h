@@ -0,0 +1,67 @@
+#ifndef CONGESTIONCONTROL_H
+#define CONGESTIONCONTROL_H
+
+enum CongestionAlgorithm
+{
+    LossBasedControl,       // AIMD у стилі Reno: сигнал - втрата або позначка ECN
+    DelayBasedControl       // у стилі Vegas: вікно тримає кілька пакетів у чергах за зростанням RTT
+};
+
+struct CongestionParams
+{
+    CongestionAlgorithm algorithm = LossBasedControl;
+    bool ecn = true;                    // позначка ECN зменшує вікно, як втрата, але без повторної передачі
+    double initialWindow = 1;           // пакетів
+    double initialThreshold = 64;
+    double additiveIncrease = 1;        // пакетів за RTT після повільного старту
+    double multiplicativeDecrease = 0.5;
+    double delayAlpha = 2;              // delay-based: менше стількох пакетів у чергах - вікно росте
+    double delayBeta = 4;               // більше - зменшується
+    double maxWindow = 10000;
+};
+
+// Одна точка трасування вікна; flow = -1 для живого віртуального каналу
+struct CwndSample
+{
+    double time;
+    int flow;
+    double window;
+    double threshold;
+    double rtt;
+};
+
+// Вікно перевантаження відправника. Час і RTT - у секундах; вікно зменшується не частіше за раз на RTT,
+// тож пачка втрат з одного вікна дає одне зменшення
+class CongestionWindow
+{
+public:
+    explicit CongestionWindow(const CongestionParams& params);
+
+    double window() const { return cwnd; }
+    double threshold() const { return ssthresh; }
+    bool inSlowStart() const { return cwnd < ssthresh; }
+    double smoothedRtt() const { return srtt; }
+
+    int reductions() const { return reductionCount; }
+    int timeouts() const { return timeoutCount; }
+
+    // rtt <= 0 - без вимірювання (за Карном, для повторно переданих пакетів)
+    void onAck(double now, double rtt, bool marked);
+    void onLoss(double now);
+    void onTimeout(double now);
+
+private:
+    CongestionParams params;
+    double cwnd;
+    double ssthresh;
+    double srtt;
+    double baseRtt;
+    double recoveryEnd;
+    double nextDelayUpdate;
+    int reductionCount;
+    int timeoutCount;
+
+    void reduce(double now);
+};
+
+#endif // CONGESTIONCONTROL_H
@@ -0,0 +1,26 @@
+#ifndef CONVERGENCE_H
+#define CONVERGENCE_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Показники однієї фази експерименту з протоколом маршрутизації (старт, відмова, відновлення)
+struct ConvergenceStats
+{
+    QString phase;
+
+    double convergenceTime = 0;     // с від початку фази до останньої зміни FIB
+    double quietTime = 0;           // с до останнього керуючого повідомлення
+
+    qint64 messages = 0;            // усі керуючі повідомлення, включно з підтвердженнями
+    qint64 bytes = 0;
+    qint64 duplicates = 0;          // повідомлення, що не змінили базу отримувача
+    qint64 computations = 0;        // запуски SPF або перерахунки вектора
+    int maxComputations = 0;        // найбільше на одному маршрутизаторі
+    qint64 metricIncreases = 0;     // зростання скінченних метрик - ознака рахунку до нескінченності
+
+    int inconsistentRouters = 0;    // FIB не збігається з еталонними найкоротшими шляхами
+    bool completed = true;          // false, якщо прогін скасовано або обірвано лімітом
+};
+
+#endif // CONVERGENCE_H
@@ -0,0 +1,84 @@
+#ifndef COUNTERRNG_H
+#define COUNTERRNG_H
+
+#include <cstdint>
+
+// Лічильниковий генератор Philox4x32-10: кожне число - чиста функція (seed, потік, номер блоку),
+// тож результат не залежить від порядку виконання потоків. Потік задається трьома словами,
+// наприклад (потік даних, пакет, хоп) або (канал, 0, 0)
+class CounterRng
+{
+public:
+    using result_type = uint32_t;
+
+    explicit CounterRng(uint64_t seed, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0)
+        : key{(uint32_t)seed, (uint32_t)(seed >> 32)}, counter{a, b, c, 0}, used(4)
+    {
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()()
+    {
+        if (used == 4)
+        {
+            generate(counter, key, block);
+            counter[3]++;
+            used = 0;
+        }
+        return block[used++];
+    }
+
+    uint64_t next64()
+    {
+        uint64_t hi = (*this)();
+        return (hi << 32) | (*this)();
+    }
+
+    // [0, 1) з 53 значущими бітами
+    double uniform()
+    {
+        return (next64() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    int below(int n)
+    {
+        return (int)(((uint64_t)(*this)() * (uint64_t)n) >> 32);
+    }
+
+    static void generate(const uint32_t in[4], const uint32_t k[2], uint32_t out[4])
+    {
+        uint32_t c0 = in[0], c1 = in[1], c2 = in[2], c3 = in[3];
+        uint32_t k0 = k[0], k1 = k[1];
+
+        for (int round = 0; round < 10; ++round)
+        {
+            uint64_t p0 = (uint64_t)0xD2511F53u * c0;
+            uint64_t p1 = (uint64_t)0xCD9E8D57u * c2;
+
+            uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+            c1 = (uint32_t)p1;
+            c3 = (uint32_t)p0;
+            c0 = n0;
+            c2 = n2;
+
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+private:
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t block[4];
+    int used;
+};
+
+#endif // COUNTERRNG_H
@@ -0,0 +1,130 @@
+#include "crc32c.h"
+
+#include <cstring>
+
+// Інструкція crc32 вибирається під час виконання, тож та сама збірка працює й на процесорах без SSE4.2
+#if defined(__x86_64__) || defined(_M_X64)
+#define CRC32C_X86 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(CRC32C_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32C_TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+#define CRC32C_TARGET_SSE42
+#endif
+
+namespace
+{
+
+const uint32_t polynomial = 0x82F63B78;     // 0x1EDC6F41 у зворотному порядку бітів
+
+struct Tables
+{
+    uint32_t t[8][256];
+
+    Tables()
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (polynomial & (0u - (crc & 1)));
+            t[0][i] = crc;
+        }
+
+        for (uint32_t i = 0; i < 256; ++i)
+            for (int k = 1; k < 8; ++k)
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+    }
+};
+
+const Tables& tables()
+{
+    static const Tables instance;
+    return instance;
+}
+
+#if defined(CRC32C_X86)
+CRC32C_TARGET_SSE42 uint32_t computeSse42(const uint8_t *data, size_t length, uint32_t crc)
+{
+    uint64_t state = ~crc;
+
+    for (; length >= 8; data += 8, length -= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        state = _mm_crc32_u64(state, word);
+    }
+
+    uint32_t tail = (uint32_t)state;
+    while (length--)
+        tail = _mm_crc32_u8(tail, *data++);
+
+    return ~tail;
+}
+#endif
+
+bool detectSse42()
+{
+#if defined(CRC32C_X86) && (defined(__GNUC__) || defined(__clang__))
+    return __builtin_cpu_supports("sse4.2");
+#elif defined(CRC32C_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool hasSse42()
+{
+    static const bool supported = detectSse42();
+    return supported;
+}
+
+}
+
+uint32_t Crc32c::computePortable(const uint8_t *data, size_t length, uint32_t crc)
+{
+    const Tables& tab = tables();
+    crc = ~crc;
+
+    while (length >= 8)
+    {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, data, 4);
+        std::memcpy(&high, data + 4, 4);
+        low ^= crc;
+
+        // Слова читаються як little-endian, тож на big-endian платформі знадобився б обмін байтів
+        crc = tab.t[7][low & 0xFF] ^ tab.t[6][(low >> 8) & 0xFF] ^ tab.t[5][(low >> 16) & 0xFF] ^ tab.t[4][low >> 24] ^
+              tab.t[3][high & 0xFF] ^ tab.t[2][(high >> 8) & 0xFF] ^ tab.t[1][(high >> 16) & 0xFF] ^ tab.t[0][high >> 24];
+
+        data += 8;
+        length -= 8;
+    }
+
+    while (length--)
+        crc = (crc >> 8) ^ tab.t[0][(crc ^ *data++) & 0xFF];
+
+    return ~crc;
+}
+
+uint32_t Crc32c::compute(const uint8_t *data, size_t length, uint32_t crc)
+{
+#if defined(CRC32C_X86)
+    if (hasSse42()) return computeSse42(data, length, crc);
+#endif
+    return computePortable(data, length, crc);
+}
+
+bool Crc32c::accelerated()
+{
+    return hasSse42();
+}
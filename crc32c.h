@@ -0,0 +1,21 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC32C (Castagnoli). Якщо процесор має SSE4.2, рахується інструкцією crc32 по 8 байт, інакше - таблицями slicing-by-8
+class Crc32c
+{
+public:
+    // Продовжує crc попередніх байтів; для нового блоку crc = 0
+    static uint32_t compute(const uint8_t *data, size_t length, uint32_t crc = 0);
+
+    // Таблична версія незалежно від збірки: для порівняння швидкості й перевірки
+    static uint32_t computePortable(const uint8_t *data, size_t length, uint32_t crc = 0);
+
+    // Процесор підтримує SSE4.2, і compute використовує інструкцію crc32
+    static bool accelerated();
+};
+
+#endif // CRC32C_H
@@ -0,0 +1,237 @@
+#include "datagramfragmenter.h"
+#include "networkscene.h"
+#include "node.h"
+#include "packet.h"
+
+#include <QPointer>
+
+#include <algorithm>
+
+namespace
+{
+
+quint64 nodePair(int first, int second)
+{
+    return ((quint64)(quint32)first << 32) | (quint32)second;
+}
+
+}
+
+DatagramFragmenter::DatagramFragmenter(NetworkScene *scene, QObject *parent)
+    : QObject(parent), scene(scene), mtuMode(FragmentInNetwork), timeout(15), memoryLimit(65536), nextDatagram(0)
+{
+    timer = new QTimer(this);
+    timer->setInterval(200);
+    connect(timer, &QTimer::timeout, this, &DatagramFragmenter::expire);
+    clock.start();
+}
+
+void DatagramFragmenter::configure(MtuMode mode, double newTimeout, int newMemoryLimit)
+{
+    mtuMode = mode;
+    timeout = newTimeout;
+    memoryLimit = newMemoryLimit;
+    pathMtu.clear();
+}
+
+int DatagramFragmenter::sourceMtu(int sourceId, int destId) const
+{
+    return mtuMode == PathMtuDiscovery ? pathMtu.value(nodePair(sourceId, destId)) : 0;
+}
+
+void DatagramFragmenter::oversized(Packet *pkt, int nodeId, int nextId, int ttl, int mtu, Done done)
+{
+    if (mtuMode == FragmentInNetwork)
+    {
+        fragment(pkt, nodeId, ttl, mtu, done);
+        return;
+    }
+
+    // Маршрутизатор не ділить пакет: відкидає його й повідомляє джерелу MTU каналу
+    quint64 key = nodePair(pkt->getSource(), pkt->getDestination());
+    if (!pathMtu.contains(key) || pathMtu.value(key) > mtu) pathMtu[key] = mtu;
+    counters.tooBig++;
+
+    emit packetTooBig(nodeId, nextId, pkt->getSequenceNumber(), pkt->getDataSize() + packetHeaderBytes, mtu, pkt->getSource());
+    done(true, nodeId);
+}
+
+void DatagramFragmenter::fragment(Packet *pkt, int nodeId, int ttl, int mtu, Done done)
+{
+    Node *node = scene->node(nodeId);
+    bool isFragment = pkt->getDatagram() != 0;
+    std::vector<Fragment> pieces = Fragmentation::split({pkt->getFragmentOffset(), pkt->getDataSize(), !pkt->hasMoreFragments()}, mtu);
+
+    if (!node || pieces.empty())
+    {
+        emit headerTooBig(nodeId, mtu);
+        done(true, nodeId);
+        return;
+    }
+
+    // Маршрутизатор перевіряє пакет, перш ніж переписати заголовки: спотворені дані не множаться у фрагментах
+    if (verify && !verify(pkt, nodeId))
+    {
+        done(true, nodeId);
+        return;
+    }
+
+    int id = pkt->getSequenceNumber();
+    int sourceId = pkt->getSource();
+    int destId = pkt->getDestination();
+    int trafficClass = pkt->getTrafficClass();
+    int baseOffset = pkt->getFragmentOffset();
+    PacketBuffer *bytes = pkt->getBuffer();
+    quint64 datagram = pkt->getDatagram();
+
+    if (!isFragment)
+    {
+        datagram = ++nextDatagram;
+        fragmented[datagram] = {done, destId, 0};
+        counters.datagrams++;
+        pkt->setVisible(false);
+    }
+
+    // Дейтаграму вже оголошено втраченою, наприклад витіснено з буфера збирання
+    auto it = fragmented.find(datagram);
+    if (it == fragmented.end())
+    {
+        done(true, nodeId);
+        return;
+    }
+    it->second.outstanding += (int)pieces.size();
+
+    int overhead = (int)(pieces.size() - 1) * packetHeaderBytes;
+    counters.fragments += pieces.size();
+    counters.overheadBytes += overhead;
+    emit headersAdded(overhead);
+
+    for (const Fragment& piece : pieces)
+    {
+        Packet *fragment = new Packet(id, piece.length, DATA);
+        fragment->setSource(sourceId);
+        fragment->setDestination(destId);
+        fragment->setTrafficClass(trafficClass);
+        fragment->setFragment(datagram, piece.offset, !piece.last);
+        if (bytes && seal) seal(fragment, *bytes, piece.offset - baseOffset);
+        scene->addItem(fragment);
+        fragment->setPos(node->pos());
+        fragment->setVisible(true);
+
+        QPointer<Packet> alive(fragment);
+        forward(fragment, nodeId, ttl, [=](bool lost, int lostNode)
+                {
+                    if (alive)
+                    {
+                        scene->removeItem(fragment);
+                        delete fragment;
+                    }
+                    fragmentArrived(datagram, piece, lost, lostNode);
+                });
+    }
+
+    // Повторно поділений фрагмент замінили новими
+    if (isFragment) done(true, nodeId);
+}
+
+void DatagramFragmenter::fragmentArrived(quint64 datagram, const Fragment& fragment, bool lost, int lostNode)
+{
+    auto it = fragmented.find(datagram);
+    if (it == fragmented.end()) return;
+
+    it->second.outstanding--;
+    int destId = it->second.destId;
+
+    if (!lost)
+    {
+        ReassemblyBuffer& buffer = reassembly.try_emplace(destId, memoryLimit, timeout).first->second;
+        bool complete = buffer.add(datagram, fragment, now());
+
+        for (quint64 evicted : buffer.takeEvicted())
+        {
+            emit reassemblyDropped(destId, false);
+            finish(evicted, true, destId);
+        }
+
+        if (complete)
+        {
+            finish(datagram, false, 0);
+            return;
+        }
+        if (!timer->isActive()) timer->start();
+    }
+
+    // Решта фрагментів загубилась у мережі, а в буфері нічого немає: чекати таймауту нема чого
+    it = fragmented.find(datagram);
+    if (it == fragmented.end() || it->second.outstanding > 0) return;
+
+    auto buffer = reassembly.find(destId);
+    if (buffer == reassembly.end() || !buffer->second.contains(datagram)) finish(datagram, true, lostNode);
+}
+
+void DatagramFragmenter::finish(quint64 datagram, bool lost, int lostNode)
+{
+    auto it = fragmented.find(datagram);
+    if (it == fragmented.end()) return;
+
+    Done done = it->second.done;
+    fragmented.erase(it);
+    done(lost, lostNode);
+}
+
+void DatagramFragmenter::expire()
+{
+    std::vector<std::pair<int, quint64>> expired;
+    bool waiting = false;
+
+    for (auto& entry : reassembly)
+    {
+        for (quint64 datagram : entry.second.expire(now()))
+            expired.push_back({entry.first, datagram});
+        waiting = waiting || !entry.second.empty();
+    }
+
+    if (!waiting) timer->stop();
+
+    for (const auto& entry : expired)
+    {
+        emit reassemblyDropped(entry.first, true);
+        finish(entry.second, true, entry.first);
+    }
+}
+
+void DatagramFragmenter::reset()
+{
+    timer->stop();
+    reassembly.clear();
+    pathMtu.clear();
+    counters = FragmentationStats();
+    clock.start();
+
+    std::unordered_map<quint64, FragmentedDatagram> pending;
+    pending.swap(fragmented);
+    for (auto& entry : pending)
+        entry.second.done(true, entry.second.destId);
+}
+
+ReassemblyStats DatagramFragmenter::reassemblyStats() const
+{
+    ReassemblyStats total;
+    for (const auto& entry : reassembly)
+    {
+        const ReassemblyStats& stats = entry.second.stats();
+        total.completed += stats.completed;
+        total.timedOut += stats.timedOut;
+        total.evicted += stats.evicted;
+        total.peakMemory = std::max(total.peakMemory, stats.peakMemory);
+    }
+    return total;
+}
+
+int DatagramFragmenter::reassemblyMemoryUsed() const
+{
+    int memory = 0;
+    for (const auto& entry : reassembly)
+        memory += entry.second.memoryUsed();
+    return memory;
+}
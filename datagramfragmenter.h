@@ -0,0 +1,98 @@
+#ifndef DATAGRAMFRAGMENTER_H
+#define DATAGRAMFRAGMENTER_H
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+#include <unordered_map>
+#include "fragmentation.h"
+
+class NetworkScene;
+class Packet;
+class PacketBuffer;
+
+// Фрагментація на шляху дейтаграм: поділ на вузлі, вивчені з "Packet Too Big" MTU шляхів і буфери збирання
+// у призначеннях. Фрагменти - окремі пакети сцени, які вузли пересилають так само, як цілі дейтаграми
+class DatagramFragmenter : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Done = std::function<void(bool lost, int lostNode)>;
+
+    DatagramFragmenter(NetworkScene *scene, QObject *parent = nullptr);
+
+    // Пересилання з вузла за FIB; фрагменти йдуть далі самостійно й можуть ділитися ще раз
+    std::function<void(Packet *pkt, int nodeId, int ttl, Done done)> forward;
+
+    // Режим з байтами: маршрутизатор перевіряє CRC перед поділом, а кожен фрагмент отримує зріз даних оригіналу
+    std::function<bool(Packet *pkt, int nodeId)> verify;
+    std::function<void(Packet *fragment, const PacketBuffer& original, int sliceOffset)> seal;
+
+    MtuMode mode() const { return mtuMode; }
+    double reassemblyTimeout() const { return timeout; }
+    int reassemblyMemory() const { return memoryLimit; }
+
+    // Нові налаштування діють з наступної дейтаграми; вивчені MTU шляхів забуваються
+    void configure(MtuMode mode, double timeout, int memoryLimit);
+    void forgetPathMtus() { pathMtu.clear(); }
+
+    // З PMTUD джерело ділить дейтаграму за MTU шляху, який йому повідомили маршрутизатори; 0 - не обмежено
+    int sourceMtu(int sourceId, int destId) const;
+
+    // Пакет на вузлі nodeId не вміщається в канал до nextId. Фрагментація в мережі ділить його тут;
+    // PMTUD відкидає його, а джерело запам'ятовує MTU шляху
+    void oversized(Packet *pkt, int nodeId, int nextId, int ttl, int mtu, Done done);
+
+    // Ділить пакет на вузлі; оригінал ховається й отримує done, коли дейтаграму зібрано або втрачено
+    void fragment(Packet *pkt, int nodeId, int ttl, int mtu, Done done);
+
+    // Незібрані дейтаграми вважаються втраченими, а вивчені MTU шляхів забуваються
+    void reset();
+
+    const FragmentationStats& stats() const { return counters; }
+    ReassemblyStats reassemblyStats() const;
+    int reassemblyMemoryUsed() const;
+    int reassemblyNodes() const { return (int)reassembly.size(); }
+    int knownPathMtus() const { return pathMtu.size(); }
+
+signals:
+    // Додаткові заголовки фрагментів, що пішли в мережу
+    void headersAdded(int bytes);
+
+    void headerTooBig(int nodeId, int mtu);
+    void packetTooBig(int nodeId, int nextId, int sequence, int bytes, int mtu, int sourceId);
+    void reassemblyDropped(int nodeId, bool timedOut);
+
+private:
+    struct FragmentedDatagram
+    {
+        Done done;
+        int destId;
+        int outstanding;                // фрагменти ще в мережі
+    };
+
+    NetworkScene *scene;
+    QTimer *timer;
+    QElapsedTimer clock;
+
+    MtuMode mtuMode;
+    double timeout;                     // с від першого фрагмента
+    int memoryLimit;                    // байт на вузол
+
+    std::unordered_map<quint64, FragmentedDatagram> fragmented;
+    quint64 nextDatagram;
+    std::unordered_map<int, ReassemblyBuffer> reassembly;
+    QHash<quint64, int> pathMtu;        // (джерело, призначення) -> MTU з повідомлень "Packet Too Big"
+    FragmentationStats counters;
+
+    double now() const { return clock.elapsed() / 1000.0; }
+
+    void fragmentArrived(quint64 datagram, const Fragment& fragment, bool lost, int lostNode);
+    void finish(quint64 datagram, bool lost, int lostNode);
+    void expire();
+};
+
+#endif // DATAGRAMFRAGMENTER_H
@@ -1,6 +1,7 @@
 #include "dijkstra.h"
 #include "node.h"
 #include "edge.h"
+#include "topologysnapshot.h"
 #include <map>
 #include <queue>
 #include <limits>
@@ -8,8 +9,6 @@
 
 using namespace std;
 
-bool Dijkstra::useMinHops = false;
-
 const int INF = std::numeric_limits<int>::max();
 
 vector<RoutingEntry> Dijkstra::calculate(Node* startNode, const QList<Node*>& allNodes)
@@ -176,3 +175,78 @@ vector<RoutingEntry> Dijkstra::calculateMinHops(Node* startNode, const QList<Nod
 
     return table;
 }
+
+ShortestPathTree Dijkstra::shortestPathTree(const TopologySnapshot& graph, int sourceIndex, bool minHops,
+                                            const std::atomic<bool> *cancelled)
+{
+    ShortestPathTree tree;
+    int n = graph.nodeCount();
+
+    tree.source = sourceIndex;
+    tree.dist.assign(n, INF);
+    tree.cost.assign(n, INF);
+    tree.parent.assign(n, -1);
+
+    if (sourceIndex < 0 || sourceIndex >= n) return tree;
+
+    const quint32 *offsets = graph.arcOffsets();
+    const SnapshotArc *arcs = graph.arcs();
+    const SnapshotEdge *edges = graph.edges();
+
+    tree.dist[sourceIndex] = 0;
+    tree.cost[sourceIndex] = 0;
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+    pq.push({0, sourceIndex});
+    unsigned settled = 0;
+
+    while (!pq.empty())
+    {
+        auto [d, u] = pq.top();
+        pq.pop();
+
+        if (cancelled && (++settled & 4095) == 0 && cancelled->load(std::memory_order_relaxed)) break;
+
+        if (d > tree.dist[u]) continue;
+
+        for (quint32 a = offsets[u]; a < offsets[u + 1]; ++a)
+        {
+            int v = arcs[a].neighbor;
+            int weight = edges[arcs[a].edge].weight;
+            int step = minHops ? 1 : weight;
+
+            if (d + step < tree.dist[v])
+            {
+                tree.dist[v] = d + step;
+                tree.cost[v] = tree.cost[u] + weight;
+                tree.parent[v] = u;
+                pq.push({tree.dist[v], v});
+            }
+        }
+    }
+
+    return tree;
+}
+
+vector<RoutingEntry> Dijkstra::routingTable(const TopologySnapshot& graph, const ShortestPathTree& tree)
+{
+    vector<RoutingEntry> table;
+    const SnapshotNode *nodes = graph.nodes();
+
+    for (int target = 0; target < (int)tree.dist.size(); ++target)
+    {
+        if (target == tree.source || tree.dist[target] == INF) continue;
+
+        RoutingEntry entry;
+        entry.destinationID = nodes[target].id;
+        entry.totalCost = tree.cost[target];
+
+        for (int v = target; v != -1; v = tree.parent[v])
+            entry.fullPath.push_back(nodes[v].id);
+        std::reverse(entry.fullPath.begin(), entry.fullPath.end());
+
+        table.push_back(entry);
+    }
+
+    return table;
+}
@@ -2,9 +2,11 @@
 #define DIJKSTRA_H
 
 #include <vector>
+#include <atomic>
 #include <QList>
 
 class Node;
+class TopologySnapshot;
 
 struct RoutingEntry
 {
@@ -13,13 +15,25 @@ struct RoutingEntry
     int totalCost;
 };
 
+// Дерево найкоротших шляхів над індексами вузлів знімка; dist - метрика пошуку, cost - сума ваг
+struct ShortestPathTree
+{
+    int source;
+    std::vector<int> dist;
+    std::vector<int> cost;
+    std::vector<int> parent;
+};
+
 class Dijkstra
 {
 public:
-    static bool useMinHops;
-
     static std::vector<RoutingEntry> calculate(Node* startNode, const QList<Node*>& allNodes);
     static std::vector<RoutingEntry> calculateMinHops(Node* startNode, const QList<Node*>& allNodes);
+
+    // cancelled перевіряється під час обходу; перерване дерево неповне і має бути відкинуте
+    static ShortestPathTree shortestPathTree(const TopologySnapshot& graph, int sourceIndex, bool minHops,
+                                             const std::atomic<bool> *cancelled = nullptr);
+    static std::vector<RoutingEntry> routingTable(const TopologySnapshot& graph, const ShortestPathTree& tree);
 };
 
 #endif // DIJKSTRA_H
@@ -0,0 +1,417 @@
+#include "distancevector.h"
+
+#include <algorithm>
+#include <climits>
+#include <queue>
+
+// Векторне ядро вибирається під час виконання, тож збірка без -msse4.1 однаково ним користується
+#if defined(__x86_64__) || defined(_M_X64)
+#define RELAX_X86 1
+#include <smmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(RELAX_X86) && (defined(__GNUC__) || defined(__clang__))
+#define RELAX_TARGET_SSE41 __attribute__((target("sse4.1")))
+#else
+#define RELAX_TARGET_SSE41
+#endif
+
+namespace
+{
+
+// Як у RIPv2: до 25 записів по 20 байт на пакет, заголовки IP 20 + UDP 8 + RIP 4
+const int entriesPerPacket = 25;
+const int packetHeaderBytes = 32;
+const int entryBytes = 20;
+
+void relaxScalar(int32_t *dist, int32_t *hop, const int32_t *adv, int32_t cost, int32_t neighbor, int32_t inf, int d, int count)
+{
+    for (; d < count; ++d)
+    {
+        int32_t candidate = std::min(adv[d] + cost, inf);
+        if (candidate < dist[d])
+        {
+            dist[d] = candidate;
+            hop[d] = neighbor;
+        }
+    }
+}
+
+#if defined(RELAX_X86)
+RELAX_TARGET_SSE41 void relaxSse41(int32_t *dist, int32_t *hop, const int32_t *adv, int32_t cost, int32_t neighbor,
+                                   int32_t inf, int count)
+{
+    const __m128i vcost = _mm_set1_epi32(cost);
+    const __m128i vinf = _mm_set1_epi32(inf);
+    const __m128i vneighbor = _mm_set1_epi32(neighbor);
+
+    int d = 0;
+    for (; d + 4 <= count; d += 4)
+    {
+        __m128i candidate = _mm_min_epi32(_mm_add_epi32(_mm_loadu_si128((const __m128i*)(adv + d)), vcost), vinf);
+        __m128i best = _mm_loadu_si128((const __m128i*)(dist + d));
+        __m128i better = _mm_cmplt_epi32(candidate, best);
+
+        _mm_storeu_si128((__m128i*)(dist + d), _mm_min_epi32(candidate, best));
+        _mm_storeu_si128((__m128i*)(hop + d), _mm_blendv_epi8(_mm_loadu_si128((const __m128i*)(hop + d)), vneighbor, better));
+    }
+
+    relaxScalar(dist, hop, adv, cost, neighbor, inf, d, count);
+}
+#endif
+
+bool detectSse41()
+{
+#if defined(RELAX_X86) && (defined(__GNUC__) || defined(__clang__))
+    return __builtin_cpu_supports("sse4.1");
+#elif defined(RELAX_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool hasSse41()
+{
+    static const bool supported = detectSse41();
+    return supported;
+}
+
+}
+
+// Оголошення й вартості не перевищують inf <= INT32_MAX / 2, тож adv[d] + cost не переповнюється
+void DistanceVectorSimulation::relax(int32_t *dist, int32_t *hop, const int32_t *adv, int32_t cost, int32_t neighbor,
+                                     int32_t inf, int count)
+{
+    cost = std::min(cost, inf);
+
+#if defined(RELAX_X86)
+    if (hasSse41())
+    {
+        relaxSse41(dist, hop, adv, cost, neighbor, inf, count);
+        return;
+    }
+#endif
+
+    relaxScalar(dist, hop, adv, cost, neighbor, inf, 0, count);
+}
+
+DistanceVectorSimulation::DistanceVectorSimulation(const Topology& topology, const DistanceVectorParams& params)
+    : params(params), n((int)topology.nodes.size()), nodes(topology.nodes), edges(topology.edges),
+      phaseStart(0), lastFibChange(0), lastMessage(0)
+{
+    int maxWeight = 1;
+    for (const TopologyEdge& e : edges)
+        maxWeight = std::max(maxWeight, e.weight);
+    long long infinity = params.infinity > 0 ? params.infinity : (params.minHops ? 16 : 16LL * maxWeight);
+    inf = (int32_t)std::min<long long>(infinity, INT32_MAX / 2);
+
+    edgeUp.assign(edges.size(), 1);
+    edgeSlots.assign(edges.size(), {-1, -1});
+
+    std::vector<std::vector<std::pair<int, int>>> incident(n);
+    for (int i = 0; i < (int)edges.size(); ++i)
+    {
+        const TopologyEdge& e = edges[i];
+        if (e.source == e.dest) continue;
+        incident[e.source].push_back({e.dest, i});
+        incident[e.dest].push_back({e.source, i});
+    }
+
+    slotOffsets.assign(n + 1, 0);
+    for (int r = 0; r < n; ++r)
+    {
+        std::sort(incident[r].begin(), incident[r].end());
+        for (const auto& link : incident[r])
+        {
+            if (slots.empty() || (int)slots.size() == slotOffsets[r] || slots.back().neighbor != link.first)
+                slots.push_back({link.first, -1, {}});
+            slots.back().edges.push_back(link.second);
+
+            auto& ends = edgeSlots[link.second];
+            (edges[link.second].source == r ? ends.first : ends.second) = (int)slots.size() - 1;
+        }
+        slotOffsets[r + 1] = (int)slots.size();
+    }
+
+    for (int r = 0; r < n; ++r)
+    {
+        for (int s = slotOffsets[r]; s < slotOffsets[r + 1]; ++s)
+        {
+            int k = slots[s].neighbor;
+            auto begin = slots.begin() + slotOffsets[k];
+            auto end = slots.begin() + slotOffsets[k + 1];
+            auto it = std::lower_bound(begin, end, r, [](const Slot& slot, int id) { return slot.neighbor < id; });
+            slots[s].reverse = (int)(it - slots.begin());
+        }
+    }
+
+    dist.assign((size_t)n * n, inf);
+    hop.assign((size_t)n * n, -1);
+    for (int r = 0; r < n; ++r)
+    {
+        dist[(size_t)r * n + r] = 0;
+        hop[(size_t)r * n + r] = r;
+    }
+
+    advertised.assign(slots.size() * (size_t)n, inf);
+    routers.resize(n);
+}
+
+int32_t DistanceVectorSimulation::slotCost(int slot) const
+{
+    int32_t cost = -1;
+    for (int e : slots[slot].edges)
+    {
+        if (!edgeUp[e]) continue;
+        int32_t weight = params.minHops ? 1 : edges[e].weight;
+        if (cost < 0 || weight < cost) cost = weight;
+    }
+    return cost;
+}
+
+void DistanceVectorSimulation::beginPhase(const QString& phase, bool settle)
+{
+    if (settle) queue.advanceTo(queue.now() + 1);
+
+    stats = ConvergenceStats();
+    stats.phase = phase;
+    phaseStart = queue.now();
+    lastFibChange = phaseStart;
+    lastMessage = phaseStart;
+
+    for (Router& router : routers)
+        router.recomputes = 0;
+}
+
+ConvergenceStats DistanceVectorSimulation::coldStart(const std::atomic<bool> *cancelled)
+{
+    beginPhase("Холодний старт", false);
+
+    for (int r = 0; r < n; ++r)
+        triggerUpdate(r);
+
+    return runPhase(cancelled);
+}
+
+ConvergenceStats DistanceVectorSimulation::setLinkState(int edgeIndex, bool up, const std::atomic<bool> *cancelled)
+{
+    const TopologyEdge& e = edges[edgeIndex];
+    QString link = QString::number(nodes[e.source].id) + "-" + QString::number(nodes[e.dest].id);
+    beginPhase((up ? "Відновлення каналу " : "Відмова каналу ") + link, true);
+
+    if (edgeUp[edgeIndex] == (char)up || e.source == e.dest) return runPhase(cancelled);
+    edgeUp[edgeIndex] = up;
+
+    // Обидва кінці помічають зміну одразу; вектор втраченого сусіда забувається
+    for (int slot : {edgeSlots[edgeIndex].first, edgeSlots[edgeIndex].second})
+        if (slotCost(slot) < 0)
+            std::fill_n(advertised.begin() + (size_t)slot * n, n, inf);
+
+    recompute(e.source);
+    recompute(e.dest);
+
+    if (up)
+    {
+        triggerUpdate(e.source);
+        triggerUpdate(e.dest);
+    }
+
+    return runPhase(cancelled);
+}
+
+void DistanceVectorSimulation::recompute(int router)
+{
+    scratchDist.assign(n, inf);
+    scratchHop.assign(n, -1);
+
+    for (int s = slotOffsets[router]; s < slotOffsets[router + 1]; ++s)
+    {
+        int32_t cost = slotCost(s);
+        if (cost < 0) continue;
+        relax(scratchDist.data(), scratchHop.data(), &advertised[(size_t)s * n], cost, slots[s].neighbor, inf, n);
+    }
+
+    scratchDist[router] = 0;
+    scratchHop[router] = router;
+
+    routers[router].recomputes++;
+    stats.computations++;
+
+    int32_t *rowDist = &dist[(size_t)router * n];
+    int32_t *rowHop = &hop[(size_t)router * n];
+    bool changed = false;
+
+    for (int d = 0; d < n; ++d)
+    {
+        if (rowDist[d] == scratchDist[d] && rowHop[d] == scratchHop[d]) continue;
+
+        if (rowDist[d] < inf && scratchDist[d] < inf && scratchDist[d] > rowDist[d]) stats.metricIncreases++;
+        changed = true;
+    }
+
+    if (!changed) return;
+
+    std::copy(scratchDist.begin(), scratchDist.end(), rowDist);
+    std::copy(scratchHop.begin(), scratchHop.end(), rowHop);
+    lastFibChange = std::max(lastFibChange, queue.now());
+    triggerUpdate(router);
+}
+
+void DistanceVectorSimulation::triggerUpdate(int router)
+{
+    if (routers[router].updatePending) return;
+
+    routers[router].updatePending = true;
+    queue.push(queue.now() + params.updateDelay, {SendUpdate, router, -1, -1});
+}
+
+void DistanceVectorSimulation::sendUpdates(int router)
+{
+    routers[router].updatePending = false;
+
+    const int32_t *rowDist = &dist[(size_t)router * n];
+    const int32_t *rowHop = &hop[(size_t)router * n];
+    double arrival = queue.now() + params.linkDelay;
+
+    for (int s = slotOffsets[router]; s < slotOffsets[router + 1]; ++s)
+    {
+        if (slotCost(s) < 0) continue;
+
+        int neighbor = slots[s].neighbor;
+
+        int payload;
+        if (!freePayloads.empty())
+        {
+            payload = freePayloads.back();
+            freePayloads.pop_back();
+        }
+        else
+        {
+            payload = (int)payloads.size();
+            payloads.emplace_back();
+        }
+
+        std::vector<int32_t>& vector = payloads[payload];
+        vector.assign(rowDist, rowDist + n);
+
+        int entries = 0;
+        for (int d = 0; d < n; ++d)
+        {
+            bool viaNeighbor = rowHop[d] == neighbor && d != router;
+            if (viaNeighbor && params.loopPrevention != NoLoopPrevention)
+            {
+                vector[d] = inf;
+                if (params.loopPrevention == PoisonReverse && rowDist[d] < inf) entries++;
+            }
+            else if (rowDist[d] < inf)
+            {
+                entries++;
+            }
+        }
+
+        int packets = std::max(1, (entries + entriesPerPacket - 1) / entriesPerPacket);
+        stats.messages += packets;
+        stats.bytes += (qint64)packets * packetHeaderBytes + (qint64)entries * entryBytes;
+        lastMessage = std::max(lastMessage, arrival);
+
+        queue.push(arrival, {UpdateArrival, neighbor, slots[s].reverse, payload});
+    }
+}
+
+void DistanceVectorSimulation::receive(const Event& event)
+{
+    std::vector<int32_t>& vector = payloads[event.payload];
+    int32_t *stored = &advertised[(size_t)event.slot * n];
+
+    // Оновлення, що було в дорозі, коли канал упав, губиться
+    bool accepted = slotCost(event.slot) >= 0;
+    bool same = accepted && std::equal(vector.begin(), vector.end(), stored);
+
+    if (accepted && !same) std::copy(vector.begin(), vector.end(), stored);
+    if (same) stats.duplicates++;
+
+    freePayloads.push_back(event.payload);
+
+    if (accepted && !same) recompute(event.router);
+}
+
+ConvergenceStats DistanceVectorSimulation::runPhase(const std::atomic<bool> *cancelled)
+{
+    uint64_t processed = 0;
+
+    while (!queue.empty())
+    {
+        if ((++processed & 4095) == 0 && cancelled && cancelled->load())
+        {
+            queue.clear();
+            stats.completed = false;
+            return stats;
+        }
+
+        EventQueue<Event>::Event event = queue.pop();
+        if (event.time > phaseStart + params.maxPhaseTime)
+        {
+            queue.clear();
+            stats.completed = false;
+            break;
+        }
+
+        if (event.payload.type == UpdateArrival)
+            receive(event.payload);
+        else
+            sendUpdates(event.payload.router);
+    }
+
+    for (Router& router : routers)
+        router.updatePending = false;
+
+    stats.convergenceTime = lastFibChange - phaseStart;
+    stats.quietTime = lastMessage - phaseStart;
+
+    for (const Router& router : routers)
+        stats.maxComputations = std::max(stats.maxComputations, router.recomputes);
+
+    // Еталон - Дейкстра по живих каналах; шляхи, не коротші за нескінченність, недосяжні і для протоколу
+    std::vector<int32_t> truth(n);
+    std::priority_queue<std::pair<int32_t, int>, std::vector<std::pair<int32_t, int>>, std::greater<>> heap;
+
+    for (int r = 0; r < n; ++r)
+    {
+        if (cancelled && cancelled->load())
+        {
+            stats.completed = false;
+            break;
+        }
+
+        std::fill(truth.begin(), truth.end(), inf);
+        truth[r] = 0;
+        heap.push({0, r});
+
+        while (!heap.empty())
+        {
+            auto [d, u] = heap.top();
+            heap.pop();
+            if (d > truth[u]) continue;
+
+            for (int s = slotOffsets[u]; s < slotOffsets[u + 1]; ++s)
+            {
+                int32_t cost = slotCost(s);
+                int v = slots[s].neighbor;
+                if (cost < 0 || d + cost >= truth[v]) continue;
+
+                truth[v] = d + cost;
+                heap.push({truth[v], v});
+            }
+        }
+
+        if (!std::equal(truth.begin(), truth.end(), dist.begin() + (size_t)r * n)) stats.inconsistentRouters++;
+    }
+
+    return stats;
+}
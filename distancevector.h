@@ -0,0 +1,118 @@
+#ifndef DISTANCEVECTOR_H
+#define DISTANCEVECTOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "convergence.h"
+#include "eventqueue.h"
+#include "topology.h"
+
+enum LoopPrevention
+{
+    NoLoopPrevention,
+    SplitHorizon,           // маршрути через сусіда йому не оголошуються
+    PoisonReverse           // оголошуються з нескінченною метрикою
+};
+
+struct DistanceVectorParams
+{
+    bool minHops = false;
+    LoopPrevention loopPrevention = PoisonReverse;
+
+    double linkDelay = 0.002;       // с на канал
+    double updateDelay = 0.05;      // с від зміни таблиці до тригерного оновлення; зміни за цей час об'єднуються
+
+    int infinity = 0;               // 0 - 16 кроків, як у RIP, або 16 * найбільша вага
+    double maxPhaseTime = 600;      // с; фаза, що не зійшлася за цей час, обривається
+};
+
+// Модель протоколу вектора відстаней: маршрутизатори обмінюються повними таблицями з сусідами
+// за симульованим часом. Кожне оновлення повністю замінює збережений вектор сусіда, тож пропущений
+// через розщеплення горизонту маршрут отримувач вважає недосяжним, як і отруєний
+class DistanceVectorSimulation
+{
+public:
+    // Пам'ять - вектор на кожен кінець кожного каналу: 2E * n метрик
+    static const int maxRouters = 3000;
+
+    DistanceVectorSimulation(const Topology& topology, const DistanceVectorParams& params = DistanceVectorParams());
+
+    int routerCount() const { return n; }
+    int infinity() const { return inf; }
+
+    ConvergenceStats coldStart(const std::atomic<bool> *cancelled = nullptr);
+    ConvergenceStats setLinkState(int edgeIndex, bool up, const std::atomic<bool> *cancelled = nullptr);
+
+    // dist[d] = min(dist[d], min(adv[d] + cost, inf)), hop[d] = neighbor там, де стало менше; SSE4.1, якщо процесор його має
+    static void relax(int32_t *dist, int32_t *hop, const int32_t *adv, int32_t cost, int32_t neighbor, int32_t inf, int count);
+
+private:
+    enum EventType
+    {
+        UpdateArrival,
+        SendUpdate
+    };
+
+    struct Event
+    {
+        EventType type;
+        int router;
+        int slot;
+        int payload;
+    };
+
+    // Суміжність без повторів: паралельні канали до одного сусіда об'єднані в один слот
+    struct Slot
+    {
+        int neighbor;
+        int reverse;                // слот зворотного напрямку у сусіда
+        std::vector<int> edges;
+    };
+
+    struct Router
+    {
+        bool updatePending = false;
+        int recomputes = 0;
+    };
+
+    DistanceVectorParams params;
+    int n;
+    int32_t inf;
+    std::vector<TopologyNode> nodes;
+    std::vector<TopologyEdge> edges;
+    std::vector<char> edgeUp;
+    std::vector<std::pair<int, int>> edgeSlots;
+
+    std::vector<int> slotOffsets;
+    std::vector<Slot> slots;
+
+    std::vector<int32_t> dist;              // n * n
+    std::vector<int32_t> hop;               // n * n, індекс сусіда-маршрутизатора або -1
+    std::vector<int32_t> advertised;        // slots.size() * n, останній вектор від сусіда слота
+
+    std::vector<std::vector<int32_t>> payloads;
+    std::vector<int> freePayloads;
+
+    std::vector<Router> routers;
+    EventQueue<Event> queue;
+
+    ConvergenceStats stats;
+    double phaseStart;
+    double lastFibChange;
+    double lastMessage;
+
+    std::vector<int32_t> scratchDist;
+    std::vector<int32_t> scratchHop;
+
+    int32_t slotCost(int slot) const;
+    void recompute(int router);
+    void triggerUpdate(int router);
+    void sendUpdates(int router);
+    void receive(const Event& event);
+
+    void beginPhase(const QString& phase, bool settle);
+    ConvergenceStats runPhase(const std::atomic<bool> *cancelled);
+};
+
+#endif // DISTANCEVECTOR_H
@@ -1,13 +1,70 @@
 #include "edge.h"
 #include "node.h"
+#include "networkscene.h"
 #include <QPen>
 #include <QPainterPath>
 #include <QPainterPathStroker>
 #include <QInputDialog>
+#include <QMenu>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QGraphicsSceneContextMenuEvent>
 #include <QVector>
+#include <QStyleOptionGraphicsItem>
+
+namespace
+{
+
+QPen makeEdgePen(bool selected, EdgeType type)
+{
+    QPen pen(selected ? Qt::red : Qt::black, selected ? 4 : 2);
+
+    if (type == HalfDuplex)
+    {
+        QVector<qreal> dashes;
+        dashes << 8 << 7;
+        pen.setDashPattern(dashes);
+    }
+    else
+    {
+        pen.setStyle(Qt::SolidLine);
+    }
+
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+    return pen;
+}
+
+const QPen& edgePen(bool selected, EdgeType type)
+{
+    static const QPen pens[2][2] = {
+        {makeEdgePen(false, Duplex), makeEdgePen(false, HalfDuplex)},
+        {makeEdgePen(true, Duplex), makeEdgePen(true, HalfDuplex)}
+    };
+    return pens[selected ? 1 : 0][type == HalfDuplex ? 1 : 0];
+}
+
+const QPen& downPen()
+{
+    static const QPen pen(Qt::gray, 2, Qt::DotLine, Qt::RoundCap, Qt::RoundJoin);
+    return pen;
+}
+
+const QFont& labelFont()
+{
+    static const QFont font("Arial", 10, QFont::Bold);
+    return font;
+}
+
+}
 
 Edge::Edge(Node *sourceNode, Node *destNode, int weight, EdgeType type)
-    : source(sourceNode), dest(destNode), weight(weight), type(type)
+    : source(sourceNode), dest(destNode), weight(weight), type(type),
+      loss(1, sourceNode ? sourceNode->getId() : 0, destNode ? destNode->getId() : 0),
+      capacity(defaultLinkCapacity), reserved(0), mtu(0), up(true)
 {
     setZValue(-1);
     setFlag(ItemIsSelectable);
@@ -16,6 +73,7 @@ Edge::Edge(Node *sourceNode, Node *destNode, int weight, EdgeType type)
 
 Edge::~Edge()
 {
+    markSceneDirty(scene(), true);
     if (source) source->removeEdge(this);
     if (dest) dest->removeEdge(this);
 }
@@ -40,6 +98,33 @@ EdgeType Edge::getType() const
     return type;
 }
 
+void Edge::setUp(bool isUp)
+{
+    if (up == isUp) return;
+
+    up = isUp;
+    markSceneDirty(scene(), true);
+    update();
+}
+
+void Edge::setCapacity(double value)
+{
+    capacity = value;
+    update();
+}
+
+void Edge::reserve(double bandwidth)
+{
+    reserved += bandwidth;
+    update();
+}
+
+void Edge::release(double bandwidth)
+{
+    reserved = qMax(0.0, reserved - bandwidth);
+    update();
+}
+
 void Edge::adjust()
 {
     if (!source || !dest) return;
@@ -47,54 +132,72 @@ void Edge::adjust()
     QLineF line(source->mapToScene(0, 0), dest->mapToScene(0, 0));
 
     setLine(line);
+
+    QPointF center = (line.p1() + line.p2()) / 2;
+    QRectF textRect(center.x() - 10, center.y() - 10, 20, 20);
+    cachedBounds = QRectF(line.p1(), line.p2()).normalized().adjusted(-3, -3, 3, 3).united(textRect);
+
+    QPainterPath path;
+    path.moveTo(line.p1());
+    path.lineTo(line.p2());
+    QPainterPathStroker stroker;
+    stroker.setWidth(10);
+    cachedShape = stroker.createStroke(path);
+
+    markSceneDirty(scene());
+}
+
+void Edge::markSceneDirty(QGraphicsScene *scene, bool topologyChanged)
+{
+    if (NetworkScene *networkScene = dynamic_cast<NetworkScene*>(scene))
+    {
+        networkScene->markEdgesDirty();
+        if (topologyChanged) networkScene->touchTopology();
+    }
+}
+
+QVariant Edge::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    if (change == ItemSceneChange)
+    {
+        markSceneDirty(scene(), true);
+        markSceneDirty(value.value<QGraphicsScene*>(), true);
+    }
+    return QGraphicsLineItem::itemChange(change, value);
 }
 
 QRectF Edge::boundingRect() const
 {
-    QRectF rect = QGraphicsLineItem::boundingRect();
-    QPointF center = (line().p1() + line().p2()) / 2;
-    QRectF textRect(center.x() - 10, center.y() - 10, 20, 20);
-    return rect.united(textRect);
+    return cachedBounds;
 }
 
 QPainterPath Edge::shape() const
 {
-    QPainterPath path;
-    path.moveTo(line().p1());
-    path.lineTo(line().p2());
-    QPainterPathStroker stroker;
-    stroker.setWidth(10);
-    return stroker.createStroke(path);
+    return cachedShape;
 }
 
 void Edge::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-    Q_UNUSED(option);
     Q_UNUSED(widget);
 
     if (!source || !dest) return;
 
-    QColor lineColor = isSelected() ? Qt::red : Qt::black;
-    int lineThickness = isSelected() ? 4 : 2;
+    qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+    if (lod < NetworkScene::edgeBatchLod && !isSelected()) return;
 
-    QPen pen(lineColor, lineThickness);
+    bool active = up && source->isUp() && dest->isUp();
+    painter->setPen(active || isSelected() ? edgePen(isSelected(), type) : downPen());
+    painter->drawLine(line());
 
-    if (type == HalfDuplex)
+    // Зарезервована частка смуги - синя смуга від початку каналу
+    if (reserved > 0 && active)
     {
-        QVector<qreal> dashes;
-        dashes << 8 << 7;
-        pen.setDashPattern(dashes);
+        static const QPen reservedPen(QColor(0, 100, 255), 4, Qt::SolidLine, Qt::FlatCap);
+        painter->setPen(reservedPen);
+        painter->drawLine(line().p1(), line().pointAt(qMin(1.0, reserved / capacity)));
     }
-    else
-    {
-        pen.setStyle(Qt::SolidLine);
-    }
-
-    pen.setCapStyle(Qt::RoundCap);
-    pen.setJoinStyle(Qt::RoundJoin);
 
-    painter->setPen(pen);
-    painter->drawLine(line());
+    if (lod < NetworkScene::labelLod) return;
 
     QPointF center = (line().p1() + line().p2()) / 2;
     QRectF textRect(center.x() - 10, center.y() - 10, 20, 20);
@@ -103,9 +206,10 @@ void Edge::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWid
     painter->setPen(Qt::NoPen);
     painter->drawRect(textRect);
 
-    painter->setPen(Qt::black);
-    painter->setFont(QFont("Arial", 10, QFont::Bold));
-    painter->drawText(textRect, Qt::AlignCenter, QString::number(weight));
+    // Адаптивна вартість, що відрізняється від ваги, показується червоним
+    painter->setPen(getCost() != weight ? Qt::red : Qt::black);
+    painter->setFont(labelFont());
+    painter->drawText(textRect, Qt::AlignCenter, QString::number(getCost()));
 }
 
 void Edge::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
@@ -118,8 +222,108 @@ void Edge::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
     if (ok)
     {
         weight = newWeight;
+        markSceneDirty(scene(), true);
         update();
     }
 
     QGraphicsLineItem::mouseDoubleClickEvent(event);
 }
+
+void Edge::contextMenuEvent(QGraphicsSceneContextMenuEvent *event)
+{
+    QMenu menu;
+    QAction *lossAction = menu.addAction("Модель втрат...");
+    QAction *capacityAction = menu.addAction("Пропускна здатність...");
+    QAction *mtuAction = menu.addAction("MTU каналу...");
+    QAction *stateAction = menu.addAction(up ? "Вимкнути канал" : "Увімкнути канал");
+
+    QAction *chosen = menu.exec(event->screenPos());
+    if (chosen == lossAction)
+        editLossModel();
+    else if (chosen == capacityAction)
+        editCapacity();
+    else if (chosen == mtuAction)
+        editMtu();
+    else if (chosen == stateAction)
+        setUp(!up);
+}
+
+void Edge::editCapacity()
+{
+    bool ok;
+    double value = QInputDialog::getDouble(nullptr, "Пропускна здатність",
+                                           "Смуга каналу, Мбіт/с (зарезервовано " + QString::number(reserved) + "):",
+                                           capacity, qMax(reserved, 0.1), 1000000.0, 1, &ok);
+    if (ok) setCapacity(value);
+}
+
+void Edge::editMtu()
+{
+    bool ok;
+    int value = QInputDialog::getInt(nullptr, "MTU каналу", "Найбільший пакет із заголовком, байт (0 - без обмеження):",
+                                     mtu, 0, 65535, 1, &ok);
+    if (ok) setMtu(value);
+}
+
+void Edge::editLossModel()
+{
+    LossParams params = loss.params();
+
+    QDialog dialog;
+    dialog.setWindowTitle("Модель втрат каналу");
+
+    QComboBox *comboType = new QComboBox();
+    comboType->addItem("Загальна ймовірність симуляції", DefaultLoss);
+    comboType->addItem("Bernoulli", BernoulliLoss);
+    comboType->addItem("Gilbert–Elliott", GilbertElliottLoss);
+    comboType->addItem("BER × розмір пакета", BitErrorLoss);
+    comboType->setCurrentIndex(comboType->findData(params.type));
+
+    auto probabilitySpin = [](double value) {
+        QDoubleSpinBox *spin = new QDoubleSpinBox();
+        spin->setDecimals(6);
+        spin->setRange(0.0, 1.0);
+        spin->setSingleStep(0.001);
+        spin->setValue(value);
+        return spin;
+    };
+
+    QDoubleSpinBox *spinProbability = probabilitySpin(params.probability);
+    QDoubleSpinBox *spinGoodToBad = probabilitySpin(params.goodToBad);
+    QDoubleSpinBox *spinBadToGood = probabilitySpin(params.badToGood);
+    QDoubleSpinBox *spinLossGood = probabilitySpin(params.lossGood);
+    QDoubleSpinBox *spinLossBad = probabilitySpin(params.lossBad);
+
+    QDoubleSpinBox *spinBer = new QDoubleSpinBox();
+    spinBer->setDecimals(12);
+    spinBer->setRange(0.0, 1e-2);
+    spinBer->setSingleStep(1e-7);
+    spinBer->setValue(params.bitErrorRate);
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Модель:", comboType);
+    form->addRow("Ймовірність втрати:", spinProbability);
+    form->addRow("Добрий → поганий:", spinGoodToBad);
+    form->addRow("Поганий → добрий:", spinBadToGood);
+    form->addRow("Втрати в доброму стані:", spinLossGood);
+    form->addRow("Втрати в поганому стані:", spinLossBad);
+    form->addRow("BER:", spinBer);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    QObject::connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    QObject::connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    params.type = (LossModelType)comboType->currentData().toInt();
+    params.probability = spinProbability->value();
+    params.goodToBad = spinGoodToBad->value();
+    params.badToGood = spinBadToGood->value();
+    params.lossGood = spinLossGood->value();
+    params.lossBad = spinLossBad->value();
+    params.bitErrorRate = spinBer->value();
+
+    loss.setParams(params);
+}
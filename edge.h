@@ -3,13 +3,19 @@
 
 #include <QGraphicsLineItem>
 #include <QPainter>
+#include <QPainterPath>
+#include "topology.h"
+#include "lossmodel.h"
 
 class Node;
 
-enum EdgeType
+// Виміряне навантаження каналу для адаптивної маршрутизації
+struct LinkLoad
 {
-    Duplex,
-    HalfDuplex
+    qint64 carriedBytes = 0;    // з останнього вимірювання
+    double smoothed = 0;        // згладжена утилізація
+    int cost = 0;               // ефективна вартість; 0 - дорівнює вазі
+    qint64 lastChange = 0;      // мс, коли вартість змінювалась востаннє
 };
 
 class Edge : public QGraphicsLineItem
@@ -25,17 +31,56 @@ public:
     int getWeight() const;
     EdgeType getType() const;
 
+    LossModel& lossModel() { return loss; }
+
+    // Вартість для маршрутизації: налаштована вага або адаптивна, виміряна з навантаження
+    int getCost() const { return linkLoad.cost > 0 ? linkLoad.cost : weight; }
+    LinkLoad& load() { return linkLoad; }
+
+    // Смуга для віртуальних каналів, Мбіт/с; резерв знімається разом із записом каналу на вузлі
+    double getCapacity() const { return capacity; }
+    void setCapacity(double value);
+    double getReserved() const { return reserved; }
+    void reserve(double bandwidth);
+    void release(double bandwidth);
+
+    // Найбільший пакет разом із заголовком, байт; 0 - без обмеження
+    int getMtu() const { return mtu; }
+    void setMtu(int value) { mtu = value; }
+
+    // Вимкнений канал лишається на сцені, але зникає з топології маршрутизації й губить усі пакети
+    bool isUp() const { return up; }
+    void setUp(bool isUp);
+
     QRectF boundingRect() const override;
     QPainterPath shape() const override;
 
 protected:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
     void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event) override;
+    void contextMenuEvent(QGraphicsSceneContextMenuEvent *event) override;
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
 
 public:
     Node *source, *dest;
     int weight;
     EdgeType type;
+
+private:
+    LossModel loss;
+    LinkLoad linkLoad;
+    double capacity;
+    double reserved;
+    int mtu;
+    bool up;
+
+    QRectF cachedBounds;
+    QPainterPath cachedShape;
+
+    void markSceneDirty(QGraphicsScene *scene, bool topologyChanged = false);
+    void editLossModel();
+    void editCapacity();
+    void editMtu();
 };
 
 #endif // EDGE_H
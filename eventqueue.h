@@ -0,0 +1,56 @@
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+// Черга подій дискретної симуляції. Події з однаковим часом виходять у порядку додавання,
+// тож прогін детермінований
+template <typename Payload>
+class EventQueue
+{
+public:
+    struct Event
+    {
+        double time;
+        uint64_t order;
+        Payload payload;
+    };
+
+    EventQueue() : nextOrder(0), clock(0) {}
+
+    void push(double time, const Payload& payload) { events.push({time, nextOrder++, payload}); }
+
+    bool empty() const { return events.empty(); }
+    size_t size() const { return events.size(); }
+
+    Event pop()
+    {
+        Event event = events.top();
+        events.pop();
+        clock = event.time;
+        return event;
+    }
+
+    double now() const { return clock; }
+    void advanceTo(double time) { if (time > clock) clock = time; }
+
+    void clear() { events = decltype(events)(); }
+
+private:
+    struct Later
+    {
+        bool operator()(const Event& x, const Event& y) const
+        {
+            return x.time != y.time ? x.time > y.time : x.order > y.order;
+        }
+    };
+
+    std::priority_queue<Event, std::vector<Event>, Later> events;
+    uint64_t nextOrder;
+    double clock;
+};
+
+#endif // EVENTQUEUE_H
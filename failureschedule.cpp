@@ -0,0 +1,51 @@
+#include "failureschedule.h"
+
+#include <QStringList>
+#include <algorithm>
+
+bool FailureSchedule::parse(const QString& text, std::vector<FailureEvent>& events, QString *error)
+{
+    events.clear();
+
+    const QStringList lines = text.split('\n');
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        QString line = lines[i].section('#', 0, 0).trimmed();
+        if (line.isEmpty()) continue;
+
+        QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+        QString kind = parts.value(1).toLower();
+        QString state = parts.last().toLower();
+
+        FailureEvent event;
+        bool okTime = false, okA = false, okB = true;
+        event.time = parts.value(0).toDouble(&okTime);
+        event.nodeEvent = kind == "node";
+        event.a = parts.value(2).toInt(&okA);
+        event.b = event.nodeEvent ? -1 : parts.value(3).toInt(&okB);
+        event.up = state == "up";
+
+        int expected = event.nodeEvent ? 4 : 5;
+        bool valid = okTime && okA && okB && event.time >= 0 && parts.size() == expected &&
+                     (kind == "node" || kind == "link") && (state == "up" || state == "down");
+
+        if (!valid)
+        {
+            if (error) *error = "Рядок " + QString::number(i + 1) + ": не вдалося розібрати \"" + lines[i].trimmed() + "\"";
+            events.clear();
+            return false;
+        }
+
+        events.push_back(event);
+    }
+
+    std::stable_sort(events.begin(), events.end(), [](const FailureEvent& x, const FailureEvent& y) { return x.time < y.time; });
+    return true;
+}
+
+QString FailureSchedule::describe(const FailureEvent& event)
+{
+    QString what = event.nodeEvent ? "вузол " + QString::number(event.a)
+                                   : "канал " + QString::number(event.a) + "-" + QString::number(event.b);
+    return what + (event.up ? " увімкнено" : " вимкнено");
+}
@@ -0,0 +1,31 @@
+#ifndef FAILURESCHEDULE_H
+#define FAILURESCHEDULE_H
+
+#include <QString>
+#include <vector>
+
+enum RecoveryMode
+{
+    ReconvergenceRecovery,      // пакети йдуть старими маршрутами, доки не мине затримка SPF і не з'явиться нове покоління
+    FastRerouteRecovery         // вузол одразу перемикається на заздалегідь обчислений LFA
+};
+
+struct FailureEvent
+{
+    double time;                // с від початку розкладу
+    bool nodeEvent;
+    int a;                      // вузол або перший кінець каналу
+    int b;                      // другий кінець каналу
+    bool up;
+};
+
+class FailureSchedule
+{
+public:
+    // Рядок: "<с> link <id> <id> down|up" або "<с> node <id> down|up"; порожні рядки й # ігноруються
+    static bool parse(const QString& text, std::vector<FailureEvent>& events, QString *error = nullptr);
+
+    static QString describe(const FailureEvent& event);
+};
+
+#endif // FAILURESCHEDULE_H
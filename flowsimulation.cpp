@@ -0,0 +1,388 @@
+#include "flowsimulation.h"
+#include "counterrng.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <queue>
+
+namespace
+{
+
+// Пакет вважається втраченим, коли підтверджено передачу, зроблену на три пізніше (як три дублікати ACK)
+const int reorderThreshold = 3;
+const double minRto = 0.2;
+const double maxRto = 60;
+
+}
+
+FlowSimulation::FlowSimulation(const Topology& topology, const FlowSimulationParams& params)
+    : params(params), nodes(topology.nodes), edges(topology.edges)
+{
+    int n = (int)nodes.size();
+    arcOffsets.assign(n + 1, 0);
+    for (const TopologyEdge& e : edges)
+    {
+        if (e.source == e.dest) continue;
+        arcOffsets[e.source + 1]++;
+        arcOffsets[e.dest + 1]++;
+    }
+    for (int i = 0; i < n; ++i)
+        arcOffsets[i + 1] += arcOffsets[i];
+
+    arcs.resize(arcOffsets[n]);
+    std::vector<int> fill(arcOffsets.begin(), arcOffsets.end() - 1);
+    for (int i = 0; i < (int)edges.size(); ++i)
+    {
+        const TopologyEdge& e = edges[i];
+        if (e.source == e.dest) continue;
+        arcs[fill[e.source]++] = {e.dest, i};
+        arcs[fill[e.dest]++] = {e.source, i};
+    }
+
+    // Одна черга на клас трафіку, тож строгий пріоритет тут - звичайна FIFO на queueLimit пакетів
+    SchedulerParams scheduler;
+    scheduler.discipline = StrictPriorityScheduling;
+    scheduler.queueLimit = params.queueLimit;
+
+    links.resize(edges.size() * 2);
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+        scheduler.rate = std::max(1.0, edges[i / 2].capacity) * 125000;
+        links[i].scheduler = LinkScheduler<DataPacket>(scheduler);
+    }
+
+    setupFlows();
+}
+
+std::vector<int> FlowSimulation::pathQueues(int source, int dest) const
+{
+    int n = (int)nodes.size();
+    std::vector<long long> dist(n, LLONG_MAX);
+    std::vector<int> parentEdge(n, -1);
+    std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> heap;
+
+    dist[source] = 0;
+    heap.push({0, source});
+
+    while (!heap.empty())
+    {
+        auto [d, u] = heap.top();
+        heap.pop();
+        if (d > dist[u]) continue;
+        if (u == dest) break;
+
+        for (int a = arcOffsets[u]; a < arcOffsets[u + 1]; ++a)
+        {
+            auto [v, e] = arcs[a];
+            long long candidate = d + (params.minHops ? 1 : edges[e].weight);
+            if (candidate >= dist[v]) continue;
+
+            dist[v] = candidate;
+            parentEdge[v] = e;
+            heap.push({candidate, v});
+        }
+    }
+
+    std::vector<int> path;
+    if (dist[dest] == LLONG_MAX) return path;
+
+    for (int v = dest; v != source;)
+    {
+        int e = parentEdge[v];
+        int from = edges[e].source == v ? edges[e].dest : edges[e].source;
+        path.push_back(2 * e + (edges[e].source == from ? 0 : 1));
+        v = from;
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+void FlowSimulation::setupFlows()
+{
+    int n = (int)nodes.size();
+    int count = std::clamp(params.flows, 0, maxFlows);
+    if (n < 2) count = 0;
+
+    CounterRng rng(params.seed, 0x4343);
+
+    for (int f = 0; f < count; ++f)
+    {
+        FlowState flow(params.congestion);
+        flow.source = rng.below(n);
+
+        // Шукаємо призначення в іншому регіоні; в однорегіонній мережі підходить будь-який інший вузол
+        for (int attempt = 0; attempt < 64; ++attempt)
+        {
+            int dest = rng.below(n - 1);
+            if (dest >= flow.source) dest++;
+            flow.dest = dest;
+            if (!params.crossRegion || nodes[dest].region != nodes[flow.source].region) break;
+        }
+
+        flow.queues = pathQueues(flow.source, flow.dest);
+        flow.start = rng.uniform() * params.startSpread;
+        flowStates.push_back(std::move(flow));
+
+        if (!flowStates.back().queues.empty())
+            queue.push(flowStates.back().start, {FlowStart, -1, 0, {f, 0, 0, 0, false}});
+    }
+}
+
+void FlowSimulation::trySend(int f)
+{
+    FlowState& flow = flowStates[f];
+    if (queue.now() >= params.duration) return;
+
+    bool armed = !flow.outstanding.empty();
+
+    while ((double)flow.outstanding.size() < std::floor(flow.window.window()))
+    {
+        bool retransmission = !flow.lost.empty();
+        int64_t seq = retransmission ? flow.lost.front() : flow.nextSeq++;
+        if (retransmission) flow.lost.pop_front();
+
+        int64_t order = flow.nextOrder++;
+        flow.outstanding[seq] = {order, queue.now(), retransmission};
+        flow.sent++;
+
+        forward({f, seq, order, 0, false});
+    }
+
+    if (!armed && !flow.outstanding.empty()) armTimer(f);
+}
+
+void FlowSimulation::forward(DataPacket packet)
+{
+    FlowState& flow = flowStates[packet.flow];
+
+    if (packet.hop == (int)flow.queues.size())
+    {
+        if ((int64_t)flow.received.size() <= packet.seq) flow.received.resize(packet.seq + 1, 0);
+        if (!flow.received[packet.seq])
+        {
+            flow.received[packet.seq] = 1;
+            flow.delivered++;
+        }
+
+        // ACK іде назад тим самим шляхом без черг
+        queue.push(queue.now() + flow.queues.size() * params.linkDelay, {AckArrival, -1, 0, packet});
+        return;
+    }
+
+    int link = flow.queues[packet.hop];
+    LinkQueue& out = links[link];
+
+    if (params.ecnThreshold > 0 && out.scheduler.size() >= params.ecnThreshold && !packet.marked)
+    {
+        packet.marked = true;
+        report.marks++;
+    }
+
+    if (!out.scheduler.enqueue(packet, BulkClass, params.packetBytes, queue.now()))
+    {
+        report.drops++;
+        return;
+    }
+
+    if (!out.busy) startService(link);
+}
+
+void FlowSimulation::startService(int link)
+{
+    LinkQueue& out = links[link];
+    out.busy = !out.scheduler.empty();
+    if (!out.busy) return;
+
+    out.inService = out.scheduler.dequeue(queue.now()).payload;
+
+    double transmission = out.scheduler.transmissionTime(params.packetBytes);
+    out.busyTime += transmission;
+    queue.push(queue.now() + transmission, {TransmitDone, link, 0, out.inService});
+}
+
+void FlowSimulation::receiveAck(const DataPacket& packet)
+{
+    FlowState& flow = flowStates[packet.flow];
+    double now = queue.now();
+
+    // ACK для передачі, яку вже оголошено втраченою, нічого не підтверджує
+    auto it = flow.outstanding.find(packet.seq);
+    if (it == flow.outstanding.end() || it->second.order != packet.order) return;
+
+    double rtt = it->second.retransmitted ? 0 : now - it->second.sentAt;
+    flow.outstanding.erase(it);
+
+    if (rtt > 0)
+    {
+        flow.rttvar = flow.srtt > 0 ? 0.75 * flow.rttvar + 0.25 * std::abs(flow.srtt - rtt) : rtt / 2;
+        flow.srtt = flow.srtt > 0 ? 0.875 * flow.srtt + 0.125 * rtt : rtt;
+        flow.rto = std::clamp(flow.srtt + 4 * flow.rttvar, minRto, maxRto);
+    }
+
+    if (packet.marked) flow.marks++;
+    int reductions = flow.window.reductions();
+    flow.window.onAck(now, rtt, packet.marked);
+
+    size_t lostBefore = flow.lost.size();
+    for (auto o = flow.outstanding.begin(); o != flow.outstanding.end();)
+    {
+        if (o->second.order + reorderThreshold > packet.order)
+        {
+            ++o;
+            continue;
+        }
+
+        flow.lost.push_back(o->first);
+        flow.losses++;
+        flow.window.onLoss(now);
+        o = flow.outstanding.erase(o);
+    }
+
+    // Повторно передаємо з найменшого номера, як і за SACK
+    if (flow.lost.size() != lostBefore) std::sort(flow.lost.begin(), flow.lost.end());
+
+    trace(packet.flow, flow.window.reductions() != reductions);
+
+    flow.timerEpoch++;
+    if (!flow.outstanding.empty()) armTimer(packet.flow);
+
+    trySend(packet.flow);
+}
+
+void FlowSimulation::armTimer(int f)
+{
+    const FlowState& flow = flowStates[f];
+    queue.push(queue.now() + flow.rto, {RetransmitTimeout, -1, flow.timerEpoch, {f, 0, 0, 0, false}});
+}
+
+// Жодного ACK за RTO: усе, що в дорозі, вважається втраченим, а таймер подвоюється
+void FlowSimulation::timeout(int f, int64_t epoch)
+{
+    FlowState& flow = flowStates[f];
+    if (epoch != flow.timerEpoch || flow.outstanding.empty()) return;
+
+    for (const auto& entry : flow.outstanding)
+        flow.lost.push_back(entry.first);
+    flow.losses += flow.outstanding.size();
+    flow.outstanding.clear();
+    std::sort(flow.lost.begin(), flow.lost.end());
+
+    flow.window.onTimeout(queue.now());
+    flow.rto = std::min(flow.rto * 2, maxRto);
+    flow.timerEpoch++;
+
+    trace(f, true);
+    trySend(f);
+}
+
+void FlowSimulation::trace(int f, bool force)
+{
+    FlowState& flow = flowStates[f];
+    double now = queue.now();
+    if ((int)report.trace.size() >= maxTraceSamples) return;
+    if (!force && now - flow.lastTrace < params.traceInterval) return;
+
+    flow.lastTrace = now;
+    report.trace.push_back({now, f, flow.window.window(), flow.window.threshold(), flow.srtt});
+}
+
+FlowSimulationReport FlowSimulation::run(const std::atomic<bool> *cancelled)
+{
+    uint64_t processed = 0;
+
+    while (!queue.empty())
+    {
+        if ((++processed & 4095) == 0 && cancelled && cancelled->load())
+        {
+            report.completed = false;
+            break;
+        }
+
+        EventQueue<Event>::Event event = queue.pop();
+        if (event.time > params.duration) break;
+
+        const Event& e = event.payload;
+        switch (e.type)
+        {
+        case FlowStart:
+            trace(e.packet.flow, true);
+            trySend(e.packet.flow);
+            break;
+        case TransmitDone:
+        {
+            DataPacket packet = e.packet;
+            packet.hop++;
+            queue.push(queue.now() + params.linkDelay, {PacketArrival, -1, 0, packet});
+            startService(e.queue);
+            break;
+        }
+        case PacketArrival:
+            forward(e.packet);
+            break;
+        case AckArrival:
+            receiveAck(e.packet);
+            break;
+        case RetransmitTimeout:
+            timeout(e.packet.flow, e.epoch);
+            break;
+        }
+    }
+
+    queue.clear();
+
+    double sum = 0;
+    double squares = 0;
+    int active = 0;
+    int64_t sent = 0;
+    int64_t delivered = 0;
+
+    for (const FlowState& flow : flowStates)
+    {
+        FlowResult result;
+        result.sourceId = nodes[flow.source].id;
+        result.destId = nodes[flow.dest].id;
+        result.hops = (int)flow.queues.size();
+        result.goodput = result.hops && params.duration > flow.start
+                             ? flow.delivered * params.packetBytes / (params.duration - flow.start) : 0;
+        result.sent = flow.sent;
+        result.delivered = flow.delivered;
+        result.losses = flow.losses;
+        result.marks = flow.marks;
+        result.reductions = flow.window.reductions();
+        result.timeouts = flow.window.timeouts();
+        result.rtt = flow.srtt;
+        report.flows.push_back(result);
+
+        if (!result.hops) continue;
+        active++;
+        sum += result.goodput;
+        squares += result.goodput * result.goodput;
+        sent += flow.sent;
+        delivered += flow.delivered;
+    }
+
+    report.aggregateGoodput = sum;
+    report.fairness = squares > 0 ? sum * sum / (active * squares) : 0;
+    report.efficiency = sent ? (double)delivered / sent : 0;
+
+    double delaySum = 0;
+    int64_t dequeued = 0;
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+        const ClassStats& stats = links[i].scheduler.stats(BulkClass);
+        delaySum += stats.delaySum;
+        dequeued += stats.sent;
+
+        double utilization = std::min(1.0, links[i].busyTime / params.duration);
+        if (utilization > report.busiestUtilization)
+        {
+            report.busiestUtilization = utilization;
+            report.busiestLink = (int)(i / 2);
+        }
+    }
+    report.meanQueueDelay = dequeued ? delaySum / dequeued : 0;
+
+    return report;
+}
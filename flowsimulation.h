@@ -0,0 +1,165 @@
+#ifndef FLOWSIMULATION_H
+#define FLOWSIMULATION_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+#include "congestioncontrol.h"
+#include "eventqueue.h"
+#include "linkscheduler.h"
+#include "topology.h"
+
+struct FlowSimulationParams
+{
+    CongestionParams congestion;
+    bool minHops = false;
+    int flows = 20;
+    bool crossRegion = true;        // джерело й призначення з різних регіонів: потоки ділять шлюзові канали
+    int packetBytes = 1500;
+    double linkDelay = 0.002;       // розповсюдження одним каналом, с
+    int queueLimit = 100;           // пакетів на напрямок каналу
+    int ecnThreshold = 30;          // з такої довжини черги пакети позначаються ECN; 0 - без позначок
+    double duration = 10;           // с
+    double startSpread = 1;         // потоки стартують рівномірно в [0, startSpread)
+    double traceInterval = 0.01;    // найменший крок трасування вікна одного потоку
+    uint64_t seed = 1;
+};
+
+struct FlowResult
+{
+    int sourceId;
+    int destId;
+    int hops;                       // 0 - призначення недосяжне, потік не стартував
+    double goodput;                 // байт/с унікальних доставлених даних
+    int64_t sent;                   // усі передачі, включно з повторними
+    int64_t delivered;
+    int64_t losses;
+    int64_t marks;
+    int reductions;
+    int timeouts;
+    double rtt;                     // згладжений RTT наприкінці, с
+};
+
+struct FlowSimulationReport
+{
+    std::vector<FlowResult> flows;
+    std::vector<CwndSample> trace;
+
+    double aggregateGoodput = 0;
+    double fairness = 0;            // індекс Джейна за goodput
+    double efficiency = 0;          // частка передач, що доставили нові дані
+    int64_t drops = 0;
+    int64_t marks = 0;
+    double meanQueueDelay = 0;      // с
+    int busiestLink = -1;           // індекс у Topology::edges
+    double busiestUtilization = 0;
+    bool completed = true;
+};
+
+// Потоки з нескінченним запасом даних поверх закріплених шляхів віртуальних каналів. Канали мають
+// FIFO-черги зі скиданням хвоста й швидкість за своєю пропускною здатністю; ACK повертаються без черг
+class FlowSimulation
+{
+public:
+    static const int maxFlows = 10000;
+    static const int maxTraceSamples = 500000;
+
+    FlowSimulation(const Topology& topology, const FlowSimulationParams& params);
+
+    FlowSimulationReport run(const std::atomic<bool> *cancelled = nullptr);
+
+private:
+    enum EventType
+    {
+        FlowStart,
+        TransmitDone,
+        PacketArrival,
+        AckArrival,
+        RetransmitTimeout
+    };
+
+    struct DataPacket
+    {
+        int flow;
+        int64_t seq;
+        int64_t order;              // номер передачі в потоці; за ним ACK виявляє втрати
+        int hop;
+        bool marked;
+    };
+
+    struct Event
+    {
+        EventType type;
+        int queue;
+        int64_t epoch;
+        DataPacket packet;
+    };
+
+    struct Outstanding
+    {
+        int64_t order;
+        double sentAt;
+        bool retransmitted;
+    };
+
+    struct FlowState
+    {
+        int source;
+        int dest;
+        std::vector<int> queues;    // вихідні черги вздовж шляху: 2 * канал + напрямок
+        CongestionWindow window;
+        double start = 0;
+        int64_t nextSeq = 0;
+        int64_t nextOrder = 0;
+        std::map<int64_t, Outstanding> outstanding;
+        std::deque<int64_t> lost;   // чекають повторної передачі
+        std::vector<char> received;
+
+        double srtt = 0;
+        double rttvar = 0;
+        double rto = 1;
+        int64_t timerEpoch = 0;
+        double lastTrace = -1;
+
+        int64_t sent = 0;
+        int64_t delivered = 0;
+        int64_t losses = 0;
+        int64_t marks = 0;
+
+        explicit FlowState(const CongestionParams& params) : source(-1), dest(-1), window(params) {}
+    };
+
+    struct LinkQueue
+    {
+        LinkScheduler<DataPacket> scheduler;
+        bool busy = false;
+        DataPacket inService;
+        double busyTime = 0;
+    };
+
+    FlowSimulationParams params;
+    std::vector<TopologyNode> nodes;
+    std::vector<TopologyEdge> edges;
+    std::vector<int> arcOffsets;
+    std::vector<std::pair<int, int>> arcs;  // (сусід, канал)
+
+    std::vector<FlowState> flowStates;
+    std::vector<LinkQueue> links;
+    EventQueue<Event> queue;
+    FlowSimulationReport report;
+
+    void setupFlows();
+    std::vector<int> pathQueues(int source, int dest) const;
+
+    void trySend(int flow);
+    void forward(DataPacket packet);
+    void startService(int link);
+    void receiveAck(const DataPacket& packet);
+    void timeout(int flow, int64_t epoch);
+    void armTimer(int flow);
+    void trace(int flow, bool force);
+};
+
+#endif // FLOWSIMULATION_H
@@ -0,0 +1,227 @@
+#include "forcelayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+ForceLayout::ForceLayout(std::vector<double> xsIn, std::vector<double> ysIn,
+                         const std::vector<std::pair<int, int>>& edges, const ForceLayoutParams& params)
+    : params(params), xs(std::move(xsIn)), ys(std::move(ysIn)), iterations(0)
+{
+    int n = (int)xs.size();
+    dx.assign(n, 0.0);
+    dy.assign(n, 0.0);
+
+    adjOffsets.assign(n + 1, 0);
+    for (const auto& e : edges)
+    {
+        if (e.first < 0 || e.second < 0 || e.first >= n || e.second >= n || e.first == e.second) continue;
+        adjOffsets[e.first + 1]++;
+        adjOffsets[e.second + 1]++;
+    }
+    for (int i = 0; i < n; ++i)
+        adjOffsets[i + 1] += adjOffsets[i];
+
+    adj.resize(adjOffsets[n]);
+    std::vector<int> fill(adjOffsets.begin(), adjOffsets.end() - 1);
+    for (const auto& e : edges)
+    {
+        if (e.first < 0 || e.second < 0 || e.first >= n || e.second >= n || e.first == e.second) continue;
+        adj[fill[e.first]++] = e.second;
+        adj[fill[e.second]++] = e.first;
+    }
+
+    // Збіжні точки розводяться детермінованим зсувом, інакше сила між ними невизначена
+    for (int i = 0; i < n; ++i)
+    {
+        xs[i] += std::cos(i * 2.399963) * 1e-3 * (i % 97);
+        ys[i] += std::sin(i * 2.399963) * 1e-3 * (i % 97);
+    }
+
+    temperature = params.idealLength * std::sqrt((double)std::max(n, 1)) * 0.1;
+    minTemperature = params.idealLength * 0.01;
+}
+
+bool ForceLayout::converged() const
+{
+    return temperature < minTemperature || iterations >= params.maxIterations;
+}
+
+void ForceLayout::insert(int p)
+{
+    double px = xs[p];
+    double py = ys[p];
+    int c = 0;
+
+    for (int depth = 0; ; ++depth)
+    {
+        cells[c].mass += 1;
+        cells[c].mx += px;
+        cells[c].my += py;
+
+        if (cells[c].firstChild < 0)
+        {
+            if (cells[c].mass == 1)
+            {
+                cells[c].point = p;
+                return;
+            }
+            if (depth >= maxDepth)
+            {
+                cells[c].point = -1;
+                return;
+            }
+
+            int old = cells[c].point;
+            double half = cells[c].size / 2;
+            int first = (int)cells.size();
+
+            for (int q = 0; q < 4; ++q)
+            {
+                double x0 = cells[c].x0 + (q & 1) * half;
+                double y0 = cells[c].y0 + (q >> 1) * half;
+                cells.push_back({x0, y0, half, 0, 0, 0, -1, -1});
+            }
+
+            cells[c].firstChild = first;
+            cells[c].point = -1;
+
+            if (old >= 0)
+            {
+                double cx = cells[c].x0 + half;
+                double cy = cells[c].y0 + half;
+                Cell& child = cells[first + (xs[old] >= cx) + 2 * (ys[old] >= cy)];
+                child.mass = 1;
+                child.mx = xs[old];
+                child.my = ys[old];
+                child.point = old;
+            }
+        }
+
+        double half = cells[c].size / 2;
+        c = cells[c].firstChild + (px >= cells[c].x0 + half) + 2 * (py >= cells[c].y0 + half);
+    }
+}
+
+void ForceLayout::buildTree()
+{
+    int n = (int)xs.size();
+    double minX = xs[0], maxX = xs[0], minY = ys[0], maxY = ys[0];
+
+    for (int i = 1; i < n; ++i)
+    {
+        minX = std::min(minX, xs[i]);
+        maxX = std::max(maxX, xs[i]);
+        minY = std::min(minY, ys[i]);
+        maxY = std::max(maxY, ys[i]);
+    }
+
+    double size = std::max(maxX - minX, maxY - minY) * 1.0001 + 1.0;
+
+    cells.clear();
+    cells.reserve((size_t)n * 2 + 1);
+    cells.push_back({minX, minY, size, 0, 0, 0, -1, -1});
+
+    for (int i = 0; i < n; ++i)
+        insert(i);
+}
+
+void ForceLayout::computeForces(int begin, int end)
+{
+    double k = params.idealLength;
+    double k2 = k * k;
+    double theta2 = params.theta * params.theta;
+
+    std::vector<int> stack;
+    stack.reserve(128);
+
+    double centerX = cells[0].mx / cells[0].mass;
+    double centerY = cells[0].my / cells[0].mass;
+
+    for (int i = begin; i < end; ++i)
+    {
+        double fx = 0;
+        double fy = 0;
+        double xi = xs[i];
+        double yi = ys[i];
+
+        stack.clear();
+        stack.push_back(0);
+
+        while (!stack.empty())
+        {
+            const Cell& cell = cells[stack.back()];
+            stack.pop_back();
+
+            if (cell.mass == 0 || cell.point == i) continue;
+
+            double cx = cell.mx / cell.mass;
+            double cy = cell.my / cell.mass;
+            double ddx = xi - cx;
+            double ddy = yi - cy;
+            double d2 = ddx * ddx + ddy * ddy;
+
+            if (cell.firstChild < 0 || cell.size * cell.size < theta2 * d2)
+            {
+                d2 = std::max(d2, 0.01);
+                double f = k2 * cell.mass / d2;
+                fx += ddx * f;
+                fy += ddy * f;
+            }
+            else
+            {
+                for (int q = 0; q < 4; ++q)
+                    stack.push_back(cell.firstChild + q);
+            }
+        }
+
+        for (int a = adjOffsets[i]; a < adjOffsets[i + 1]; ++a)
+        {
+            int j = adj[a];
+            double ddx = xi - xs[j];
+            double ddy = yi - ys[j];
+            double d = std::sqrt(ddx * ddx + ddy * ddy);
+            fx -= ddx * d / k;
+            fy -= ddy * d / k;
+        }
+
+        fx -= (xi - centerX) * params.gravity * k;
+        fy -= (yi - centerY) * params.gravity * k;
+
+        dx[i] = fx;
+        dy[i] = fy;
+    }
+}
+
+bool ForceLayout::step()
+{
+    int n = (int)xs.size();
+    if (n < 2 || converged()) return false;
+
+    buildTree();
+
+    int workers = params.threads > 0 ? params.threads : (int)std::thread::hardware_concurrency();
+    workers = std::max(1, std::min(workers, n / 512 + 1));
+
+    std::vector<std::thread> pool;
+    int chunk = (n + workers - 1) / workers;
+    for (int w = 1; w < workers; ++w)
+        pool.emplace_back(&ForceLayout::computeForces, this, w * chunk, std::min(n, (w + 1) * chunk));
+    computeForces(0, std::min(n, chunk));
+    for (auto& t : pool)
+        t.join();
+
+    for (int i = 0; i < n; ++i)
+    {
+        double len = std::sqrt(dx[i] * dx[i] + dy[i] * dy[i]);
+        if (len < 1e-9) continue;
+
+        double move = std::min(len, temperature);
+        xs[i] += dx[i] / len * move;
+        ys[i] += dy[i] / len * move;
+    }
+
+    temperature *= params.cooling;
+    iterations++;
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef FORCELAYOUT_H
+#define FORCELAYOUT_H
+
+#include <utility>
+#include <vector>
+
+struct ForceLayoutParams
+{
+    double idealLength = 130.0;
+    double theta = 1.2;
+    double gravity = 0.01;
+    double cooling = 0.95;
+    int maxIterations = 300;
+    int threads = 0;
+};
+
+// Силова розкладка Фрухтермана-Рейнгольда з відштовхуванням за Барнсом-Хатом (O(n log n) за ітерацію)
+class ForceLayout
+{
+public:
+    ForceLayout(std::vector<double> xs, std::vector<double> ys,
+                const std::vector<std::pair<int, int>>& edges, const ForceLayoutParams& params = ForceLayoutParams());
+
+    bool step();
+    bool converged() const;
+
+    int iteration() const { return iterations; }
+    const std::vector<double>& x() const { return xs; }
+    const std::vector<double>& y() const { return ys; }
+
+private:
+    struct Cell
+    {
+        double x0, y0, size;
+        double mx, my, mass;
+        int firstChild;
+        int point;
+    };
+
+    static const int maxDepth = 32;
+
+    ForceLayoutParams params;
+    std::vector<double> xs, ys;
+    std::vector<double> dx, dy;
+    std::vector<int> adjOffsets;
+    std::vector<int> adj;
+    std::vector<Cell> cells;
+
+    double temperature;
+    double minTemperature;
+    int iterations;
+
+    void buildTree();
+    void insert(int p);
+    void computeForces(int begin, int end);
+};
+
+#endif // FORCELAYOUT_H
@@ -0,0 +1,154 @@
+#include "fragmentation.h"
+
+#include <algorithm>
+
+std::vector<Fragment> Fragmentation::split(const Fragment& packet, int mtu)
+{
+    std::vector<Fragment> pieces;
+
+    if (mtu <= 0)
+    {
+        pieces.push_back(packet);
+        return pieces;
+    }
+
+    int room = (mtu - packetHeaderBytes) & ~7;
+    if (packet.length + packetHeaderBytes <= mtu)
+    {
+        pieces.push_back(packet);
+        return pieces;
+    }
+    if (room <= 0) return pieces;
+
+    for (int done = 0; done < packet.length; done += room)
+    {
+        int length = std::min(room, packet.length - done);
+        pieces.push_back({packet.offset + done, length, packet.last && done + length == packet.length});
+    }
+    return pieces;
+}
+
+int Fragmentation::fragmentsAlongPath(int payload, const std::vector<int>& hopMtus)
+{
+    std::vector<Fragment> packets = {{0, payload, true}};
+
+    for (int mtu : hopMtus)
+    {
+        std::vector<Fragment> next;
+        for (const Fragment& packet : packets)
+        {
+            std::vector<Fragment> pieces = split(packet, mtu);
+            if (pieces.empty()) return 0;
+            next.insert(next.end(), pieces.begin(), pieces.end());
+        }
+        packets.swap(next);
+    }
+
+    return (int)packets.size();
+}
+
+ReassemblyBuffer::ReassemblyBuffer(int memoryLimit, double timeout)
+    : memoryLimit(memoryLimit), timeout(timeout), memory(0)
+{
+}
+
+bool ReassemblyBuffer::add(uint64_t datagram, const Fragment& fragment, double now)
+{
+    int cost = fragment.length + packetHeaderBytes;
+
+    while (memory + cost > memoryLimit)
+    {
+        auto oldest = pending.end();
+        for (auto it = pending.begin(); it != pending.end(); ++it)
+            if (it->first != datagram && (oldest == pending.end() || it->second.firstArrival < oldest->second.firstArrival))
+                oldest = it;
+
+        if (oldest == pending.end()) break;
+        drop(oldest->first);
+    }
+
+    // Навіть порожній буфер не вміщає фрагмент - дейтаграма втрачена
+    if (memory + cost > memoryLimit)
+    {
+        if (contains(datagram))
+            drop(datagram);
+        else
+        {
+            evicted.push_back(datagram);
+            counters.evicted++;
+        }
+        return false;
+    }
+
+    auto it = pending.find(datagram);
+    if (it == pending.end()) it = pending.insert({datagram, {now, -1, {}, 0}}).first;
+
+    Pending& entry = it->second;
+    if (fragment.last) entry.total = fragment.offset + fragment.length;
+
+    // Дублікати й перекриття не займають додаткової пам'яті
+    auto& ranges = entry.ranges;
+    int begin = fragment.offset;
+    int end = fragment.offset + fragment.length;
+    bool covered = std::any_of(ranges.begin(), ranges.end(), [=](const std::pair<int, int>& r) { return r.first <= begin && end <= r.second; });
+    if (!covered)
+    {
+        entry.memory += cost;
+        memory += cost;
+        counters.peakMemory = std::max(counters.peakMemory, memory);
+
+        ranges.push_back({begin, end});
+        std::sort(ranges.begin(), ranges.end());
+
+        std::vector<std::pair<int, int>> merged;
+        for (const auto& r : ranges)
+        {
+            if (!merged.empty() && r.first <= merged.back().second)
+                merged.back().second = std::max(merged.back().second, r.second);
+            else
+                merged.push_back(r);
+        }
+        ranges.swap(merged);
+    }
+
+    if (entry.total < 0 || ranges.size() != 1 || ranges[0].first != 0 || ranges[0].second < entry.total) return false;
+
+    memory -= entry.memory;
+    pending.erase(it);
+    counters.completed++;
+    return true;
+}
+
+std::vector<uint64_t> ReassemblyBuffer::expire(double now)
+{
+    std::vector<uint64_t> expired;
+    for (const auto& entry : pending)
+        if (now - entry.second.firstArrival >= timeout)
+            expired.push_back(entry.first);
+
+    for (uint64_t datagram : expired)
+    {
+        memory -= pending[datagram].memory;
+        pending.erase(datagram);
+        counters.timedOut++;
+    }
+    return expired;
+}
+
+std::vector<uint64_t> ReassemblyBuffer::takeEvicted()
+{
+    std::vector<uint64_t> result;
+    result.swap(evicted);
+    return result;
+}
+
+void ReassemblyBuffer::drop(uint64_t datagram)
+{
+    auto it = pending.find(datagram);
+    if (it == pending.end()) return;
+
+    memory -= it->second.memory;
+    pending.erase(it);
+    evicted.push_back(datagram);
+    counters.evicted++;
+}
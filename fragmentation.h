@@ -0,0 +1,92 @@
+#ifndef FRAGMENTATION_H
+#define FRAGMENTATION_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Заголовок кожного пакета й фрагмента, байт
+const int packetHeaderBytes = 40;
+
+enum MtuMode
+{
+    FragmentInNetwork,      // як IPv4: маршрутизатор ділить пакет, що не вміщається в наступний канал
+    PathMtuDiscovery        // як IPv6: маршрутизатор відкидає пакет і повідомляє MTU, ділить лише джерело
+};
+
+// Зміщення й довжина даних відносно початку оригінальної дейтаграми
+struct Fragment
+{
+    int offset;
+    int length;
+    bool last;
+};
+
+class Fragmentation
+{
+public:
+    // Дані всіх фрагментів, крім останнього, кратні 8 байтам, як в IPv4; порожньо, якщо MTU не вміщає навіть заголовок.
+    // MTU 0 - канал без обмеження
+    static std::vector<Fragment> split(const Fragment& packet, int mtu);
+
+    // Скільки пакетів дійде до призначення, якщо кожен канал шляху ділить те, що в нього не вміщається
+    static int fragmentsAlongPath(int payload, const std::vector<int>& hopMtus);
+};
+
+struct FragmentationStats
+{
+    int64_t datagrams = 0;          // дейтаграми, що були поділені
+    int64_t fragments = 0;          // усі створені фрагменти, включно з повторно поділеними
+    int64_t overheadBytes = 0;      // додаткові заголовки
+    int64_t tooBig = 0;             // відкинуті з повідомленням "Packet Too Big" (PMTUD)
+};
+
+struct ReassemblyStats
+{
+    int64_t completed = 0;
+    int64_t timedOut = 0;
+    int64_t evicted = 0;            // витіснені через ліміт пам'яті
+    int peakMemory = 0;
+};
+
+// Буфер збирання на вузлі призначення. Пам'ять рахується як дані плюс заголовок кожного збереженого фрагмента;
+// коли ліміт вичерпано, першими витісняються найстаріші незібрані дейтаграми
+class ReassemblyBuffer
+{
+public:
+    ReassemblyBuffer(int memoryLimit = 65536, double timeout = 30);
+
+    // true - дейтаграма зібрана повністю
+    bool add(uint64_t datagram, const Fragment& fragment, double now);
+
+    // Дейтаграми, що не зібралися за timeout від першого фрагмента
+    std::vector<uint64_t> expire(double now);
+
+    // Дейтаграми, викинуті через ліміт пам'яті з часу останнього виклику
+    std::vector<uint64_t> takeEvicted();
+
+    bool contains(uint64_t datagram) const { return pending.count(datagram) != 0; }
+    bool empty() const { return pending.empty(); }
+    int memoryUsed() const { return memory; }
+    const ReassemblyStats& stats() const { return counters; }
+
+private:
+    struct Pending
+    {
+        double firstArrival;
+        int total;                              // -1, поки не прийшов останній фрагмент
+        std::vector<std::pair<int, int>> ranges; // отримані [початок, кінець), злиті й відсортовані
+        int memory;
+    };
+
+    int memoryLimit;
+    double timeout;
+    int memory;
+    std::unordered_map<uint64_t, Pending> pending;
+    std::vector<uint64_t> evicted;
+    ReassemblyStats counters;
+
+    void drop(uint64_t datagram);
+};
+
+#endif // FRAGMENTATION_H
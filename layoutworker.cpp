@@ -0,0 +1,61 @@
+#include "layoutworker.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+LayoutWorker::LayoutWorker(QList<int> nodeIds, std::unique_ptr<ForceLayout> layout)
+    : ids(std::move(nodeIds)), layout(std::move(layout)), cancelled(false)
+{
+}
+
+LayoutWorker *LayoutWorker::create(QList<int> nodeIds, std::unique_ptr<ForceLayout> layout)
+{
+    QThread *thread = new QThread();
+    LayoutWorker *worker = new LayoutWorker(std::move(nodeIds), std::move(layout));
+    worker->moveToThread(thread);
+
+    connect(thread, &QThread::started, worker, &LayoutWorker::run);
+    connect(worker, &LayoutWorker::finished, thread, &QThread::quit);
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    return worker;
+}
+
+void LayoutWorker::launch()
+{
+    thread()->start(QThread::LowPriority);
+}
+
+void LayoutWorker::run()
+{
+    QElapsedTimer clock;
+    clock.start();
+    qint64 lastPublish = 0;
+
+    while (!cancelled && layout->step())
+    {
+        if (clock.elapsed() - lastPublish >= publishIntervalMs)
+        {
+            publish();
+            lastPublish = clock.elapsed();
+        }
+    }
+
+    if (!cancelled) publish();
+
+    emit finished(layout->iteration(), clock.elapsed());
+}
+
+void LayoutWorker::publish()
+{
+    const std::vector<double>& xs = layout->x();
+    const std::vector<double>& ys = layout->y();
+
+    QList<QPointF> positions;
+    positions.reserve((int)xs.size());
+    for (size_t i = 0; i < xs.size(); ++i)
+        positions.append(QPointF(xs[i], ys[i]));
+
+    emit positionsUpdated(ids, positions);
+}
@@ -0,0 +1,42 @@
+#ifndef LAYOUTWORKER_H
+#define LAYOUTWORKER_H
+
+#include <QObject>
+#include <QList>
+#include <QPointF>
+#include <atomic>
+#include <memory>
+#include "forcelayout.h"
+
+// Виконує ForceLayout у власному потоці й періодично віддає позиції в GUI-потік
+class LayoutWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    LayoutWorker(QList<int> nodeIds, std::unique_ptr<ForceLayout> layout);
+
+    static const int publishIntervalMs = 100;
+
+    void cancel() { cancelled = true; }
+
+    // Створює робітника у власному QThread; потік запускається launch() після під'єднання сигналів
+    static LayoutWorker *create(QList<int> nodeIds, std::unique_ptr<ForceLayout> layout);
+    void launch();
+
+public slots:
+    void run();
+
+signals:
+    void positionsUpdated(const QList<int>& nodeIds, const QList<QPointF>& positions);
+    void finished(int iterations, qint64 elapsedMs);
+
+private:
+    QList<int> ids;
+    std::unique_ptr<ForceLayout> layout;
+    std::atomic<bool> cancelled;
+
+    void publish();
+};
+
+#endif // LAYOUTWORKER_H
@@ -0,0 +1,188 @@
+#ifndef LINKSCHEDULER_H
+#define LINKSCHEDULER_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+
+// Класи трафіку в порядку строгого пріоритету: керуючі пакети каналу, інтерактивні й масові потоки
+enum TrafficClass
+{
+    ControlClass,
+    InteractiveClass,
+    BulkClass
+};
+
+const int trafficClassCount = 3;
+
+enum SchedulingDiscipline
+{
+    FifoScheduling,
+    StrictPriorityScheduling,
+    DeficitRoundRobinScheduling
+};
+
+struct SchedulerParams
+{
+    SchedulingDiscipline discipline = FifoScheduling;
+    double rate = 100000;               // байт/с в одному напрямку каналу
+    int queueLimit = 32;                // пакетів на клас; у FIFO спільна черга того ж сумарного розміру
+    std::array<int, trafficClassCount> quantum = {1500, 1500, 1500};   // DRR: байт на клас за раунд
+};
+
+struct ClassStats
+{
+    int64_t enqueued = 0;
+    int64_t sent = 0;
+    int64_t dropped = 0;                // хвостове відкидання на повній черзі
+    int64_t bytes = 0;
+    double delaySum = 0;                // очікування в черзі, с
+    double maxDelay = 0;
+    int maxDepth = 0;
+
+    void add(const ClassStats& other)
+    {
+        enqueued += other.enqueued;
+        sent += other.sent;
+        dropped += other.dropped;
+        bytes += other.bytes;
+        delaySum += other.delaySum;
+        maxDelay = std::max(maxDelay, other.maxDelay);
+        maxDepth = std::max(maxDepth, other.maxDepth);
+    }
+};
+
+// Вихідна черга одного напрямку каналу. Канал передає по одному пакету; який пакет наступний,
+// вирішує дисципліна: FIFO, строгий пріоритет класів або дефіцитний круговий обхід (DRR)
+template <typename Payload>
+class LinkScheduler
+{
+public:
+    struct Item
+    {
+        Payload payload;
+        int trafficClass;
+        int bytes;
+        double enqueuedAt;
+    };
+
+    explicit LinkScheduler(const SchedulerParams& params = SchedulerParams())
+        : params(params), current(0), freshRound(true)
+    {
+        deficit.fill(0);
+        depth.fill(0);
+        for (int& q : this->params.quantum)
+            q = std::max(q, 1);
+    }
+
+    // false - черга заповнена, пакет відкинуто
+    bool enqueue(const Payload& payload, int trafficClass, int bytes, double now)
+    {
+        trafficClass = std::clamp(trafficClass, 0, trafficClassCount - 1);
+        ClassStats& stats = classStats[trafficClass];
+
+        bool fifo = params.discipline == FifoScheduling;
+        std::deque<Item>& queue = queues[fifo ? 0 : trafficClass];
+        if ((int)queue.size() >= (fifo ? params.queueLimit * trafficClassCount : params.queueLimit))
+        {
+            stats.dropped++;
+            return false;
+        }
+
+        queue.push_back({payload, trafficClass, bytes, now});
+        stats.enqueued++;
+        stats.maxDepth = std::max(stats.maxDepth, ++depth[trafficClass]);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return std::all_of(queues.begin(), queues.end(), [](const std::deque<Item>& q) { return q.empty(); });
+    }
+
+    int size() const
+    {
+        int total = 0;
+        for (const std::deque<Item>& q : queues)
+            total += (int)q.size();
+        return total;
+    }
+
+    // Викликається, коли канал звільнився; черги не повинні бути порожніми
+    Item dequeue(double now)
+    {
+        Item item = params.discipline == DeficitRoundRobinScheduling ? nextRoundRobin() : nextInOrder();
+
+        ClassStats& stats = classStats[item.trafficClass];
+        double delay = now - item.enqueuedAt;
+        stats.sent++;
+        stats.bytes += item.bytes;
+        stats.delaySum += delay;
+        stats.maxDelay = std::max(stats.maxDelay, delay);
+        depth[item.trafficClass]--;
+        return item;
+    }
+
+    double transmissionTime(int bytes) const { return bytes / params.rate; }
+
+    // Швидкість каналу може змінитися між пакетами, наприклад після зміни ємності
+    void setRate(double rate) { params.rate = std::max(rate, 1.0); }
+
+    const ClassStats& stats(int trafficClass) const { return classStats[trafficClass]; }
+
+private:
+    SchedulerParams params;
+    std::array<std::deque<Item>, trafficClassCount> queues;
+    std::array<ClassStats, trafficClassCount> classStats;
+    std::array<int, trafficClassCount> deficit;
+    int current;
+    bool freshRound;
+    std::array<int, trafficClassCount> depth;
+
+    // FIFO тримає все в черзі 0, тож обидві дисципліни беруть першу непорожню
+    Item nextInOrder()
+    {
+        for (std::deque<Item>& queue : queues)
+        {
+            if (queue.empty()) continue;
+            Item item = queue.front();
+            queue.pop_front();
+            return item;
+        }
+        return Item();
+    }
+
+    // Кожен візит додає класу квант; порожній клас втрачає накопичений дефіцит
+    Item nextRoundRobin()
+    {
+        for (;;)
+        {
+            std::deque<Item>& queue = queues[current];
+            if (!queue.empty())
+            {
+                if (freshRound) deficit[current] += params.quantum[current];
+                freshRound = false;
+
+                if (queue.front().bytes <= deficit[current])
+                {
+                    Item item = queue.front();
+                    queue.pop_front();
+                    deficit[current] -= item.bytes;
+                    if (queue.empty()) advance();
+                    return item;
+                }
+            }
+            advance();
+        }
+    }
+
+    void advance()
+    {
+        if (queues[current].empty()) deficit[current] = 0;
+        current = (current + 1) % trafficClassCount;
+        freshRound = true;
+    }
+};
+
+#endif // LINKSCHEDULER_H
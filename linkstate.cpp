@@ -0,0 +1,320 @@
+#include "linkstate.h"
+
+#include <algorithm>
+
+namespace
+{
+
+// Розміри як в OSPFv2: IP 20 + заголовок OSPF 24 + LSU 4 + заголовок LSA 20 + тіло router-LSA 4 + 12 на канал
+int lsaBytes(size_t links) { return 72 + 12 * (int)links; }
+const int ackBytes = 64;
+
+const int64_t unreachable = std::numeric_limits<int64_t>::max();
+
+inline uint64_t mix(uint64_t hash, uint64_t value)
+{
+    return (hash ^ value) * 1099511628211ULL;
+}
+
+}
+
+LinkStateSimulation::LinkStateSimulation(const Topology& topology, const LinkStateParams& params)
+    : params(params), n((int)topology.nodes.size()), nodes(topology.nodes), edges(topology.edges),
+      phaseStart(0), lastFibChange(0), lastMessage(0)
+{
+    edgeUp.assign(edges.size(), 1);
+
+    adjOffsets.assign(n + 1, 0);
+    for (const TopologyEdge& e : edges)
+    {
+        if (e.source == e.dest) continue;
+        adjOffsets[e.source + 1]++;
+        adjOffsets[e.dest + 1]++;
+    }
+    for (int i = 0; i < n; ++i)
+        adjOffsets[i + 1] += adjOffsets[i];
+
+    adj.resize(adjOffsets[n]);
+    std::vector<int> fill(adjOffsets.begin(), adjOffsets.end() - 1);
+    for (int i = 0; i < (int)edges.size(); ++i)
+    {
+        const TopologyEdge& e = edges[i];
+        if (e.source == e.dest) continue;
+
+        int weight = params.minHops ? 1 : e.weight;
+        adj[fill[e.source]++] = {e.dest, weight, i};
+        adj[fill[e.dest]++] = {e.source, weight, i};
+    }
+
+    // Паралельні канали стоять поруч, тож розсилка й LSA бачать кожного сусіда один раз
+    for (int i = 0; i < n; ++i)
+        std::sort(adj.begin() + adjOffsets[i], adj.begin() + adjOffsets[i + 1],
+                  [](const Link& x, const Link& y) { return x.neighbor != y.neighbor ? x.neighbor < y.neighbor : x.weight < y.weight; });
+
+    history.resize(n);
+    lsdb.assign((size_t)n * n, 0);
+    routers.resize(n);
+    for (Router& router : routers)
+        router.hold = params.spfHold;
+}
+
+void LinkStateSimulation::beginPhase(const QString& phase, bool settle)
+{
+    if (settle) queue.advanceTo(queue.now() + 2 * params.spfMax + 1);
+
+    stats = ConvergenceStats();
+    stats.phase = phase;
+    phaseStart = queue.now();
+    lastFibChange = phaseStart;
+    lastMessage = phaseStart;
+
+    for (Router& router : routers)
+        router.spfRuns = 0;
+}
+
+ConvergenceStats LinkStateSimulation::coldStart(const std::atomic<bool> *cancelled)
+{
+    beginPhase("Холодний старт", false);
+
+    for (int r = 0; r < n; ++r)
+        originate(r);
+
+    return runPhase(cancelled);
+}
+
+ConvergenceStats LinkStateSimulation::setLinkState(int edgeIndex, bool up, const std::atomic<bool> *cancelled)
+{
+    const TopologyEdge& e = edges[edgeIndex];
+    QString link = QString::number(nodes[e.source].id) + "-" + QString::number(nodes[e.dest].id);
+    beginPhase((up ? "Відновлення каналу " : "Відмова каналу ") + link, true);
+
+    if (edgeUp[edgeIndex] == (char)up || e.source == e.dest) return runPhase(cancelled);
+    edgeUp[edgeIndex] = up;
+
+    originate(e.source);
+    originate(e.dest);
+
+    // Нова суміжність синхронізує бази: кожен бік надсилає те, чого в сусіда немає або що в нього старіше
+    if (up)
+    {
+        const uint32_t *a = &lsdb[(size_t)e.source * n];
+        const uint32_t *b = &lsdb[(size_t)e.dest * n];
+        for (int o = 0; o < n; ++o)
+        {
+            if (a[o] > b[o]) send(e.source, e.dest, o, a[o]);
+            else if (b[o] > a[o]) send(e.dest, e.source, o, b[o]);
+        }
+    }
+
+    return runPhase(cancelled);
+}
+
+void LinkStateSimulation::originate(int router)
+{
+    Lsa lsa;
+    for (int a = adjOffsets[router]; a < adjOffsets[router + 1]; ++a)
+    {
+        const Link& link = adj[a];
+        if (!edgeUp[link.edge]) continue;
+        if (!lsa.empty() && lsa.back().first == link.neighbor) continue;
+        lsa.push_back({link.neighbor, link.weight});
+    }
+
+    history[router].push_back(std::move(lsa));
+    uint32_t seq = (uint32_t)history[router].size();
+
+    lsdb[(size_t)router * n + router] = seq;
+    flood(router, -1, router, seq);
+    triggerSpf(router);
+}
+
+void LinkStateSimulation::flood(int router, int except, int origin, uint32_t seq)
+{
+    int last = -1;
+    for (int a = adjOffsets[router]; a < adjOffsets[router + 1]; ++a)
+    {
+        const Link& link = adj[a];
+        if (!edgeUp[link.edge] || link.neighbor == except || link.neighbor == last) continue;
+
+        last = link.neighbor;
+        send(router, link.neighbor, origin, seq);
+    }
+}
+
+void LinkStateSimulation::send(int from, int to, int origin, uint32_t seq)
+{
+    double arrival = queue.now() + params.linkDelay;
+
+    stats.messages++;
+    stats.bytes += lsaBytes(history[origin][seq - 1].size());
+    lastMessage = std::max(lastMessage, arrival);
+
+    queue.push(arrival, {LsaArrival, to, from, origin, seq});
+}
+
+void LinkStateSimulation::receive(const Event& event)
+{
+    // Кожне отримане LSA підтверджується, навіть дублікат
+    stats.messages++;
+    stats.bytes += ackBytes;
+    lastMessage = std::max(lastMessage, queue.now() + params.linkDelay);
+
+    uint32_t& installed = lsdb[(size_t)event.router * n + event.origin];
+    if (installed >= event.seq)
+    {
+        stats.duplicates++;
+        return;
+    }
+
+    installed = event.seq;
+    flood(event.router, event.from, event.origin, event.seq);
+    triggerSpf(event.router);
+}
+
+// Поки SPF чекає, нові зміни лише додаються до нього. Після тиші довше 2 * spfMax
+// перший SPF іде через spfInitial, а кожен наступний підряд - через подвоєну паузу
+void LinkStateSimulation::triggerSpf(int router)
+{
+    Router& state = routers[router];
+    double now = queue.now();
+
+    bool quiet = now - state.lastTrigger > 2 * params.spfMax;
+    state.lastTrigger = now;
+
+    if (state.spfPending) return;
+    state.spfPending = true;
+
+    double at;
+    if (quiet)
+    {
+        state.hold = params.spfHold;
+        at = now + params.spfInitial;
+    }
+    else
+    {
+        at = std::max(now + params.spfInitial, state.lastSpfEnd + state.hold);
+        state.hold = std::min(state.hold * 2, params.spfMax);
+    }
+
+    queue.push(at, {SpfRun, router, -1, -1, 0});
+}
+
+void LinkStateSimulation::runSpf(int router)
+{
+    Router& state = routers[router];
+    state.spfPending = false;
+
+    uint64_t fibHash = 0;
+    state.distHash = spf(router, &lsdb[(size_t)router * n], &fibHash);
+
+    double end = queue.now() + params.spfCostPerNode * n;
+    state.lastSpfEnd = end;
+    state.spfRuns++;
+    stats.computations++;
+
+    if (fibHash != state.fibHash)
+    {
+        state.fibHash = fibHash;
+        lastFibChange = std::max(lastFibChange, end);
+    }
+}
+
+// Канал враховується, лише якщо обидва кінці оголошують його у своїх LSA (перевірка двосторонності)
+bool LinkStateSimulation::advertises(const uint32_t *view, int origin, int neighbor) const
+{
+    uint32_t seq = view[origin];
+    if (seq == 0) return false;
+
+    const Lsa& lsa = history[origin][seq - 1];
+    auto it = std::lower_bound(lsa.begin(), lsa.end(), std::make_pair(neighbor, INT32_MIN));
+    return it != lsa.end() && it->first == neighbor;
+}
+
+uint64_t LinkStateSimulation::spf(int root, const uint32_t *view, uint64_t *fibHash)
+{
+    dist.assign(n, unreachable);
+    firstHop.assign(n, -1);
+    heap.clear();
+
+    auto later = [](const std::pair<int64_t, int>& x, const std::pair<int64_t, int>& y) { return x > y; };
+
+    dist[root] = 0;
+    heap.push_back({0, root});
+
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        std::pair<int64_t, int> top = heap.back();
+        heap.pop_back();
+
+        int u = top.second;
+        if (top.first > dist[u] || view[u] == 0) continue;
+
+        for (const auto& link : history[u][view[u] - 1])
+        {
+            int v = link.first;
+            int64_t candidate = top.first + link.second;
+            if (candidate >= dist[v] || !advertises(view, v, u)) continue;
+
+            dist[v] = candidate;
+            firstHop[v] = u == root ? v : firstHop[u];
+            heap.push_back({candidate, v});
+            std::push_heap(heap.begin(), heap.end(), later);
+        }
+    }
+
+    uint64_t distHash = 1469598103934665603ULL;
+    uint64_t hopHash = 1469598103934665603ULL;
+    for (int v = 0; v < n; ++v)
+    {
+        distHash = mix(distHash, (uint64_t)dist[v]);
+        hopHash = mix(hopHash, (uint64_t)(int64_t)firstHop[v]);
+    }
+
+    if (fibHash) *fibHash = hopHash;
+    return distHash;
+}
+
+ConvergenceStats LinkStateSimulation::runPhase(const std::atomic<bool> *cancelled)
+{
+    uint64_t processed = 0;
+
+    while (!queue.empty())
+    {
+        if ((++processed & 4095) == 0 && cancelled && cancelled->load())
+        {
+            queue.clear();
+            stats.completed = false;
+            return stats;
+        }
+
+        EventQueue<Event>::Event event = queue.pop();
+        if (event.payload.type == LsaArrival)
+            receive(event.payload);
+        else
+            runSpf(event.payload.router);
+    }
+
+    stats.convergenceTime = lastFibChange - phaseStart;
+    stats.quietTime = lastMessage - phaseStart;
+
+    for (const Router& router : routers)
+        stats.maxComputations = std::max(stats.maxComputations, router.spfRuns);
+
+    // Еталон - SPF над базою, де в кожного джерела остання версія LSA
+    std::vector<uint32_t> truth(n);
+    for (int o = 0; o < n; ++o)
+        truth[o] = (uint32_t)history[o].size();
+
+    for (int r = 0; r < n; ++r)
+    {
+        if (cancelled && cancelled->load())
+        {
+            stats.completed = false;
+            break;
+        }
+        if (spf(r, truth.data(), nullptr) != routers[r].distHash) stats.inconsistentRouters++;
+    }
+
+    return stats;
+}
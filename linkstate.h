@@ -0,0 +1,118 @@
+#ifndef LINKSTATE_H
+#define LINKSTATE_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "convergence.h"
+#include "eventqueue.h"
+#include "topology.h"
+
+struct LinkStateParams
+{
+    bool minHops = false;
+
+    double linkDelay = 0.002;       // с на канал, включно з обробкою LSA на отримувачі
+
+    double spfInitial = 0.05;       // с від першої зміни після тиші до SPF
+    double spfHold = 0.2;           // с між SPF підряд; подвоюється до spfMax
+    double spfMax = 5.0;            // тиша довше 2 * spfMax скидає паузу до spfHold
+    double spfCostPerNode = 1e-6;   // с, модельний час SPF на вузол графа
+};
+
+// Модель протоколу стану каналів: кожен маршрутизатор має власну LSDB, LSA розсилаються лавинно
+// по живих каналах з номерами послідовності, а SPF рахується з затримкою й експоненційним відкладенням.
+// Маршрути кожного маршрутизатора будуються лише з його LSDB
+class LinkStateSimulation
+{
+public:
+    // LSDB зберігає номер версії LSA для кожної пари (маршрутизатор, джерело)
+    static const int maxRouters = 5000;
+
+    LinkStateSimulation(const Topology& topology, const LinkStateParams& params = LinkStateParams());
+
+    int routerCount() const { return n; }
+
+    // Усі маршрутизатори вмикаються одночасно з порожніми LSDB
+    ConvergenceStats coldStart(const std::atomic<bool> *cancelled = nullptr);
+
+    // edgeIndex - індекс у Topology::edges; фаза починається після тиші, що скидає відкладення SPF
+    ConvergenceStats setLinkState(int edgeIndex, bool up, const std::atomic<bool> *cancelled = nullptr);
+
+private:
+    enum EventType
+    {
+        LsaArrival,
+        SpfRun
+    };
+
+    struct Event
+    {
+        EventType type;
+        int router;
+        int from;
+        int origin;
+        uint32_t seq;
+    };
+
+    struct Link
+    {
+        int neighbor;
+        int weight;
+        int edge;
+    };
+
+    // Пари (сусід, вага), впорядковані за сусідом
+    using Lsa = std::vector<std::pair<int, int>>;
+
+    struct Router
+    {
+        bool spfPending = false;
+        double lastTrigger = -std::numeric_limits<double>::infinity();
+        double lastSpfEnd = -std::numeric_limits<double>::infinity();
+        double hold = 0;
+        int spfRuns = 0;
+        uint64_t distHash = 0;
+        uint64_t fibHash = 0;
+    };
+
+    LinkStateParams params;
+    int n;
+    std::vector<TopologyNode> nodes;
+    std::vector<TopologyEdge> edges;
+    std::vector<char> edgeUp;
+
+    std::vector<int> adjOffsets;
+    std::vector<Link> adj;
+
+    std::vector<std::vector<Lsa>> history;  // версії LSA кожного джерела; seq = індекс + 1
+    std::vector<uint32_t> lsdb;             // n * n, 0 - LSA ще немає
+    std::vector<Router> routers;
+
+    EventQueue<Event> queue;
+    ConvergenceStats stats;
+    double phaseStart;
+    double lastFibChange;
+    double lastMessage;
+
+    std::vector<int64_t> dist;
+    std::vector<int> firstHop;
+    std::vector<std::pair<int64_t, int>> heap;
+
+    void originate(int router);
+    void flood(int router, int except, int origin, uint32_t seq);
+    void send(int from, int to, int origin, uint32_t seq);
+    void receive(const Event& event);
+    void triggerSpf(int router);
+    void runSpf(int router);
+
+    bool advertises(const uint32_t *view, int origin, int neighbor) const;
+    uint64_t spf(int root, const uint32_t *view, uint64_t *fibHash);
+
+    void beginPhase(const QString& phase, bool settle);
+    ConvergenceStats runPhase(const std::atomic<bool> *cancelled);
+};
+
+#endif // LINKSTATE_H
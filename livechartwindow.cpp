@@ -0,0 +1,113 @@
+#include "livechartwindow.h"
+
+#include <QGridLayout>
+
+LiveChartWindow::LiveChartWindow(const Telemetry *telemetry, QWidget *parent)
+    : QDialog(parent), telemetry(telemetry), lastRunId(-1)
+{
+    setWindowTitle("Симуляція в реальному часі");
+    resize(1000, 700);
+
+    plots[0] = createPlot("Пропускна здатність", "байт/с");
+    plots[1] = createPlot("Корисна пропускна здатність (goodput)", "байт/с");
+    plots[2] = createPlot("Повторні передачі", "пакетів/с");
+    plots[3] = createPlot("Пакети в мережі", "шт");
+
+    QGridLayout *layout = new QGridLayout(this);
+    for (int i = 0; i < 4; ++i)
+    {
+        QChartView *view = new QChartView(plots[i].chart);
+        view->setRenderHint(QPainter::Antialiasing);
+        layout->addWidget(view, i / 2, i % 2);
+    }
+    setLayout(layout);
+
+    frameTimer = new QTimer(this);
+    connect(frameTimer, &QTimer::timeout, this, &LiveChartWindow::onFrame);
+    frameTimer->start(frameIntervalMs);
+}
+
+LiveChartWindow::~LiveChartWindow()
+{
+}
+
+LiveChartWindow::Plot LiveChartWindow::createPlot(const QString& title, const QString& yLabel)
+{
+    Plot plot;
+
+    plot.series = new QLineSeries();
+
+    plot.chart = new QChart();
+    plot.chart->addSeries(plot.series);
+    plot.chart->setTitle(title);
+    plot.chart->setAnimationOptions(QChart::NoAnimation);
+    plot.chart->legend()->setVisible(false);
+
+    plot.axisX = new QValueAxis();
+    plot.axisX->setTitleText("Час симуляції, с");
+    plot.chart->addAxis(plot.axisX, Qt::AlignBottom);
+    plot.series->attachAxis(plot.axisX);
+
+    plot.axisY = new QValueAxis();
+    plot.axisY->setTitleText(yLabel);
+    plot.chart->addAxis(plot.axisY, Qt::AlignLeft);
+    plot.series->attachAxis(plot.axisY);
+
+    return plot;
+}
+
+void LiveChartWindow::onFrame()
+{
+    if (!telemetry || !telemetry->clock.isValid()) return;
+
+    if (telemetry->runId != lastRunId)
+    {
+        samples.clear();
+        lastRunId = telemetry->runId;
+    }
+
+    double now = telemetry->simTime();
+    samples.push_back({now, telemetry->bytesSent, telemetry->payloadDelivered, telemetry->retransmissions, telemetry->inFlight});
+
+    while ((int)samples.size() > maxSamples || (samples.size() > 1 && samples.front().time < now - windowSeconds - rateWindow))
+        samples.pop_front();
+
+    QList<QPointF> points[4];
+    double maxY[4] = {1, 1, 1, 1};
+
+    for (int i = 0; i < 4; ++i)
+        points[i].reserve((int)samples.size());
+
+    // Швидкості рахуються по ковзному вікну в rateWindow секунд
+    size_t back = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const Sample& cur = samples[i];
+        if (cur.time < now - windowSeconds) continue;
+
+        while (back < i && samples[back + 1].time <= cur.time - rateWindow)
+            back++;
+
+        const Sample& prev = samples[back];
+        double dt = cur.time - prev.time;
+
+        double values[4];
+        values[0] = dt > 0 ? (cur.bytesSent - prev.bytesSent) / dt : 0.0;
+        values[1] = dt > 0 ? (cur.payloadDelivered - prev.payloadDelivered) / dt : 0.0;
+        values[2] = dt > 0 ? (cur.retransmissions - prev.retransmissions) / dt : 0.0;
+        values[3] = cur.inFlight;
+
+        for (int k = 0; k < 4; ++k)
+        {
+            points[k].append(QPointF(cur.time, values[k]));
+            if (values[k] > maxY[k]) maxY[k] = values[k];
+        }
+    }
+
+    for (int k = 0; k < 4; ++k)
+    {
+        plots[k].series->replace(points[k]);
+        plots[k].axisX->setRange(qMax(0.0, now - windowSeconds), qMax(now, 1.0));
+        plots[k].axisY->setRange(0, maxY[k] * 1.1);
+    }
+}
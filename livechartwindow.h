@@ -0,0 +1,55 @@
+#ifndef LIVECHARTWINDOW_H
+#define LIVECHARTWINDOW_H
+
+#include <QDialog>
+#include <QTimer>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
+#include <deque>
+#include "telemetry.h"
+
+class LiveChartWindow : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LiveChartWindow(const Telemetry *telemetry, QWidget *parent = nullptr);
+    ~LiveChartWindow();
+
+private:
+    struct Sample
+    {
+        double time;
+        qint64 bytesSent;
+        qint64 payloadDelivered;
+        qint64 retransmissions;
+        int inFlight;
+    };
+
+    struct Plot
+    {
+        QChart *chart;
+        QLineSeries *series;
+        QValueAxis *axisX;
+        QValueAxis *axisY;
+    };
+
+    static const int frameIntervalMs = 50;
+    static const int windowSeconds = 30;
+    static const int maxSamples = (windowSeconds + 1) * 1000 / frameIntervalMs;
+    static constexpr double rateWindow = 1.0;
+
+    const Telemetry *telemetry;
+    QTimer *frameTimer;
+
+    int lastRunId;
+
+    std::deque<Sample> samples;
+    Plot plots[4];
+
+    Plot createPlot(const QString& title, const QString& yLabel);
+    void onFrame();
+};
+
+#endif // LIVECHARTWINDOW_H
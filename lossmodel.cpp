@@ -0,0 +1,100 @@
+#include "lossmodel.h"
+
+#include <cmath>
+
+LossModel::LossModel(uint64_t seed, uint32_t a, uint32_t b)
+    : streamA(a), streamB(b), rng(seed, a, b), gap(never), gapProbability(-1), bad(false), stateLeft(-1)
+{
+}
+
+void LossModel::reseed(uint64_t seed)
+{
+    rng = CounterRng(seed, streamA, streamB);
+    gapProbability = -1;
+    bad = false;
+    stateLeft = -1;
+}
+
+void LossModel::setParams(const LossParams& params)
+{
+    lossParams = params;
+    gapProbability = -1;
+    bad = false;
+    stateLeft = -1;
+}
+
+// Кількість успішних спроб до першої невдачі з імовірністю p
+int64_t LossModel::geometric(double p)
+{
+    if (p <= 0) return never;
+    if (p >= 1) return 0;
+
+    double u = rng.uniform();
+    double k = std::floor(std::log1p(-u) / std::log1p(-p));
+    return k >= (double)never ? never : (int64_t)k;
+}
+
+bool LossModel::bernoulli(double p)
+{
+    if (p != gapProbability)
+    {
+        gapProbability = p;
+        gap = geometric(p);
+    }
+
+    if (gap > 0)
+    {
+        if (gap != never) gap--;
+        return false;
+    }
+
+    gap = geometric(p);
+    return true;
+}
+
+bool LossModel::drop(int packetBytes, double defaultProbability)
+{
+    switch (lossParams.type)
+    {
+    case BernoulliLoss:
+        return bernoulli(lossParams.probability);
+
+    case GilbertElliottLoss:
+    {
+        // Тривалості станів теж геометричні, тож жеребкування відбувається лише на переходах і втратах
+        if (stateLeft <= 0)
+        {
+            bad = stateLeft == 0 && !bad;
+            stateLeft = geometric(bad ? lossParams.badToGood : lossParams.goodToBad);
+            if (stateLeft != never) stateLeft++;
+            gapProbability = -1;
+        }
+        if (stateLeft != never) stateLeft--;
+
+        return bernoulli(bad ? lossParams.lossBad : lossParams.lossGood);
+    }
+
+    case BitErrorLoss:
+    {
+        if (gapProbability != lossParams.bitErrorRate)
+        {
+            gapProbability = lossParams.bitErrorRate;
+            gap = geometric(gapProbability);
+        }
+
+        int64_t bits = (int64_t)packetBytes * 8;
+        if (gap >= bits)
+        {
+            if (gap != never) gap -= bits;
+            return false;
+        }
+
+        gap = geometric(gapProbability);
+        return true;
+    }
+
+    case DefaultLoss:
+    default:
+        return bernoulli(defaultProbability);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef LOSSMODEL_H
+#define LOSSMODEL_H
+
+#include <cstdint>
+#include "counterrng.h"
+
+enum LossModelType
+{
+    DefaultLoss,        // загальна ймовірність втрат симуляції
+    BernoulliLoss,
+    GilbertElliottLoss,
+    BitErrorLoss
+};
+
+struct LossParams
+{
+    LossModelType type = DefaultLoss;
+
+    double probability = 0.0;       // Bernoulli
+
+    double goodToBad = 0.01;        // Gilbert-Elliott: ймовірності переходів за пакет
+    double badToGood = 0.3;
+    double lossGood = 0.0;
+    double lossBad = 0.5;
+
+    double bitErrorRate = 1e-6;     // BER: ймовірність втрати = 1 - (1 - BER)^біти
+};
+
+// Моделі втрат вибираються з геометричним пропуском: випадкове число потрібне лише
+// на втраченому пакеті (або зміні стану), а не на кожному проходженні каналу.
+// Тож потік каналу індексується номером жеребкування, а не (пакет, хоп)
+class LossModel
+{
+public:
+    // Потік випадкових чисел визначається (seed, a, b); для каналу a і b - id його кінців
+    LossModel(uint64_t seed, uint32_t a, uint32_t b);
+
+    // Новий прогін починає потік каналу з початку, тож однакове зерно дає однакові втрати
+    void reseed(uint64_t seed);
+
+    const LossParams& params() const { return lossParams; }
+    void setParams(const LossParams& params);
+
+    bool drop(int packetBytes, double defaultProbability);
+
+private:
+    static const int64_t never = INT64_MAX;
+
+    LossParams lossParams;
+    uint32_t streamA, streamB;
+    CounterRng rng;
+
+    int64_t gap;            // пакетів (або бітів для BER) до наступної втрати
+    double gapProbability;  // ймовірність, для якої вибрано gap
+    bool bad;
+    int64_t stateLeft;      // пакетів до зміни стану Gilbert-Elliott; -1 - ще не почато
+
+    int64_t geometric(double p);
+    bool bernoulli(double p);
+};
+
+#endif // LOSSMODEL_H
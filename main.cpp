@@ -1,12 +1,9 @@
 #include "mainwindow.h"
 
 #include <QApplication>
-#include <ctime>
-#include <cstdlib>
 
 int main(int argc, char *argv[])
 {
-    srand(time(0));
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -5,15 +5,76 @@
 #include "network.h"
 #include "packet.h"
 #include "dijkstra.h"
+#include "livechartwindow.h"
+#include "topologyimporter.h"
+#include "networkscene.h"
+#include "packetanimator.h"
+#include "layoutworker.h"
+#include "routingservice.h"
+#include "routingstate.h"
+#include "routingtablemodel.h"
+#include "adaptiverouting.h"
+#include "topologysnapshot.h"
+#include "counterrng.h"
+#include "capacityplanner.h"
+#include "crc32c.h"
+#include "datagramfragmenter.h"
 
 #include <QGraphicsScene>
 #include <QSet>
 #include <QDateTime>
 #include <QMessageBox>
+#include <QMenu>
+#include <QAction>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QVBoxLayout>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QLabel>
+#include <QFile>
+#include <QTextStream>
+#include <QWheelEvent>
+#include <QThread>
+#include <QProgressDialog>
+#include <QTableView>
+#include <QPlainTextEdit>
+#include <QHeaderView>
 #include <algorithm>
 #include <cstdlib>
 #include <QTimer>
 #include <cmath>
+#include <climits>
+
+namespace
+{
+
+// Однаковий сценарій для всіх моделей протоколів: старт, відмова каналу, його відновлення
+template <typename Simulation>
+std::vector<ConvergenceStats> runScenario(Simulation& simulation, int link, const std::atomic<bool> *cancelled)
+{
+    std::vector<ConvergenceStats> report;
+    report.push_back(simulation.coldStart(cancelled));
+    if (link >= 0 && report.back().completed)
+        report.push_back(simulation.setLinkState(link, false, cancelled));
+    if (link >= 0 && report.back().completed)
+        report.push_back(simulation.setLinkState(link, true, cancelled));
+    return report;
+}
+
+bool linkUsable(Node *from, Node *to)
+{
+    Edge *edge = from->edgeTo(to);
+    return edge && edge->isUp() && from->isUp() && to->isUp();
+}
+
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -23,10 +84,15 @@ MainWindow::MainWindow(QWidget *parent)
 
     setupTable();
 
-    QGraphicsScene *scene = new QGraphicsScene(this);
+    networkScene = new NetworkScene(this);
+    QGraphicsScene *scene = networkScene;
     ui->graphicsView->setScene(scene);
     scene->setSceneRect(-500, -500, 1000, 1000);
 
+    ui->graphicsView->setOptimizationFlag(QGraphicsView::DontAdjustForAntialiasing);
+    ui->graphicsView->setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+    ui->graphicsView->viewport()->installEventFilter(this);
+
     Node *router1 = new Node(1);
     router1->setPos(-100, 0);
     scene->addItem(router1);
@@ -40,6 +106,85 @@ MainWindow::MainWindow(QWidget *parent)
     router1->addEdge(edge);
     router2->addEdge(edge);
 
+    animator = new PacketAnimator(networkScene, this);
+
+    routingState = new RoutingState(networkScene, this);
+    routing = new RoutingService(networkScene, routingState, this);
+    adaptive = new AdaptiveRouting(networkScene, routingState, this);
+    routeRequest = 0;
+    simulationSeed = 1;
+
+    experimentPool.setMaxThreadCount(1);
+
+    workloadTimer = new QTimer(this);
+    workloadTimer->setInterval(workloadTickMs);
+    connect(workloadTimer, &QTimer::timeout, this, &MainWindow::workloadTick);
+    hasPendingFlow = false;
+    workloadRun = 0;
+    workloadLoad = 0;
+    circuitIngress = -1;
+    circuitLabel = -1;
+    setupLabel = -1;
+    circuitBandwidth = 0;
+    circuitPriority = CapacityPlanner::priorityLevels - 1;
+    recoveryMode = ReconvergenceRecovery;
+    failureRun = 0;
+    outageLost = 0;
+    fastReroutes = 0;
+    linkQueuing = false;
+    interactiveShare = 20;
+    linkRateScale = 1;
+    queueRun = 0;
+    fibRun = 0;
+    queueClock.start();
+    congestionControl = false;
+    ecnThreshold = 16;
+    liveInFlight = 0;
+    fragmenter = new DatagramFragmenter(networkScene, this);
+    fragmenter->forward = [=](Packet *pkt, int nodeId, int ttl, std::function<void(bool, int)> done)
+    {
+        forwardDatagram(pkt, nodeId, ttl, done);
+    };
+    fragmenter->verify = [=](Packet *pkt, int nodeId)
+    {
+        if (payload.verify(pkt)) return true;
+        ui->textLog->append("xx [CRC] Вузол " + QString::number(nodeId) + " відкинув спотворений пакет #" +
+                            QString::number(pkt->getSequenceNumber()) + " перед фрагментацією");
+        return false;
+    };
+    fragmenter->seal = [=](Packet *fragment, const PacketBuffer& original, int sliceOffset)
+    {
+        payload.seal(fragment, original, sliceOffset);
+    };
+    connect(fragmenter, &DatagramFragmenter::headersAdded, this, [=](int bytes) { telemetry.bytesSent += bytes; });
+    connect(fragmenter, &DatagramFragmenter::headerTooBig, this, [=](int nodeId, int mtu)
+            {
+                ui->textLog->append("xx [DROP] MTU " + QString::number(mtu) + " каналу з вузла " + QString::number(nodeId) +
+                                    " не вміщає навіть заголовок");
+            });
+    connect(fragmenter, &DatagramFragmenter::packetTooBig, this, [=](int nodeId, int nextId, int sequence, int bytes, int mtu, int sourceId)
+            {
+                ui->textLog->append("xx [PTB] Вузол " + QString::number(nodeId) + ": пакет #" + QString::number(sequence) +
+                                    " (" + QString::number(bytes) + " байт) не вміщається в MTU " + QString::number(mtu) +
+                                    " каналу до " + QString::number(nextId) + ", джерело " + QString::number(sourceId) +
+                                    " запам'ятало MTU шляху");
+            });
+    connect(fragmenter, &DatagramFragmenter::reassemblyDropped, this, [=](int nodeId, bool timedOut)
+            {
+                if (timedOut)
+                    ui->textLog->append("xx [REASM] Вузол " + QString::number(nodeId) + " не зібрав дейтаграму за " +
+                                        QString::number(fragmenter->reassemblyTimeout()) + " с, фрагменти відкинуто");
+                else
+                    ui->textLog->append("xx [REASM] Вузол " + QString::number(nodeId) + " відкинув незібрану дейтаграму: вичерпано " +
+                                        QString::number(fragmenter->reassemblyMemory()) + " байт буфера");
+            });
+    connect(networkScene, &NetworkScene::routingTableRequested, this, &MainWindow::showRoutingTable);
+    connect(routingState, &RoutingState::published, this, &MainWindow::installForwardingTables);
+    connect(routingState, &RoutingState::published, this, &MainWindow::checkRecovery);
+
+    qRegisterMetaType<QList<int>>();
+    qRegisterMetaType<QList<QPointF>>();
+
     dataTimer = new QTimer(this);
     connect(dataTimer, &QTimer::timeout, this, &MainWindow::sendNextDataPacket);
 
@@ -47,13 +192,15 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(ui->rbAlgoHops, &QRadioButton::toggled, this, [=](bool checked)
             {
-                Dijkstra::useMinHops = checked;
+                routingState->setMinHops(checked);
             });
-    Dijkstra::useMinHops = ui->rbAlgoHops->isChecked();
+    routingState->setMinHops(ui->rbAlgoHops->isChecked());
 
     connect(ui->btnGenerate, &QPushButton::clicked, this, [=]()
             {
-                Network::generate(ui->graphicsView->scene());
+                stopAutoLayout();
+                quiesceTraffic();
+                Network::generate(ui->graphicsView->scene(), simulationSeed);
             });
 
     connect(ui->btnAddNode, &QPushButton::clicked, this, [=]()
@@ -131,301 +278,2813 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->btnChartService, &QPushButton::clicked, this, &MainWindow::showChartServiceTraffic);
     connect(ui->btnChartPackets, &QPushButton::clicked, this, &MainWindow::showChartPacketsCount);
     connect(ui->btnChartError, &QPushButton::clicked, this, &MainWindow::showChartErrorDependence);
+
+    QMenu *networkMenu = ui->menubar->addMenu("Мережа");
+    networkMenu->addAction("Відкрити топологію...", this, &MainWindow::loadTopology);
+    networkMenu->addAction("Зберегти топологію...", this, &MainWindow::saveTopology);
+    networkMenu->addAction("Імпорт (GraphML, список ребер, Rocketfuel)...", this, &MainWindow::importTopology);
+    networkMenu->addSeparator();
+    networkMenu->addAction("Генератор топології...", this, &MainWindow::showGeneratorDialog);
+    networkMenu->addAction("Авто-розкладка", this, &MainWindow::runAutoLayout);
+
+    QMenu *simulationMenu = ui->menubar->addMenu("Симуляція");
+    QAction *batchedAction = simulationMenu->addAction("Пакетна анімація (єдиний таймер)");
+    batchedAction->setCheckable(true);
+    batchedAction->setChecked(animator->isBatched());
+    connect(batchedAction, &QAction::toggled, this, [=](bool checked)
+            {
+                animator->setBatched(checked);
+            });
+    simulationMenu->addAction("Зерно генератора...", this, &MainWindow::editSimulationSeed);
+    simulationMenu->addSeparator();
+    simulationMenu->addAction("Навантаження з матриці трафіку...", this, &MainWindow::showWorkloadDialog);
+    simulationMenu->addAction("Зупинити навантаження", this, &MainWindow::stopWorkload);
+    simulationMenu->addSeparator();
+    simulationMenu->addAction("Розклад відмов...", this, &MainWindow::showFailureDialog);
+    simulationMenu->addAction("Відновити всі канали й вузли", this, &MainWindow::restoreAllFailures);
+    simulationMenu->addSeparator();
+    simulationMenu->addAction("Черги на каналах...", this, &MainWindow::showSchedulerDialog);
+    simulationMenu->addAction("Статистика черг каналів", this, &MainWindow::logQueueStats);
+    simulationMenu->addAction("Керування перевантаженням...", this, &MainWindow::showCongestionDialog);
+    simulationMenu->addAction("Конкуренція потоків через шлюзи...", this, &MainWindow::showFlowExperimentDialog);
+    simulationMenu->addAction("Експорт трасування вікна (CSV)...", this, &MainWindow::exportCwndTrace);
+    simulationMenu->addSeparator();
+    simulationMenu->addAction("MTU і фрагментація...", this, &MainWindow::showMtuDialog);
+    simulationMenu->addAction("Змішані MTU каналів...", this, &MainWindow::assignMixedMtus);
+    simulationMenu->addAction("Статистика фрагментації", this, &MainWindow::logFragmentationStats);
+    simulationMenu->addAction("Байти пакетів і CRC32C...", this, &MainWindow::showPayloadDialog);
+    simulationMenu->addAction("Вартість CRC32C і копіювання", this, &MainWindow::runChecksumBenchmark);
+    simulationMenu->addSeparator();
+    simulationMenu->addAction("Адаптивні вартості каналів...", this, &MainWindow::showAdaptiveDialog);
+    simulationMenu->addAction("Вимкнути адаптивні вартості", this, &MainWindow::stopAdaptiveRouting);
+    simulationMenu->addSeparator();
+    simulationMenu->addAction("Протокол стану каналів (LSA/SPF)...", this, &MainWindow::showLinkStateDialog);
+    simulationMenu->addAction("Порівняти з вектором відстаней...", this, &MainWindow::showProtocolComparisonDialog);
+    simulationMenu->addSeparator();
+    simulationMenu->addAction("Смуга віртуального каналу...", this, &MainWindow::showCircuitBandwidthDialog);
+    simulationMenu->addAction("Ємність мережі для віртуальних каналів...", this, &MainWindow::showCapacityDialog);
+
+    QMenu *chartsMenu = ui->menubar->addMenu("Графіки");
+    chartsMenu->addAction("Службовий трафік від MTU", this, &MainWindow::showChartServiceTraffic);
+    chartsMenu->addAction("Пакети від MTU", this, &MainWindow::showChartPacketsCount);
+    chartsMenu->addAction("Трафік від ймовірності помилок", this, &MainWindow::showChartErrorDependence);
+    chartsMenu->addSeparator();
+    chartsMenu->addAction("Живі графіки симуляції", this, &MainWindow::showLiveCharts);
 }
 
 MainWindow::~MainWindow()
 {
+    stopAutoLayout();
+
+    if (experimentCancelled) experimentCancelled->store(true);
+    experimentPool.waitForDone();
+
+    // Сцена видаляється пізніше і ще сповіщатиме про зміни топології, тож маршрутизацію знищуємо раніше
+    delete adaptive;
+    delete routing;
+    delete routingState;
+
     delete ui;
 }
 
-void MainWindow::setupTable()
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 {
-    QStringList headers;
-    headers << "From" << "To" << "Type" << "Time (ms)" << "Service (B)" << "Packets" << "Msg Size" << "Path" << "Delivered";
-    ui->tableResults->setColumnCount(headers.size());
-    ui->tableResults->setHorizontalHeaderLabels(headers);
-    ui->tableResults->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
-    ui->tableResults->horizontalHeader()->setStretchLastSection(true);
+    if (watched == ui->graphicsView->viewport() && event->type() == QEvent::Wheel)
+    {
+        QWheelEvent *wheel = static_cast<QWheelEvent*>(event);
+        qreal factor = (wheel->angleDelta().y() > 0) ? 1.15 : 1.0 / 1.15;
+        ui->graphicsView->scale(factor, factor);
+        return true;
+    }
+    return QMainWindow::eventFilter(watched, event);
 }
 
-void MainWindow::startSimulation()
+void MainWindow::editSimulationSeed()
 {
-    ui->textLog->clear();
-    ui->textLog->append(QDateTime::currentDateTime().toString("hh:mm:ss") + " [INFO] Старт симуляції...");
+    bool ok;
+    int seed = QInputDialog::getInt(this, "Зерно генератора", "Зерно для втрат і генерації мережі:",
+                                    (int)qMin<quint64>(simulationSeed, INT_MAX), 0, INT_MAX, 1, &ok);
+    if (ok) simulationSeed = seed;
+}
 
-    int sourceID = ui->spinSourceID->value();
-    int destID = ui->spinTargetID->value();
-    currentMsgSize = ui->spinMsgSize->value();
-    currentPacketSize = ui->spinPacketSize->value();
-    currentErrorRate = ui->spinErrorProb->value();
-    isVirtualMode = ui->rbVirtual->isChecked();
+void MainWindow::showWorkloadDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Навантаження з матриці трафіку");
+
+    QComboBox *comboDemand = new QComboBox();
+    comboDemand->addItem("Гравітаційна модель", GravityDemand);
+    comboDemand->addItem("Рівномірна", UniformDemand);
+
+    QComboBox *comboArrivals = new QComboBox();
+    comboArrivals->addItem("Пуассонівський потік", PoissonArrivals);
+    comboArrivals->addItem("On/off", OnOffArrivals);
+
+    QDoubleSpinBox *spinPeak = new QDoubleSpinBox();
+    spinPeak->setRange(0.1, 100000.0);
+    spinPeak->setValue(20.0);
+    spinPeak->setSuffix(" потоків/с");
+
+    QSpinBox *spinLoad = new QSpinBox();
+    spinLoad->setRange(1, 200);
+    spinLoad->setValue(70);
+    spinLoad->setSuffix(" %");
+
+    QDoubleSpinBox *spinAlpha = new QDoubleSpinBox();
+    spinAlpha->setRange(1.01, 5.0);
+    spinAlpha->setSingleStep(0.1);
+    spinAlpha->setValue(1.2);
+
+    QSpinBox *spinMinSize = new QSpinBox();
+    spinMinSize->setRange(1, 10000000);
+    spinMinSize->setValue(1000);
+    spinMinSize->setSuffix(" байт");
+
+    QSpinBox *spinDuration = new QSpinBox();
+    spinDuration->setRange(1, 86400);
+    spinDuration->setValue(30);
+    spinDuration->setSuffix(" с");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Матриця попиту:", comboDemand);
+    form->addRow("Надходження потоків:", comboArrivals);
+    form->addRow("Пікова інтенсивність:", spinPeak);
+    form->addRow("Навантаження:", spinLoad);
+    form->addRow("Парето α (розміри):", spinAlpha);
+    form->addRow("Мінімальний потік:", spinMinSize);
+    form->addRow("Тривалість:", spinDuration);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    WorkloadParams params;
+    params.demand = (DemandModel)comboDemand->currentData().toInt();
+    params.arrivals = (ArrivalProcess)comboArrivals->currentData().toInt();
+    params.peakRate = spinPeak->value();
+    params.load = spinLoad->value() / 100.0;
+    params.paretoAlpha = spinAlpha->value();
+    params.minFlowBytes = spinMinSize->value();
+    params.maxFlowBytes = qMax(params.minFlowBytes, params.maxFlowBytes);
+    params.duration = spinDuration->value();
+    params.seed = simulationSeed;
+
+    startWorkload(params);
+}
 
-    Node *startNode = nullptr;
-    QList<Node*> allNodes;
-    foreach (QGraphicsItem *item, ui->graphicsView->scene()->items())
+void MainWindow::startWorkload(const WorkloadParams& params)
+{
+    if (ui->spinPacketSize->value() <= packetHeaderBytes)
     {
-        Node *n = dynamic_cast<Node*>(item);
-        if (n)
-        {
-            allNodes.append(n);
-            if (n->getId() == sourceID) startNode = n;
-        }
+        QMessageBox::warning(this, "Помилка", "MTU замалий!");
+        return;
     }
 
-    if (!startNode)
+    // Пакети попереднього прогону завершуються й зараховуються йому, перш ніж лічильники обнуляться
+    quiesceTraffic();
+
+    currentPacketSize = ui->spinPacketSize->value();
+    currentErrorRate = ui->spinErrorProb->value();
+
+    workload = std::make_unique<WorkloadGenerator>(Network::capture(networkScene), params);
+    hasPendingFlow = workload->next(pendingFlow);
+    activeFlows.clear();
+    workloadRun++;
+    workloadLoad = params.load;
+    workloadFlows = workloadPackets = workloadDelivered = workloadLost = workloadBytes = workloadLatencyMs = 0;
+
+    QSet<Edge*> links;
+    for (Node *node : networkScene->nodes())
+        for (Edge *edge : node->edges())
+            links.insert(edge);
+    for (Edge *edge : links)
+        edge->lossModel().reseed(simulationSeed);
+
+    ui->textLog->append("=== Навантаження: " + QString::number(params.load * 100, 'f', 0) + "% від " +
+                        QString::number(params.peakRate) + " потоків/с, " + QString::number(workload->regionCount()) +
+                        " регіонів, середній потік " + QString::number(workload->meanFlowBytes(), 'f', 0) +
+                        " байт, зерно " + QString::number(params.seed) + " ===");
+
+    workloadClock.start();
+    workloadTimer->start();
+}
+
+void MainWindow::stopWorkload()
+{
+    if (!workload) return;
+
+    workloadTimer->stop();
+    hasPendingFlow = false;
+    activeFlows.clear();
+    finishWorkloadIfDone();
+}
+
+// Кожен активний потік віддає по одному пакету за такт; нові потоки з'являються, коли настає їхній час
+void MainWindow::workloadTick()
+{
+    double now = workloadClock.elapsed() / 1000.0;
+
+    while (hasPendingFlow && pendingFlow.start <= now)
     {
-        ui->textLog->append("[ERROR] Стартовий вузол не знайдено!");
-        return;
-    }
+        // Клас потоку - функція зерна й номера потоку, тож прогін з тими самими параметрами повторюється
+        CounterRng rng(simulationSeed, 0x5443, pendingFlow.id);
+        int trafficClass = rng.uniform() * 100 < interactiveShare ? InteractiveClass : BulkClass;
 
-    std::vector<RoutingEntry> table;
-    if (Dijkstra::useMinHops)
-        table = Dijkstra::calculateMinHops(startNode, allNodes);
-    else
-        table = Dijkstra::calculate(startNode, allNodes);
+        activeFlows.push_back({pendingFlow, pendingFlow.bytes, trafficClass});
+        workloadFlows++;
+        hasPendingFlow = workload->next(pendingFlow);
+    }
 
-    currentPath.clear();
-    int pathCost = 0;
+    int maxPayload = currentPacketSize - packetHeaderBytes;
+    int run = workloadRun;
 
-    for (const auto& entry : table)
+    for (size_t i = 0; i < activeFlows.size();)
     {
-        if (entry.destinationID == destID)
+        ActiveFlow& active = activeFlows[i];
+        int payload = qMin(maxPayload, active.bytesLeft);
+        qint64 sentAt = workloadClock.elapsed();
+
+        bool sent = sendDatagram(active.flow.id, payload, active.flow.sourceId, active.flow.destId, [=](bool delivered)
+                                 {
+                                     if (run != workloadRun) return;
+
+                                     if (delivered)
+                                     {
+                                         workloadDelivered++;
+                                         workloadBytes += payload;
+                                         workloadLatencyMs += workloadClock.elapsed() - sentAt;
+                                     }
+                                     else
+                                     {
+                                         workloadLost++;
+                                     }
+                                     finishWorkloadIfDone();
+                                 }, active.trafficClass);
+
+        if (sent) workloadPackets++;
+        active.bytesLeft -= payload;
+
+        if (!sent || active.bytesLeft <= 0)
+        {
+            active = activeFlows.back();
+            activeFlows.pop_back();
+        }
+        else
         {
-            currentPath = entry.fullPath;
-            pathCost = entry.totalCost;
-            break;
+            ++i;
         }
     }
 
-    if (currentPath.size() < 2)
+    if (!hasPendingFlow && activeFlows.empty())
     {
-        ui->textLog->append("[ERROR] Шлях не знайдено!");
-        return;
+        workloadTimer->stop();
+        finishWorkloadIfDone();
     }
+}
 
-    int headerSize = 40;
-    if (currentPacketSize <= headerSize)
+void MainWindow::finishWorkloadIfDone()
+{
+    if (!workload || workloadTimer->isActive()) return;
+    if (workloadDelivered + workloadLost < workloadPackets) return;
+
+    double seconds = qMax<qint64>(1, workloadClock.elapsed()) / 1000.0;
+
+    ui->textLog->append("--------------------------------------------------");
+    ui->textLog->append("[FINISH] Навантаження " + QString::number(workloadLoad * 100, 'f', 0) + "% завершено:");
+    ui->textLog->append("  Потоків: " + QString::number(workloadFlows) + ", пакетів: " + QString::number(workloadPackets));
+    ui->textLog->append("  Доставлено: " + QString::number(workloadDelivered) + ", втрачено: " + QString::number(workloadLost) +
+                        " (" + QString::number(workloadPackets ? 100.0 * workloadLost / workloadPackets : 0.0, 'f', 2) + "%)");
+    ui->textLog->append("  Корисна пропускна здатність: " + QString::number(workloadBytes / seconds, 'f', 0) + " байт/с");
+    ui->textLog->append("  Середня затримка доставки: " +
+                        QString::number(workloadDelivered ? (double)workloadLatencyMs / workloadDelivered : 0.0, 'f', 0) + " мс");
+    if (adaptive->isActive()) logAdaptiveStats();
+    if (linkQueuing) logQueueStats();
+    if (fragmenter->stats().datagrams || fragmenter->stats().tooBig) logFragmentationStats();
+
+    workload.reset();
+}
+
+void MainWindow::showFailureDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Розклад відмов");
+
+    QPlainTextEdit *editSchedule = new QPlainTextEdit();
+    editSchedule->setPlaceholderText("5 link 1 2 down\n12 link 1 2 up\n8 node 4 down");
+    editSchedule->setPlainText(failureScheduleText);
+
+    QComboBox *comboMode = new QComboBox();
+    comboMode->addItem("Повна переконвергенція", ReconvergenceRecovery);
+    comboMode->addItem("Швидкий обхід (LFA)", FastRerouteRecovery);
+    comboMode->setCurrentIndex(comboMode->findData(recoveryMode));
+
+    QSpinBox *spinDelay = new QSpinBox();
+    spinDelay->setRange(0, 60000);
+    spinDelay->setValue(routingState->rebuildDelay());
+    spinDelay->setSuffix(" мс");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Події (с, link/node, id, down/up):", editSchedule);
+    form->addRow("Відновлення:", comboMode);
+    form->addRow("Затримка SPF:", spinDelay);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    std::vector<FailureEvent> events;
+    QString error;
+    if (!FailureSchedule::parse(editSchedule->toPlainText(), events, &error))
     {
-        QMessageBox::warning(this, "Помилка", "MTU замалий!");
+        QMessageBox::warning(this, "Помилка", error);
         return;
     }
 
-    int maxPayload = currentPacketSize - headerSize;
-    totalPacketsToSend = (currentMsgSize + maxPayload - 1) / maxPayload;
+    failureScheduleText = editSchedule->toPlainText();
+    recoveryMode = (RecoveryMode)comboMode->currentData().toInt();
+    routingState->setRebuildDelay(spinDelay->value());
 
-    calculatedServiceTraffic = totalPacketsToSend * headerSize;
-    if (isVirtualMode)
-        calculatedServiceTraffic += (3 * headerSize);
+    startFailureSchedule(events);
+}
 
-    int totalTraffic = currentMsgSize + calculatedServiceTraffic;
+void MainWindow::startFailureSchedule(const std::vector<FailureEvent>& events)
+{
+    int run = ++failureRun;
+    outages.clear();
+    failureClock.start();
 
-    int latencyPerHop = 10;
-    int totalHops = currentPath.size() - 1;
-    double baseTime = (double)totalTraffic / 10.0;
-    calculatedTime = baseTime + (totalHops * latencyPerHop);
+    ui->textLog->append("=== Розклад відмов: " + QString::number(events.size()) + " подій, " +
+                        (recoveryMode == FastRerouteRecovery ? "швидкий обхід (LFA)" : "повна переконвергенція") +
+                        ", затримка SPF " + QString::number(routingState->rebuildDelay()) + " мс ===");
 
-    if (isVirtualMode) calculatedTime *= 1.2;
+    for (const FailureEvent& event : events)
+    {
+        QTimer::singleShot(qRound(event.time * 1000), this, [=]()
+                           {
+                               if (run == failureRun) applyFailureEvent(event);
+                           });
+    }
+}
 
-    ui->textLog->append("--------------------------------------------------");
-    ui->textLog->append("МАРШРУТ: Вартість = " + QString::number(pathCost));
+void MainWindow::applyFailureEvent(const FailureEvent& event)
+{
+    Node *a = networkScene->node(event.a);
+    Node *b = event.nodeEvent ? nullptr : networkScene->node(event.b);
+    Edge *edge = a && b ? a->edgeTo(b) : nullptr;
 
-    QString pathStr = "Шлях: ";
-    for (size_t i = 0; i < currentPath.size(); ++i)
+    if (!a || (!event.nodeEvent && !edge))
     {
-        pathStr += QString::number(currentPath[i]);
-        if (i < currentPath.size() - 1) pathStr += " -> ";
+        ui->textLog->append("xx [FAIL] Пропущено: " + FailureSchedule::describe(event) + " - немає на сцені");
+        return;
     }
-    ui->textLog->append(pathStr);
 
-    ui->textLog->append("--------------------------------------------------");
-    ui->textLog->append("ПАРАМЕТРИ ПЕРЕДАЧІ:");
-    ui->textLog->append("  MTU (Розмір пакету): " + QString::number(currentPacketSize) + " байт");
-    ui->textLog->append("  Корисна ємність (Payload): " + QString::number(maxPayload) + " байт");
-    ui->textLog->append("--------------------------------------------------");
-    ui->textLog->append("ПРОГНОЗ ТРАФІКУ:");
-    ui->textLog->append("  Всього пакетів даних: " + QString::number(totalPacketsToSend));
-    ui->textLog->append("  Службовий трафік: " + QString::number(calculatedServiceTraffic) + " байт");
-    ui->textLog->append("  Розрахунковий час: " + QString::number(calculatedTime) + " мс");
-    ui->textLog->append("--------------------------------------------------");
+    if (event.nodeEvent ? a->isUp() == event.up : edge->isUp() == event.up) return;
 
-    packetsSentCount = 0;
-    packetsDeliveredCount = 0;
+    Outage outage;
+    outage.what = FailureSchedule::describe(event);
+    outage.affected = 0;
+    outage.covered = 0;
 
-    if (isVirtualMode)
+    // Покриття LFA рахується за таблицями, які діяли в момент відмови
+    if (!event.up)
     {
-        ui->textLog->append("=== [Фаза 1] Встановлення з'єднання (Handshake) ===");
-        stepHandshakeReq();
+        if (event.nodeEvent)
+        {
+            for (Edge *link : a->edges())
+                countProtected(link->sourceNode() == a ? link->destNode() : link->sourceNode(), a, true, outage.affected, outage.covered);
+        }
+        else
+        {
+            countProtected(a, b, false, outage.affected, outage.covered);
+            countProtected(b, a, false, outage.affected, outage.covered);
+        }
     }
+
+    if (event.nodeEvent)
+        a->setUp(event.up);
     else
-    {
-        ui->textLog->append("=== [Фаза 1] Дейтаграмний режим ===");
-        startDataTransmission();
-    }
-}
+        edge->setUp(event.up);
 
-void MainWindow::stepHandshakeReq()
-{
-    sendSinglePacket(0, 0, CONN_REQ, currentPath);
+    ui->textLog->append("!! [FAIL] t=" + QString::number(failureClock.elapsed() / 1000.0, 'f', 2) + " с: " + outage.what);
+
+    if (event.up) return;
+
+    if (recoveryMode == FastRerouteRecovery)
+        ui->textLog->append("   LFA захищає " + QString::number(outage.covered) + " з " + QString::number(outage.affected) +
+                            " напрямків через відмову");
+
+    outage.failedAt = failureClock.elapsed();
+    outage.topologyVersion = networkScene->topologyVersion();
+    outage.lostBefore = outageLost;
+    outage.reroutesBefore = fastReroutes;
+    outages.push_back(outage);
 }
 
-void MainWindow::stepHandshakeAck()
+// Скільки напрямків вузла from ідуть першим кроком через to і скільки з них мають запасний крок
+void MainWindow::countProtected(Node *from, Node *to, bool excludeTarget, int& affected, int& covered)
 {
-    std::vector<int> pathBack = currentPath;
-    std::reverse(pathBack.begin(), pathBack.end());
-    sendSinglePacket(0, 0, CONN_ACK, pathBack);
+    std::shared_ptr<const RoutingResult> fib = from ? from->forwardingTable() : nullptr;
+    if (!fib || !to) return;
+
+    int target = fib->snapshot->indexOf(to->getId());
+    if (target < 0) return;
+
+    for (int d = 0; d < (int)fib->firstHop.size(); ++d)
+    {
+        if (fib->firstHop[d] != target || (excludeTarget && d == target)) continue;
+
+        affected++;
+        if (!fib->backupHop.empty() && fib->backupHop[d] >= 0 && fib->backupHop[d] != target) covered++;
+    }
 }
 
-void MainWindow::startDataTransmission()
+void MainWindow::checkRecovery()
 {
-    if (isVirtualMode)
-        ui->textLog->append("=== [Фаза 2] Передача даних (Потік) ===");
+    std::shared_ptr<const RoutingGeneration> generation = routingState->current();
+    if (!generation || outages.empty()) return;
 
-    dataTimer->start(1000);
-    sendNextDataPacket();
+    for (size_t i = 0; i < outages.size();)
+    {
+        const Outage& outage = outages[i];
+        if (generation->topologyVersion < outage.topologyVersion)
+        {
+            ++i;
+            continue;
+        }
+
+        ui->textLog->append("++ [RECOVER] " + outage.what + ": маршрути переконвергували за " +
+                            QString::number(failureClock.elapsed() - outage.failedAt) + " мс");
+        if (recoveryMode == FastRerouteRecovery)
+            ui->textLog->append("   Захищені LFA напрямки (" + QString::number(outage.covered) + " з " +
+                                QString::number(outage.affected) + ") відновились одразу, обхідних кроків: " +
+                                QString::number(fastReroutes - outage.reroutesBefore));
+        ui->textLog->append("   Втрачено під час збіжності: " + QString::number(outageLost - outage.lostBefore) + " пакетів");
+
+        outages.erase(outages.begin() + i);
+    }
 }
 
-void MainWindow::sendNextDataPacket()
+void MainWindow::restoreAllFailures()
 {
-    if (packetsSentCount < totalPacketsToSend)
-    {
-        int headerSize = 40;
-        int maxPayload = currentPacketSize - headerSize;
-        int currentPayload = (packetsSentCount == totalPacketsToSend - 1) ? (currentMsgSize - packetsSentCount * maxPayload) : maxPayload;
+    failureRun++;
+    outages.clear();
 
-        sendSinglePacket(packetsSentCount + 1, currentPayload, DATA, currentPath);
-        packetsSentCount++;
+    QSet<Edge*> links;
+    for (Node *node : networkScene->nodes())
+    {
+        node->setUp(true);
+        for (Edge *edge : node->edges())
+            links.insert(edge);
     }
-    else
+    for (Edge *edge : links)
+        edge->setUp(true);
+
+    ui->textLog->append("=== Усі канали й вузли відновлено ===");
+}
+
+void MainWindow::showSchedulerDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Черги на каналах");
+
+    QComboBox *comboDiscipline = new QComboBox();
+    comboDiscipline->addItem("Без черг (миттєва передача)", -1);
+    comboDiscipline->addItem("FIFO", FifoScheduling);
+    comboDiscipline->addItem("Строгий пріоритет", StrictPriorityScheduling);
+    comboDiscipline->addItem("Дефіцитний круговий обхід (DRR)", DeficitRoundRobinScheduling);
+    comboDiscipline->setCurrentIndex(linkQueuing ? comboDiscipline->findData(schedulerParams.discipline) : 0);
+
+    // За ємностей за замовчуванням канали не перевантажити анімованим трафіком; масштаб дозволяє відтворити голодування
+    QDoubleSpinBox *spinRateScale = new QDoubleSpinBox();
+    spinRateScale->setRange(0.001, 100);
+    spinRateScale->setDecimals(3);
+    spinRateScale->setValue(linkRateScale * 100);
+    spinRateScale->setSuffix(" % ємності");
+
+    QSpinBox *spinLimit = new QSpinBox();
+    spinLimit->setRange(1, 100000);
+    spinLimit->setValue(schedulerParams.queueLimit);
+    spinLimit->setSuffix(" пакетів");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Дисципліна:", comboDiscipline);
+    form->addRow("Швидкість каналу:", spinRateScale);
+    form->addRow("Черга класу:", spinLimit);
+
+    static const char *classNames[trafficClassCount] = {"керуючі", "інтерактивні", "масові"};
+    QSpinBox *spinQuantum[trafficClassCount];
+    for (int c = 0; c < trafficClassCount; ++c)
     {
-        dataTimer->stop();
+        spinQuantum[c] = new QSpinBox();
+        spinQuantum[c]->setRange(1, 1000000);
+        spinQuantum[c]->setValue(schedulerParams.quantum[c]);
+        spinQuantum[c]->setSuffix(" байт");
+        form->addRow(QString("Квант DRR, ") + classNames[c] + ":", spinQuantum[c]);
     }
+
+    QSpinBox *spinShare = new QSpinBox();
+    spinShare->setRange(0, 100);
+    spinShare->setValue(interactiveShare);
+    spinShare->setSuffix(" %");
+    form->addRow("Інтерактивні потоки навантаження:", spinShare);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    resetLinkQueues();
+
+    int discipline = comboDiscipline->currentData().toInt();
+    linkQueuing = discipline >= 0;
+    if (linkQueuing) schedulerParams.discipline = (SchedulingDiscipline)discipline;
+    schedulerParams.queueLimit = spinLimit->value();
+    for (int c = 0; c < trafficClassCount; ++c)
+        schedulerParams.quantum[c] = spinQuantum[c]->value();
+    interactiveShare = spinShare->value();
+    linkRateScale = spinRateScale->value() / 100;
+
+    ui->textLog->append("=== Черги на каналах: " + comboDiscipline->currentText() +
+                        (linkQueuing ? ", швидкість " + QString::number(linkRateScale * 100) + "% ємності каналу, " +
+                                       QString::number(schedulerParams.queueLimit) + " пакетів на клас" : QString()) + " ===");
 }
 
-void MainWindow::checkCompletion()
+void MainWindow::logQueueStats()
 {
-    if (packetsDeliveredCount >= totalPacketsToSend)
+    static const char *classNames[trafficClassCount] = {"Керуючі", "Інтерактивні", "Масові"};
+
+    ClassStats total[trafficClassCount];
+    quint64 worstLink = 0;
+    qint64 worstDrops = 0;
+
+    for (const auto& entry : linkQueues)
     {
-        if (isVirtualMode)
+        qint64 drops = 0;
+        for (int c = 0; c < trafficClassCount; ++c)
         {
-            ui->textLog->append("=== [Фаза 3] Розрив з'єднання ===");
-            stepDisconnect();
+            total[c].add(entry.second.scheduler.stats(c));
+            drops += entry.second.scheduler.stats(c).dropped;
         }
-        else
+
+        if (drops > worstDrops)
         {
-            ui->textLog->append("--------------------------------------------------");
-            ui->textLog->append("[FINISH] Передачу завершено.");
-            logToTable(true);
+            worstDrops = drops;
+            worstLink = entry.first;
         }
     }
+
+    ui->textLog->append("=== Черги каналів: " + QString::number(linkQueues.size()) + " активних напрямків ===");
+    for (int c = 0; c < trafficClassCount; ++c)
+    {
+        const ClassStats& stats = total[c];
+        qint64 offered = stats.enqueued + stats.dropped;
+
+        ui->textLog->append(QString("  ") + classNames[c] + ": передано " + QString::number(stats.sent) + ", відкинуто " +
+                            QString::number(stats.dropped) + " (" +
+                            QString::number(offered ? 100.0 * stats.dropped / offered : 0.0, 'f', 2) + "%), очікування " +
+                            QString::number(stats.sent ? stats.delaySum * 1000 / stats.sent : 0.0, 'f', 1) + " мс (макс. " +
+                            QString::number(stats.maxDelay * 1000, 'f', 1) + " мс), найдовша черга " + QString::number(stats.maxDepth));
+    }
+
+    if (worstDrops > 0)
+        ui->textLog->append("  Найбільше відкидань на каналі " + QString::number((int)(worstLink >> 32)) + " -> " +
+                            QString::number((int)(quint32)worstLink) + ": " + QString::number(worstDrops));
 }
 
-void MainWindow::stepDisconnect()
+void MainWindow::showCongestionDialog()
 {
-    sendSinglePacket(0, 0, DISCONNECT, currentPath);
+    QDialog dialog(this);
+    dialog.setWindowTitle("Керування перевантаженням");
+
+    QCheckBox *checkLive = new QCheckBox("Вікно для віртуального каналу");
+    checkLive->setChecked(congestionControl);
+
+    QComboBox *comboAlgorithm = new QComboBox();
+    comboAlgorithm->addItem("AIMD за втратами (Reno)", LossBasedControl);
+    comboAlgorithm->addItem("За затримкою (Vegas)", DelayBasedControl);
+    comboAlgorithm->setCurrentIndex(comboAlgorithm->findData(congestionParams.algorithm));
+
+    QCheckBox *checkEcn = new QCheckBox("Реагувати на ECN");
+    checkEcn->setChecked(congestionParams.ecn);
+
+    QSpinBox *spinEcn = new QSpinBox();
+    spinEcn->setRange(0, 100000);
+    spinEcn->setValue(ecnThreshold);
+    spinEcn->setSuffix(" пакетів");
+    spinEcn->setSpecialValueText("без позначок");
+
+    QDoubleSpinBox *spinThreshold = new QDoubleSpinBox();
+    spinThreshold->setRange(2, 100000);
+    spinThreshold->setValue(congestionParams.initialThreshold);
+
+    QDoubleSpinBox *spinIncrease = new QDoubleSpinBox();
+    spinIncrease->setRange(0.1, 100);
+    spinIncrease->setValue(congestionParams.additiveIncrease);
+    spinIncrease->setSuffix(" пакетів/RTT");
+
+    QDoubleSpinBox *spinDecrease = new QDoubleSpinBox();
+    spinDecrease->setRange(0.05, 0.95);
+    spinDecrease->setSingleStep(0.05);
+    spinDecrease->setValue(congestionParams.multiplicativeDecrease);
+
+    QDoubleSpinBox *spinAlpha = new QDoubleSpinBox();
+    spinAlpha->setRange(0, 1000);
+    spinAlpha->setValue(congestionParams.delayAlpha);
+
+    QDoubleSpinBox *spinBeta = new QDoubleSpinBox();
+    spinBeta->setRange(0, 1000);
+    spinBeta->setValue(congestionParams.delayBeta);
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow(checkLive);
+    form->addRow("Алгоритм:", comboAlgorithm);
+    form->addRow(checkEcn);
+    form->addRow("Поріг позначки ECN у черзі:", spinEcn);
+    form->addRow("Початковий поріг повільного старту:", spinThreshold);
+    form->addRow("Адитивне збільшення:", spinIncrease);
+    form->addRow("Мультиплікативне зменшення:", spinDecrease);
+    form->addRow("Vegas α (пакетів у черзі):", spinAlpha);
+    form->addRow("Vegas β (пакетів у черзі):", spinBeta);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    congestionControl = checkLive->isChecked();
+    congestionParams.algorithm = (CongestionAlgorithm)comboAlgorithm->currentData().toInt();
+    congestionParams.ecn = checkEcn->isChecked();
+    congestionParams.initialThreshold = spinThreshold->value();
+    congestionParams.additiveIncrease = spinIncrease->value();
+    congestionParams.multiplicativeDecrease = spinDecrease->value();
+    congestionParams.delayAlpha = qMin(spinAlpha->value(), spinBeta->value());
+    congestionParams.delayBeta = qMax(spinAlpha->value(), spinBeta->value());
+    ecnThreshold = spinEcn->value();
 }
 
-void MainWindow::logToTable(bool success)
+void MainWindow::showFlowExperimentDialog()
 {
-    int row = ui->tableResults->rowCount();
-    ui->tableResults->insertRow(row);
+    QDialog dialog(this);
+    dialog.setWindowTitle("Конкуренція потоків через шлюзи");
+
+    FlowSimulationParams defaults;
+
+    QSpinBox *spinFlows = new QSpinBox();
+    spinFlows->setRange(1, FlowSimulation::maxFlows);
+    spinFlows->setValue(defaults.flows);
+
+    QCheckBox *checkCross = new QCheckBox("Лише між регіонами");
+    checkCross->setChecked(defaults.crossRegion);
+
+    QSpinBox *spinQueue = new QSpinBox();
+    spinQueue->setRange(1, 100000);
+    spinQueue->setValue(defaults.queueLimit);
+    spinQueue->setSuffix(" пакетів");
+
+    QSpinBox *spinPacket = new QSpinBox();
+    spinPacket->setRange(64, 65535);
+    spinPacket->setValue(defaults.packetBytes);
+    spinPacket->setSuffix(" байт");
+
+    QDoubleSpinBox *spinDelay = new QDoubleSpinBox();
+    spinDelay->setRange(0.0, 1000.0);
+    spinDelay->setValue(defaults.linkDelay * 1000);
+    spinDelay->setSuffix(" мс");
+
+    QDoubleSpinBox *spinDuration = new QDoubleSpinBox();
+    spinDuration->setRange(0.1, 3600.0);
+    spinDuration->setValue(defaults.duration);
+    spinDuration->setSuffix(" с");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Потоків:", spinFlows);
+    form->addRow(checkCross);
+    form->addRow("Черга каналу:", spinQueue);
+    form->addRow("Розмір пакета:", spinPacket);
+    form->addRow("Затримка каналу:", spinDelay);
+    form->addRow("Тривалість:", spinDuration);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    FlowSimulationParams params;
+    params.congestion = congestionParams;
+    params.minHops = routingState->minHops();
+    params.flows = spinFlows->value();
+    params.crossRegion = checkCross->isChecked();
+    params.queueLimit = spinQueue->value();
+    params.ecnThreshold = ecnThreshold;
+    params.packetBytes = spinPacket->value();
+    params.linkDelay = spinDelay->value() / 1000.0;
+    params.duration = spinDuration->value();
+    params.seed = simulationSeed;
+
+    runFlowExperiment(params);
+}
 
-    QString pathStr;
-    for (size_t i = 0; i < currentPath.size(); ++i)
+void MainWindow::runFlowExperiment(const FlowSimulationParams& params)
+{
+    Topology topology = Network::capture(networkScene, true);
+    if (topology.nodes.size() < 2) return;
+
+    QString title = "Потоки з керуванням перевантаженням: " + QString::number(params.flows) + " потоків, " +
+                    (params.congestion.algorithm == DelayBasedControl ? "Vegas" : "Reno") +
+                    (params.congestion.ecn && params.ecnThreshold > 0 ? " + ECN" : "") + ", черга " +
+                    QString::number(params.queueLimit) + " пакетів, " + QString::number(params.duration) + " с";
+
+    startExperiment("Моделювання потоків...", [=](const std::atomic<bool> *cancelled)
+                    {
+                        FlowSimulation simulation(topology, params);
+                        auto report = std::make_shared<FlowSimulationReport>(simulation.run(cancelled));
+
+                        return std::function<void()>([=]()
+                                                     {
+                                                         cwndTrace = report->trace;
+
+                                                         ui->textLog->append("=== " + title + " ===");
+                                                         if (!report->completed) ui->textLog->append("  [WARN] Моделювання скасовано");
+
+                                                         double minGoodput = -1;
+                                                         double maxGoodput = 0;
+                                                         int unreachable = 0;
+                                                         qint64 reductions = 0;
+                                                         qint64 timeouts = 0;
+                                                         for (const FlowResult& flow : report->flows)
+                                                         {
+                                                             if (!flow.hops)
+                                                             {
+                                                                 unreachable++;
+                                                                 continue;
+                                                             }
+                                                             minGoodput = minGoodput < 0 ? flow.goodput : qMin(minGoodput, flow.goodput);
+                                                             maxGoodput = qMax(maxGoodput, flow.goodput);
+                                                             reductions += flow.reductions;
+                                                             timeouts += flow.timeouts;
+                                                         }
+
+                                                         ui->textLog->append("  Сумарний goodput: " + QString::number(report->aggregateGoodput / 1000, 'f', 1) +
+                                                                             " КБ/с, на потік від " + QString::number(qMax(0.0, minGoodput) / 1000, 'f', 1) +
+                                                                             " до " + QString::number(maxGoodput / 1000, 'f', 1) + " КБ/с");
+                                                         ui->textLog->append("  Справедливість (Джейн): " + QString::number(report->fairness, 'f', 3) +
+                                                                             ", корисних передач: " + QString::number(report->efficiency * 100, 'f', 1) + "%");
+                                                         ui->textLog->append("  Відкинуто в чергах: " + QString::number(report->drops) + ", позначено ECN: " +
+                                                                             QString::number(report->marks) + ", середнє очікування в черзі " +
+                                                                             QString::number(report->meanQueueDelay * 1000, 'f', 2) + " мс");
+                                                         ui->textLog->append("  Зменшень вікна: " + QString::number(reductions) + ", таймаутів: " +
+                                                                             QString::number(timeouts));
+
+                                                         if (report->busiestLink >= 0)
+                                                         {
+                                                             const TopologyEdge& e = topology.edges[report->busiestLink];
+                                                             ui->textLog->append("  Найзавантаженіший канал " + QString::number(topology.nodes[e.source].id) + " - " +
+                                                                                 QString::number(topology.nodes[e.dest].id) + ": " +
+                                                                                 QString::number(report->busiestUtilization * 100, 'f', 1) + "%");
+                                                         }
+                                                         if (unreachable)
+                                                             ui->textLog->append("  Потоків без шляху: " + QString::number(unreachable));
+                                                         ui->textLog->append("  Точок трасування вікна: " + QString::number(report->trace.size()));
+                                                     });
+                    });
+}
+
+void MainWindow::exportCwndTrace()
+{
+    if (cwndTrace.empty())
     {
-        pathStr += QString::number(currentPath[i]);
-        if (i < currentPath.size() - 1) pathStr += "->";
+        QMessageBox::information(this, "Трасування вікна",
+                                 "Трасування порожнє: запустіть віртуальний канал з керуванням перевантаженням або експеримент з потоками");
+        return;
     }
 
-    ui->tableResults->setItem(row, 0, new QTableWidgetItem(QString::number(ui->spinSourceID->value())));
-    ui->tableResults->setItem(row, 1, new QTableWidgetItem(QString::number(ui->spinTargetID->value())));
-    ui->tableResults->setItem(row, 2, new QTableWidgetItem(isVirtualMode ? "Virtual" : "Datagram"));
-    ui->tableResults->setItem(row, 3, new QTableWidgetItem(QString::number(calculatedTime, 'f', 2)));
-    ui->tableResults->setItem(row, 4, new QTableWidgetItem(QString::number(calculatedServiceTraffic)));
-    ui->tableResults->setItem(row, 5, new QTableWidgetItem(QString::number(totalPacketsToSend)));
-    ui->tableResults->setItem(row, 6, new QTableWidgetItem(QString::number(currentMsgSize)));
-    ui->tableResults->setItem(row, 7, new QTableWidgetItem(pathStr));
+    QString path = QFileDialog::getSaveFileName(this, "Експорт трасування вікна", QString(), "CSV (*.csv)");
+    if (path.isEmpty()) return;
 
-    QTableWidgetItem *statusItem = new QTableWidgetItem(success ? "Yes" : "No");
-    if (!success) statusItem->setBackground(Qt::red);
-    ui->tableResults->setItem(row, 8, statusItem);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        QMessageBox::warning(this, "Помилка", "Не вдалося записати файл: " + file.errorString());
+        return;
+    }
+
+    QTextStream out(&file);
+    out << "time_s,flow,cwnd,ssthresh,srtt_ms\n";
+    for (const CwndSample& sample : cwndTrace)
+        out << QString::number(sample.time, 'f', 6) << ',' << sample.flow << ',' << QString::number(sample.window, 'f', 3) << ','
+            << QString::number(sample.threshold, 'f', 3) << ',' << QString::number(sample.rtt * 1000, 'f', 3) << '\n';
+
+    ui->textLog->append("[INFO] Трасування вікна збережено: " + path + " (" + QString::number(cwndTrace.size()) + " точок)");
 }
 
-void MainWindow::sendSinglePacket(int id, int size, PacketType type, std::vector<int> path, bool isRetransmission)
+void MainWindow::showMtuDialog()
 {
-    if (isRetransmission)
+    QDialog dialog(this);
+    dialog.setWindowTitle("MTU і фрагментація");
+
+    QComboBox *comboMode = new QComboBox();
+    comboMode->addItem("Фрагментація в мережі (IPv4)", FragmentInNetwork);
+    comboMode->addItem("Пошук MTU шляху (PMTUD, IPv6)", PathMtuDiscovery);
+    comboMode->setCurrentIndex(comboMode->findData(fragmenter->mode()));
+
+    QDoubleSpinBox *spinTimeout = new QDoubleSpinBox();
+    spinTimeout->setRange(0.5, 600);
+    spinTimeout->setDecimals(1);
+    spinTimeout->setValue(fragmenter->reassemblyTimeout());
+    spinTimeout->setSuffix(" с");
+
+    QSpinBox *spinMemory = new QSpinBox();
+    spinMemory->setRange(packetHeaderBytes + 8, 100000000);
+    spinMemory->setValue(fragmenter->reassemblyMemory());
+    spinMemory->setSuffix(" байт");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Пакет більший за MTU каналу:", comboMode);
+    form->addRow("Таймаут збирання:", spinTimeout);
+    form->addRow("Буфер збирання на вузлі:", spinMemory);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    fragmenter->configure((MtuMode)comboMode->currentData().toInt(), spinTimeout->value(), spinMemory->value());
+
+    ui->textLog->append("=== MTU: " + comboMode->currentText() + ", збирання " + QString::number(fragmenter->reassemblyTimeout()) + " с, " +
+                        QString::number(fragmenter->reassemblyMemory()) + " байт на вузол ===");
+}
+
+// Кожен канал отримує одне зі значень списку; вибір - функція зерна й пари вузлів, тож розподіл повторюється
+void MainWindow::assignMixedMtus()
+{
+    bool ok;
+    QString text = QInputDialog::getText(this, "Змішані MTU каналів",
+                                         "Значення MTU через кому (0 - без обмеження, порожньо - зняти обмеження з усіх):",
+                                         QLineEdit::Normal, "576, 1280, 1500, 9000", &ok);
+    if (!ok) return;
+
+    std::vector<int> values;
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts))
     {
-        ui->textLog->append("!! [RETRY] Повторна відправка пакету #" + QString::number(id));
+        int value = part.trimmed().toInt(&ok);
+        if (!ok || value < 0 || (value > 0 && value <= packetHeaderBytes))
+        {
+            QMessageBox::warning(this, "Помилка", "Некоректне значення MTU: " + part.trimmed());
+            return;
+        }
+        values.push_back(value);
     }
 
-    Node *startNode = nullptr;
-    foreach(QGraphicsItem *item, ui->graphicsView->scene()->items())
+    QSet<Edge*> links;
+    for (Node *node : networkScene->nodes())
+        for (Edge *edge : node->edges())
+            links.insert(edge);
+
+    QMap<int, int> histogram;
+    for (Edge *edge : links)
     {
-        Node *n = dynamic_cast<Node*>(item);
-        if (n && n->getId() == path[0]) startNode = n;
+        int mtu = 0;
+        if (!values.empty())
+        {
+            CounterRng rng(simulationSeed, 0x4d54, edge->sourceNode()->getId(), edge->destNode()->getId());
+            mtu = values[rng.below((int)values.size())];
+        }
+        edge->setMtu(mtu);
+        histogram[mtu]++;
     }
-    if (!startNode) return;
+    fragmenter->forgetPathMtus();
 
-    Packet *pkt = new Packet(id, size, type);
-    ui->graphicsView->scene()->addItem(pkt);
-    pkt->setPos(startNode->pos());
-    pkt->setVisible(true);
-    pkt->setProperty("isLost", false);
+    QStringList summary;
+    for (auto it = histogram.begin(); it != histogram.end(); ++it)
+        summary << (it.key() ? QString::number(it.key()) : QString("без обмеження")) + ": " + QString::number(it.value());
+    ui->textLog->append("=== MTU каналів (" + QString::number(links.size()) + "): " + summary.join(", ") + " ===");
+}
+
+void MainWindow::logFragmentationStats()
+{
+    const FragmentationStats& fragmentStats = fragmenter->stats();
+    ReassemblyStats total = fragmenter->reassemblyStats();
+
+    ui->textLog->append("=== Фрагментація: " + QString(fragmenter->mode() == PathMtuDiscovery ? "PMTUD" : "у мережі") + " ===");
+    ui->textLog->append("  Поділено дейтаграм: " + QString::number(fragmentStats.datagrams) + ", фрагментів: " +
+                        QString::number(fragmentStats.fragments) + " (в середньому " +
+                        QString::number(fragmentStats.datagrams ? (double)fragmentStats.fragments / fragmentStats.datagrams : 0.0, 'f', 1) +
+                        " на дейтаграму)");
+    ui->textLog->append("  Додаткові заголовки: " + QString::number(fragmentStats.overheadBytes) + " байт (" +
+                        QString::number(telemetry.bytesSent ? 100.0 * fragmentStats.overheadBytes / telemetry.bytesSent : 0.0, 'f', 1) +
+                        "% переданого)");
+    if (fragmenter->mode() == PathMtuDiscovery)
+        ui->textLog->append("  Відкинуто з Packet Too Big: " + QString::number(fragmentStats.tooBig) + ", відомих MTU шляхів: " +
+                            QString::number(fragmenter->knownPathMtus()));
+    ui->textLog->append("  Зібрано: " + QString::number(total.completed) + ", не зібрано за таймаутом: " +
+                        QString::number(total.timedOut) + ", витіснено через пам'ять: " + QString::number(total.evicted));
+    ui->textLog->append("  Буфер збирання: пік " + QString::number(total.peakMemory) + " байт на вузол, зараз " +
+                        QString::number(fragmenter->reassemblyMemoryUsed()) + " байт у " + QString::number(fragmenter->reassemblyNodes()) +
+                        " вузлах, ліміт " + QString::number(fragmenter->reassemblyMemory()) + " байт");
+}
 
-    QAbstractAnimation *anim = createPacketAnim(pkt, path, currentErrorRate);
+void MainWindow::showPayloadDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Байти пакетів і CRC32C");
 
-    connect(anim, &QAbstractAnimation::finished, this, [=]()
-            {
-                bool lost = pkt->property("isLost").toBool();
-                int lostNode = pkt->property("lostNode").toInt();
+    QCheckBox *checkPayload = new QCheckBox("Пакети несуть справжні байти повідомлення");
+    checkPayload->setChecked(payload.enabled());
 
-                ui->graphicsView->scene()->removeItem(pkt);
-                delete pkt;
+    QDoubleSpinBox *spinFlipRate = new QDoubleSpinBox();
+    spinFlipRate->setDecimals(8);
+    spinFlipRate->setRange(0, 0.01);
+    spinFlipRate->setSingleStep(0.00001);
+    spinFlipRate->setValue(payload.bitFlipRate());
 
-                anim->deleteLater();
+    QFormLayout *form = new QFormLayout();
+    form->addRow(checkPayload);
+    form->addRow("Ймовірність інверсії біта на каналі:", spinFlipRate);
+    form->addRow("CRC32C:", new QLabel(Crc32c::accelerated() ? "інструкція SSE4.2" : "таблиці slicing-by-8"));
 
-                if (lost)
-                {
-                    ui->textLog->append("xx [LOSS] Пакет #" + QString::number(id) + " втрачено на шляху до вузла " + QString::number(lostNode));
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
 
-                    if (isVirtualMode)
-                    {
-                        QTimer::singleShot(1500, this, [=]() {
-                            sendSinglePacket(id, size, type, path, true);
-                        });
-                    }
-                }
-                else
-                {
-                    onPacketDelivered(id, size, type);
-                }
-            });
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    payload.configure(checkPayload->isChecked(), spinFlipRate->value());
 
-    anim->start();
+    ui->textLog->append(payload.enabled() ? "=== Байти пакетів: увімкнено, інверсія біта " + QString::number(payload.bitFlipRate()) + " на канал ==="
+                                    : QString("=== Байти пакетів: вимкнено ==="));
 }
 
-void MainWindow::onPacketDelivered(int id, int size, PacketType type)
+void MainWindow::logPayloadStats()
 {
-    QString timeStr = QDateTime::currentDateTime().toString("hh:mm:ss");
+    const PayloadStats& payloadStats = payload.stats();
+    const HeaderPoolStats& pool = payload.poolStats();
+    double processedNs = payloadStats.sealNs + payloadStats.verifyNs;
+    qint64 processedBytes = payloadStats.sealBytes + payloadStats.verifyBytes;
+
+    ui->textLog->append("=== Байти пакетів, CRC32C (" + QString(Crc32c::accelerated() ? "SSE4.2" : "таблиці") + ") ===");
+    ui->textLog->append("  Сформовано пакетів: " + QString::number(payloadStats.sealed) + ", " +
+                        QString::number(payloadStats.sealed ? (double)payloadStats.sealNs / payloadStats.sealed : 0.0, 'f', 0) +
+                        " нс на пакет; перевірок: " + QString::number(payloadStats.verified) + ", " +
+                        QString::number(payloadStats.verified ? (double)payloadStats.verifyNs / payloadStats.verified : 0.0, 'f', 0) +
+                        " нс на пакет");
+    ui->textLog->append("  Оброблено " + QString::number(processedBytes) + " байт зі швидкістю " +
+                        QString::number(processedNs > 0 ? processedBytes / processedNs * 1000 : 0.0, 'f', 0) + " МБ/с");
+    ui->textLog->append("  Інвертовано бітів: " + QString::number(payloadStats.flippedBits) + " у " +
+                        QString::number(payloadStats.corruptedPackets) + " передачах; копій під час запису: " +
+                        QString::number(payloadStats.copies));
+    ui->textLog->append("  CRC виявила спотворених: " + QString::number(payloadStats.detected) + ", не виявила: " +
+                        QString::number(payloadStats.undetected));
+    ui->textLog->append("  Пул заголовків: видано " + QString::number(pool.acquired) + " блоків, зараз " +
+                        QString::number(pool.inUse) + ", пік " + QString::number(pool.peakInUse) + ", пачок по " +
+                        QString::number(HeaderPool::slabBlocks) + ": " + QString::number(pool.slabs));
+    ui->textLog->append("  Буфер повідомлення: " + QString::number(payload.message().size()) + " байт, посилань на нього: " +
+                        QString::number(payload.message().references()));
+}
+
+void MainWindow::runChecksumBenchmark()
+{
+    // Робочий потік не читає полів вікна
+    quint64 seed = simulationSeed;
+
+    startExperiment("Вимірювання CRC32C...", [=](const std::atomic<bool> *cancelled)
+                    {
+                        auto rows = std::make_shared<std::vector<ChecksumBenchmarkRow>>(PayloadChannel::benchmark(seed, cancelled));
+
+                        return std::function<void()>([=]()
+                                                     {
+                                                         ui->textLog->append("=== Вартість обробки пакета, МБ/с (CRC32C на цьому процесорі: " +
+                                                                             QString(Crc32c::accelerated() ? "SSE4.2" : "таблиці") + ") ===");
+                                                         for (const ChecksumBenchmarkRow& row : *rows)
+                                                             ui->textLog->append("  " + QString::number(row.size) + " байт: CRC32C " +
+                                                                                 QString::number(row.hardware, 'f', 0) + ", таблиці " +
+                                                                                 QString::number(row.table, 'f', 0) + ", зріз " +
+                                                                                 QString::number(row.slice, 'f', 0) + ", копія " +
+                                                                                 QString::number(row.copy, 'f', 0));
+                                                     });
+                    });
+}
+
+void MainWindow::showAdaptiveDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Адаптивні вартості каналів");
+
+    AdaptiveParams defaults;
+
+    QSpinBox *spinInterval = new QSpinBox();
+    spinInterval->setRange(100, 60000);
+    spinInterval->setValue(defaults.intervalMs);
+    spinInterval->setSuffix(" мс");
+
+    QSpinBox *spinCapacity = new QSpinBox();
+    spinCapacity->setRange(100, 100000000);
+    spinCapacity->setValue((int)defaults.capacity);
+    spinCapacity->setSuffix(" байт/с");
+
+    QDoubleSpinBox *spinSmoothing = new QDoubleSpinBox();
+    spinSmoothing->setRange(0.01, 1.0);
+    spinSmoothing->setSingleStep(0.05);
+    spinSmoothing->setValue(defaults.smoothing);
+
+    QDoubleSpinBox *spinGain = new QDoubleSpinBox();
+    spinGain->setRange(0.0, 100.0);
+    spinGain->setValue(defaults.gain);
+
+    QSpinBox *spinHysteresis = new QSpinBox();
+    spinHysteresis->setRange(0, 500);
+    spinHysteresis->setValue(qRound(defaults.hysteresis * 100));
+    spinHysteresis->setSuffix(" %");
+
+    QSpinBox *spinHold = new QSpinBox();
+    spinHold->setRange(0, 600000);
+    spinHold->setValue(defaults.holdMs);
+    spinHold->setSuffix(" мс");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Період вимірювання:", spinInterval);
+    form->addRow("Пропускна здатність каналу:", spinCapacity);
+    form->addRow("Згладжування (EWMA):", spinSmoothing);
+    form->addRow("Чутливість до навантаження:", spinGain);
+    form->addRow("Гістерезис:", spinHysteresis);
+    form->addRow("Утримання вартості:", spinHold);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    AdaptiveParams params;
+    params.intervalMs = spinInterval->value();
+    params.capacity = spinCapacity->value();
+    params.smoothing = spinSmoothing->value();
+    params.gain = spinGain->value();
+    params.hysteresis = spinHysteresis->value() / 100.0;
+    params.holdMs = spinHold->value();
+
+    adaptive->start(params);
+
+    ui->textLog->append("=== Адаптивні вартості: вимірювання кожні " + QString::number(params.intervalMs) + " мс, гістерезис " +
+                        QString::number(spinHysteresis->value()) + "%, утримання " + QString::number(params.holdMs) + " мс ===");
+}
+
+void MainWindow::stopAdaptiveRouting()
+{
+    if (!adaptive->isActive()) return;
+
+    logAdaptiveStats();
+    adaptive->stop();
+    ui->textLog->append("=== Адаптивні вартості вимкнено, ваги каналів відновлено ===");
+}
+
+void MainWindow::logAdaptiveStats()
+{
+    const AdaptiveStats& stats = adaptive->stats();
+
+    ui->textLog->append("  Адаптивні вартості: " + QString::number(stats.costChanges) + " змін за " +
+                        QString::number(stats.measurements) + " вимірювань, пікова утилізація " +
+                        QString::number(stats.peakUtilization * 100, 'f', 0) + "% (у середньому " +
+                        QString::number(stats.meanPeakUtilization * 100, 'f', 0) + "%)");
+    ui->textLog->append("  Перерахунків: " + QString::number(stats.generations) + ", дерев перераховано " +
+                        QString::number(stats.computedTrees) + ", перенесено без змін " + QString::number(stats.reusedTrees));
+    ui->textLog->append("  Змін маршрутів: " + QString::number(stats.routeChanges) + ", з них коливань (A -> B -> A): " +
+                        QString::number(stats.flaps));
+}
+
+void MainWindow::showLinkStateDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Протокол стану каналів");
+
+    LinkStateParams defaults;
+
+    auto makeSpin = [](double value, double max, double step, const QString& suffix)
+    {
+        QDoubleSpinBox *spin = new QDoubleSpinBox();
+        spin->setDecimals(3);
+        spin->setRange(0.0, max);
+        spin->setSingleStep(step);
+        spin->setValue(value);
+        spin->setSuffix(suffix);
+        return spin;
+    };
+
+    QDoubleSpinBox *spinLinkDelay = makeSpin(defaults.linkDelay * 1000, 10000, 1, " мс");
+    QDoubleSpinBox *spinInitial = makeSpin(defaults.spfInitial * 1000, 60000, 10, " мс");
+    QDoubleSpinBox *spinHold = makeSpin(defaults.spfHold * 1000, 60000, 10, " мс");
+    QDoubleSpinBox *spinMax = makeSpin(defaults.spfMax * 1000, 600000, 100, " мс");
+    QDoubleSpinBox *spinCost = makeSpin(defaults.spfCostPerNode * 1e6, 1000, 0.1, " мкс/вузол");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Затримка каналу:", spinLinkDelay);
+    form->addRow("SPF: початкова затримка:", spinInitial);
+    form->addRow("SPF: пауза утримання:", spinHold);
+    form->addRow("SPF: максимальна пауза:", spinMax);
+    form->addRow("Час SPF:", spinCost);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    LinkStateParams params;
+    params.minHops = routingState->minHops();
+    params.linkDelay = spinLinkDelay->value() / 1000.0;
+    params.spfInitial = spinInitial->value() / 1000.0;
+    params.spfHold = qMax(spinHold->value(), 0.001) / 1000.0;
+    params.spfMax = qMax(spinMax->value() / 1000.0, params.spfHold);
+    params.spfCostPerNode = spinCost->value() / 1e6;
+
+    runLinkStateExperiment(params);
+}
+
+// Канал для фаз відмови й відновлення: виділений на сцені, інакше випадковий за зерном прогону
+int MainWindow::experimentLink(const Topology& topology)
+{
+    if (topology.edges.empty()) return -1;
+
+    for (QGraphicsItem *item : networkScene->selectedItems())
+    {
+        Edge *edge = dynamic_cast<Edge*>(item);
+        if (!edge) continue;
+
+        for (int i = 0; i < (int)topology.edges.size(); ++i)
+        {
+            const TopologyEdge& e = topology.edges[i];
+            int a = topology.nodes[e.source].id;
+            int b = topology.nodes[e.dest].id;
+            int u = edge->sourceNode()->getId();
+            int v = edge->destNode()->getId();
+            if ((a == u && b == v) || (a == v && b == u)) return i;
+        }
+    }
+
+    CounterRng rng(simulationSeed, 0x4c53);
+    return rng.below((int)topology.edges.size());
+}
+
+bool MainWindow::prepareExperiment(Topology& topology, int& link, int maxRouters)
+{
+    topology = Network::capture(networkScene, true);
+    if (topology.nodes.empty()) return false;
+
+    if ((int)topology.nodes.size() > maxRouters)
+    {
+        QMessageBox::warning(this, "Помилка", "Модель протоколу підтримує до " + QString::number(maxRouters) + " маршрутизаторів");
+        return false;
+    }
+
+    link = experimentLink(topology);
+    return true;
+}
+
+// job виконується у фоні й повертає те, що треба зробити з результатом у GUI-потоці
+void MainWindow::startExperiment(const QString& label, std::function<std::function<void()>(const std::atomic<bool>*)> job)
+{
+    if (experimentCancelled) experimentCancelled->store(true);
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+    experimentCancelled = cancelled;
+
+    QProgressDialog *progress = new QProgressDialog(label, "Скасувати", 0, 0, this);
+    progress->setWindowTitle("Протоколи маршрутизації");
+    progress->setMinimumDuration(300);
+    connect(progress, &QProgressDialog::canceled, this, [cancelled]() { cancelled->store(true); });
+
+    experimentPool.start([=]()
+                         {
+                             std::function<void()> finish = job(cancelled.get());
+
+                             QMetaObject::invokeMethod(this, [=]()
+                                                       {
+                                                           progress->deleteLater();
+                                                           finish();
+                                                       }, Qt::QueuedConnection);
+                         });
+}
+
+void MainWindow::runLinkStateExperiment(const LinkStateParams& params)
+{
+    Topology topology;
+    int link;
+    if (!prepareExperiment(topology, link, LinkStateSimulation::maxRouters)) return;
+
+    QString title = "Стан каналів: " + QString::number(topology.nodes.size()) + " маршрутизаторів, " +
+                    QString::number(topology.edges.size()) + " каналів, SPF " +
+                    QString::number(params.spfInitial * 1000) + "/" + QString::number(params.spfHold * 1000) + "/" +
+                    QString::number(params.spfMax * 1000) + " мс";
+
+    startExperiment("Моделювання лавинної розсилки LSA...", [=](const std::atomic<bool> *cancelled)
+                    {
+                        LinkStateSimulation simulation(topology, params);
+                        std::vector<ConvergenceStats> report = runScenario(simulation, link, cancelled);
+
+                        return std::function<void()>([=]() { logConvergenceReport(title, report); });
+                    });
+}
+
+void MainWindow::showProtocolComparisonDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Вектор відстаней проти стану каналів");
+
+    DistanceVectorParams defaults;
+
+    QComboBox *comboLoops = new QComboBox();
+    comboLoops->addItem("Отруєний зворотний маршрут", PoisonReverse);
+    comboLoops->addItem("Розщеплений горизонт", SplitHorizon);
+    comboLoops->addItem("Без захисту від петель", NoLoopPrevention);
+
+    QDoubleSpinBox *spinLinkDelay = new QDoubleSpinBox();
+    spinLinkDelay->setRange(0.0, 10000.0);
+    spinLinkDelay->setValue(defaults.linkDelay * 1000);
+    spinLinkDelay->setSuffix(" мс");
+
+    QDoubleSpinBox *spinUpdateDelay = new QDoubleSpinBox();
+    spinUpdateDelay->setRange(0.0, 60000.0);
+    spinUpdateDelay->setValue(defaults.updateDelay * 1000);
+    spinUpdateDelay->setSuffix(" мс");
+
+    QSpinBox *spinInfinity = new QSpinBox();
+    spinInfinity->setRange(0, 1000000);
+    spinInfinity->setValue(defaults.infinity);
+    spinInfinity->setSpecialValueText("авто");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Захист від петель:", comboLoops);
+    form->addRow("Затримка каналу:", spinLinkDelay);
+    form->addRow("Затримка тригерного оновлення:", spinUpdateDelay);
+    form->addRow("Нескінченна метрика:", spinInfinity);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    DistanceVectorParams params;
+    params.minHops = routingState->minHops();
+    params.loopPrevention = (LoopPrevention)comboLoops->currentData().toInt();
+    params.linkDelay = spinLinkDelay->value() / 1000.0;
+    params.updateDelay = spinUpdateDelay->value() / 1000.0;
+    params.infinity = spinInfinity->value();
+
+    runProtocolComparison(params);
+}
+
+// Обидві моделі проходять той самий сценарій на тому самому знімку й з тим самим каналом
+void MainWindow::runProtocolComparison(const DistanceVectorParams& params)
+{
+    Topology topology;
+    int link;
+    if (!prepareExperiment(topology, link, qMin<int>(LinkStateSimulation::maxRouters, DistanceVectorSimulation::maxRouters))) return;
+
+    LinkStateParams linkState;
+    linkState.minHops = params.minHops;
+    linkState.linkDelay = params.linkDelay;
+
+    QString size = QString::number(topology.nodes.size()) + " маршрутизаторів, " + QString::number(topology.edges.size()) + " каналів";
+
+    startExperiment("Порівняння протоколів маршрутизації...", [=](const std::atomic<bool> *cancelled)
+                    {
+                        std::vector<ConvergenceStats> lsReport;
+                        {
+                            LinkStateSimulation simulation(topology, linkState);
+                            lsReport = runScenario(simulation, link, cancelled);
+                        }
+
+                        std::vector<ConvergenceStats> dvReport;
+                        int infinity = 0;
+                        if (!cancelled->load())
+                        {
+                            DistanceVectorSimulation simulation(topology, params);
+                            infinity = simulation.infinity();
+                            dvReport = runScenario(simulation, link, cancelled);
+                        }
+
+                        return std::function<void()>([=]()
+                                                     {
+                                                         logConvergenceReport("Стан каналів: " + size, lsReport);
+                                                         logConvergenceReport("Вектор відстаней: " + size + ", нескінченність " +
+                                                                              QString::number(infinity), dvReport);
+
+                                                         ui->textLog->append("=== Стан каналів / вектор відстаней ===");
+                                                         for (size_t i = 0; i < qMin(lsReport.size(), dvReport.size()); ++i)
+                                                         {
+                                                             const ConvergenceStats& ls = lsReport[i];
+                                                             const ConvergenceStats& dv = dvReport[i];
+                                                             ui->textLog->append("  " + ls.phase + ": збіжність " +
+                                                                                 QString::number(ls.convergenceTime * 1000, 'f', 1) + " / " +
+                                                                                 QString::number(dv.convergenceTime * 1000, 'f', 1) + " мс, повідомлень " +
+                                                                                 QString::number(ls.messages) + " / " + QString::number(dv.messages) +
+                                                                                 ", байт " + QString::number(ls.bytes) + " / " + QString::number(dv.bytes));
+                                                         }
+                                                     });
+                    });
+}
+
+void MainWindow::showCircuitBandwidthDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Смуга віртуального каналу");
+
+    QDoubleSpinBox *spinBandwidth = new QDoubleSpinBox();
+    spinBandwidth->setRange(0.0, 1000000.0);
+    spinBandwidth->setValue(circuitBandwidth);
+    spinBandwidth->setSuffix(" Мбіт/с");
+    spinBandwidth->setSpecialValueText("без резервування");
+
+    QSpinBox *spinPriority = new QSpinBox();
+    spinPriority->setRange(0, CapacityPlanner::priorityLevels - 1);
+    spinPriority->setValue(circuitPriority);
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Смуга:", spinBandwidth);
+    form->addRow("Пріоритет (0 - найвищий):", spinPriority);
+    form->addRow(new QLabel("Живий режим несе один канал, тож витіснення за пріоритетом\nперевіряє лише експеримент ємності мережі"));
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    circuitBandwidth = spinBandwidth->value();
+    circuitPriority = spinPriority->value();
+}
+
+void MainWindow::showCapacityDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Ємність мережі для віртуальних каналів");
+
+    QSpinBox *spinRequests = new QSpinBox();
+    spinRequests->setRange(1, 1000000);
+    spinRequests->setValue(1000);
+
+    QDoubleSpinBox *spinMin = new QDoubleSpinBox();
+    spinMin->setRange(0.1, 1000000.0);
+    spinMin->setValue(1);
+    spinMin->setSuffix(" Мбіт/с");
+
+    QDoubleSpinBox *spinMax = new QDoubleSpinBox();
+    spinMax->setRange(0.1, 1000000.0);
+    spinMax->setValue(20);
+    spinMax->setSuffix(" Мбіт/с");
+
+    QSpinBox *spinShare = new QSpinBox();
+    spinShare->setRange(0, 100);
+    spinShare->setValue(10);
+    spinShare->setSuffix(" %");
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Запитів на канали:", spinRequests);
+    form->addRow("Смуга від:", spinMin);
+    form->addRow("Смуга до:", spinMax);
+    form->addRow("Частка пріоритетних:", spinShare);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    dialog.setLayout(form);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    runCapacityExperiment(spinRequests->value(), qMin(spinMin->value(), spinMax->value()),
+                          qMax(spinMin->value(), spinMax->value()), spinShare->value());
+}
+
+// Запити надходять один за одним і не звільняються: видно, де мережа насичується і кого витісняють пріоритетні
+void MainWindow::runCapacityExperiment(int requests, double minBandwidth, double maxBandwidth, int highPriorityShare)
+{
+    Topology topology = Network::capture(networkScene, true);
+    if (topology.nodes.size() < 2) return;
+
+    bool minHops = routingState->minHops();
+    quint64 seed = simulationSeed;
+
+    QString title = "Ємність для віртуальних каналів: " + QString::number(topology.nodes.size()) + " вузлів, " +
+                    QString::number(topology.edges.size()) + " каналів, " + QString::number(requests) + " запитів по " +
+                    QString::number(minBandwidth) + "-" + QString::number(maxBandwidth) + " Мбіт/с";
+
+    startExperiment("Допуск віртуальних каналів...", [=](const std::atomic<bool> *cancelled)
+                    {
+                        struct ClassStats
+                        {
+                            int admitted = 0;
+                            int rejected = 0;
+                            int preempted = 0;
+                        };
+
+                        CapacityPlanner planner(topology, minHops);
+                        CounterRng rng(seed, 0x4341);
+                        int n = (int)topology.nodes.size();
+
+                        ClassStats classes[2];
+                        std::vector<char> circuitHigh;
+                        std::vector<double> circuitBandwidths;
+                        int processed = 0;
+                        int firstRejection = -1;
+                        qint64 hops = 0;
+                        double carried = 0;
+
+                        for (; processed < requests && !cancelled->load(); ++processed)
+                        {
+                            int source = rng.below(n);
+                            int dest = rng.below(n - 1);
+                            if (dest >= source) dest++;
+
+                            double bandwidth = minBandwidth + (maxBandwidth - minBandwidth) * rng.uniform();
+                            bool high = rng.uniform() * 100 < highPriorityShare;
+                            int priority = high ? 0 : CapacityPlanner::priorityLevels - 1;
+
+                            Admission admission = planner.admit({source, dest, bandwidth, priority, priority});
+                            if (!admission.admitted)
+                            {
+                                classes[high].rejected++;
+                                if (firstRejection < 0) firstRejection = processed;
+                                continue;
+                            }
+
+                            classes[high].admitted++;
+                            hops += admission.links.size();
+                            carried += bandwidth;
+                            circuitHigh.push_back(high);
+                            circuitBandwidths.push_back(bandwidth);
+
+                            for (int victim : admission.preempted)
+                            {
+                                classes[(int)circuitHigh[victim]].preempted++;
+                                carried -= circuitBandwidths[victim];
+                            }
+                        }
+
+                        double utilizationSum = 0;
+                        double peakUtilization = 0;
+                        int saturated = 0;
+                        for (int e = 0; e < (int)topology.edges.size(); ++e)
+                        {
+                            double utilization = planner.capacity(e) > 0 ? planner.reserved(e) / planner.capacity(e) : 0;
+                            utilizationSum += utilization;
+                            peakUtilization = std::max(peakUtilization, utilization);
+                            if (utilization >= 0.99) saturated++;
+                        }
+                        double meanUtilization = topology.edges.empty() ? 0 : utilizationSum / topology.edges.size();
+                        int active = planner.activeCircuits();
+                        int admitted = classes[0].admitted + classes[1].admitted;
+
+                        return std::function<void()>([=]()
+                                                     {
+                                                         ui->textLog->append("=== " + title + " ===");
+                                                         if (processed < requests)
+                                                             ui->textLog->append("  [WARN] Скасовано після " + QString::number(processed) + " запитів");
+
+                                                         ui->textLog->append("  Прийнято: " + QString::number(admitted) + ", відхилено: " +
+                                                                             QString::number(classes[0].rejected + classes[1].rejected) +
+                                                                             ", витіснено: " + QString::number(classes[0].preempted + classes[1].preempted) +
+                                                                             ", активних: " + QString::number(active));
+                                                         ui->textLog->append("  Перша відмова: " +
+                                                                             (firstRejection < 0 ? QString("немає") : "запит #" + QString::number(firstRejection + 1)));
+                                                         ui->textLog->append("  Пріоритетні (0): прийнято " + QString::number(classes[1].admitted) +
+                                                                             ", відхилено " + QString::number(classes[1].rejected) +
+                                                                             ", витіснено " + QString::number(classes[1].preempted));
+                                                         ui->textLog->append("  Звичайні (7): прийнято " + QString::number(classes[0].admitted) +
+                                                                             ", відхилено " + QString::number(classes[0].rejected) +
+                                                                             ", витіснено " + QString::number(classes[0].preempted));
+                                                         ui->textLog->append("  Зарезервовано для активних: " + QString::number(carried, 'f', 1) +
+                                                                             " Мбіт/с, середня довжина шляху " +
+                                                                             QString::number(admitted ? (double)hops / admitted : 0.0, 'f', 2) + " хопів");
+                                                         ui->textLog->append("  Завантаження каналів: середнє " + QString::number(meanUtilization * 100, 'f', 1) +
+                                                                             "%, максимальне " + QString::number(peakUtilization * 100, 'f', 1) +
+                                                                             "%, насичених " + QString::number(saturated));
+                                                     });
+                    });
+}
+
+void MainWindow::logConvergenceReport(const QString& title, const std::vector<ConvergenceStats>& report)
+{
+    ui->textLog->append("=== " + title + " ===");
+
+    for (const ConvergenceStats& stats : report)
+    {
+        if (!stats.completed)
+        {
+            ui->textLog->append("  " + stats.phase + ": скасовано");
+            continue;
+        }
+
+        ui->textLog->append("  " + stats.phase + ": збіжність " + QString::number(stats.convergenceTime * 1000, 'f', 1) +
+                            " мс, керуючий трафік стих через " + QString::number(stats.quietTime * 1000, 'f', 1) + " мс");
+        ui->textLog->append("    Повідомлень: " + QString::number(stats.messages) + " (" + QString::number(stats.bytes) +
+                            " байт), дублікатів: " + QString::number(stats.duplicates));
+        ui->textLog->append("    Перерахунків: " + QString::number(stats.computations) + ", до " +
+                            QString::number(stats.maxComputations) + " на маршрутизатор; FIB не збігається в " +
+                            QString::number(stats.inconsistentRouters));
+        if (stats.metricIncreases > 0)
+            ui->textLog->append("    Зростань метрик (рахунок до нескінченності): " + QString::number(stats.metricIncreases));
+    }
+}
+
+void MainWindow::showGeneratorDialog()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Генератор топології");
+
+    QComboBox *comboModel = new QComboBox();
+    comboModel->addItem("Кільце з хордами", RingChords);
+    comboModel->addItem("Waxman", Waxman);
+    comboModel->addItem("Barabási–Albert", BarabasiAlbert);
+    comboModel->addItem("Fat-tree", FatTree);
+
+    QSpinBox *spinRegions = new QSpinBox();
+    spinRegions->setRange(1, 10000);
+    spinRegions->setValue(3);
+
+    QSpinBox *spinNodes = new QSpinBox();
+    spinNodes->setRange(1, 1000000);
+    spinNodes->setValue(9);
+
+    QDoubleSpinBox *spinDegree = new QDoubleSpinBox();
+    spinDegree->setRange(2.0, 64.0);
+    spinDegree->setSingleStep(0.5);
+    spinDegree->setValue(3.0);
+
+    QSpinBox *spinLinks = new QSpinBox();
+    spinLinks->setRange(0, 100);
+    spinLinks->setValue(1);
+
+    QSpinBox *spinFatTreeK = new QSpinBox();
+    spinFatTreeK->setRange(2, 128);
+    spinFatTreeK->setSingleStep(2);
+    spinFatTreeK->setValue(4);
+
+    QSpinBox *spinSeed = new QSpinBox();
+    spinSeed->setRange(0, INT_MAX);
+    spinSeed->setValue((int)qMin<quint64>(simulationSeed, INT_MAX));
+
+    QFormLayout *form = new QFormLayout();
+    form->addRow("Модель:", comboModel);
+    form->addRow("Регіонів:", spinRegions);
+    form->addRow("Вузлів у регіоні:", spinNodes);
+    form->addRow("Середній ступінь:", spinDegree);
+    form->addRow("Міжрегіональних каналів:", spinLinks);
+    form->addRow("Fat-tree k:", spinFatTreeK);
+    form->addRow("Seed:", spinSeed);
+
+    auto readParams = [=]()
+    {
+        GeneratorParams params;
+        params.model = (TopologyModel)comboModel->currentData().toInt();
+        params.regions = spinRegions->value();
+        params.nodesPerRegion = spinNodes->value();
+        params.averageDegree = spinDegree->value();
+        params.interRegionLinks = spinLinks->value();
+        params.fatTreeK = spinFatTreeK->value();
+        params.seed = spinSeed->value();
+        return params;
+    };
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, [&]()
+            {
+                qint64 total = TopologyGenerator::totalNodes(readParams());
+                if (total > TopologyGenerator::maxNodes)
+                {
+                    QMessageBox::warning(&dialog, "Помилка", "Забагато вузлів: " + QString::number(total) + ", найбільше " +
+                                         QString::number(TopologyGenerator::maxNodes));
+                    return;
+                }
+                dialog.accept();
+            });
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    layout->addLayout(form);
+    layout->addWidget(buttons);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    GeneratorParams params = readParams();
+
+    stopAutoLayout();
+    quiesceTraffic();
+    Network::generate(ui->graphicsView->scene(), params);
+
+    ui->textLog->append("[INFO] Згенеровано мережу: " + QString::number(TopologyGenerator::totalNodes(params)) + " вузлів, seed = " + QString::number(params.seed));
+}
+
+void MainWindow::saveTopology()
+{
+    QString path = QFileDialog::getSaveFileName(this, "Зберегти топологію", QString(), "Знімок топології (*.nrsnap)");
+    if (path.isEmpty()) return;
+
+    QString error;
+    if (!Network::save(ui->graphicsView->scene(), path, &error))
+    {
+        QMessageBox::warning(this, "Помилка", "Не вдалося зберегти топологію: " + error);
+        return;
+    }
+
+    ui->textLog->append("[INFO] Топологію збережено: " + path);
+}
+
+void MainWindow::loadTopology()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Відкрити топологію", QString(), "Знімок топології (*.nrsnap)");
+    if (path.isEmpty()) return;
+
+    stopAutoLayout();
+    quiesceTraffic();
+
+    QString error;
+    std::shared_ptr<const TopologySnapshot> snapshot = Network::load(ui->graphicsView->scene(), path, &error);
+    if (!snapshot)
+    {
+        QMessageBox::warning(this, "Помилка", "Не вдалося відкрити топологію: " + error);
+        return;
+    }
+
+    // Відкритий знімок - уже готовий CSR-граф цієї топології, тож маршрути рахуються прямо над ним
+    routingState->seed(snapshot);
+    routing->seed(snapshot);
+
+    ui->textLog->append("[INFO] Топологію завантажено: " + path);
+}
+
+void MainWindow::importTopology()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Імпорт топології", QString(),
+                                                "Топології (*.graphml *.xml *.cch *.txt *.edges *.intra *.weights);;Усі файли (*)");
+    if (path.isEmpty()) return;
+
+    Topology topology;
+    QString error;
+    if (!TopologyImporter::importFile(path, topology, &error))
+    {
+        QMessageBox::warning(this, "Помилка", "Не вдалося імпортувати топологію: " + error);
+        return;
+    }
+
+    stopAutoLayout();
+    quiesceTraffic();
+
+    ui->graphicsView->setUpdatesEnabled(false);
+    Network::build(ui->graphicsView->scene(), topology);
+    ui->graphicsView->setUpdatesEnabled(true);
+
+    ui->textLog->append("[INFO] Імпортовано " + QString::number(topology.nodes.size()) + " вузлів і " +
+                        QString::number(topology.edges.size()) + " каналів з " + path);
+
+    // Списки ребер і карти Rocketfuel не містять координат
+    if (TopologyImporter::detectFormat(path) != GraphML)
+        runAutoLayout();
+}
+
+void MainWindow::stopAutoLayout()
+{
+    if (!layoutWorker) return;
+
+    QThread *thread = layoutWorker->thread();
+    layoutWorker->cancel();
+    layoutWorker = nullptr;
+
+    thread->quit();
+    thread->wait();
+}
+
+void MainWindow::runAutoLayout()
+{
+    stopAutoLayout();
+
+    Topology topology = Network::capture(networkScene);
+    if (topology.nodes.size() < 2) return;
+
+    QList<int> ids;
+    std::vector<double> xs, ys;
+    std::vector<std::pair<int, int>> edges;
+
+    ids.reserve((int)topology.nodes.size());
+    xs.reserve(topology.nodes.size());
+    ys.reserve(topology.nodes.size());
+    for (const TopologyNode& node : topology.nodes)
+    {
+        ids.append(node.id);
+        xs.push_back(node.x);
+        ys.push_back(node.y);
+    }
+
+    edges.reserve(topology.edges.size());
+    for (const TopologyEdge& edge : topology.edges)
+        edges.push_back({edge.source, edge.dest});
+
+    layoutWorker = LayoutWorker::create(ids, std::make_unique<ForceLayout>(std::move(xs), std::move(ys), edges));
+
+    connect(layoutWorker, &LayoutWorker::positionsUpdated, this, &MainWindow::applyLayout);
+    LayoutWorker *worker = layoutWorker;
+    connect(layoutWorker, &LayoutWorker::finished, this, [=](int iterations, qint64 elapsedMs)
+            {
+                if (layoutWorker != worker) return;
+
+                networkScene->setSceneRect(networkScene->itemsBoundingRect().adjusted(-100, -100, 100, 100));
+                ui->textLog->append("[INFO] Розкладку завершено: " + QString::number(iterations) + " ітерацій за " +
+                                    QString::number(elapsedMs) + " мс");
+            });
+
+    ui->textLog->append("[INFO] Авто-розкладка " + QString::number(ids.size()) + " вузлів...");
+    layoutWorker->launch();
+}
+
+void MainWindow::applyLayout(const QList<int>& nodeIds, const QList<QPointF>& positions)
+{
+    if (sender() != layoutWorker.data()) return;
+
+    for (int i = 0; i < nodeIds.size() && i < positions.size(); ++i)
+    {
+        Node *node = networkScene->node(nodeIds[i]);
+        if (node) node->setPos(positions[i]);
+    }
+}
+
+void MainWindow::setupTable()
+{
+    QStringList headers;
+    headers << "From" << "To" << "Type" << "Time (ms)" << "Service (B)" << "Packets" << "Msg Size" << "Path" << "Delivered" << "Seed";
+    ui->tableResults->setColumnCount(headers.size());
+    ui->tableResults->setHorizontalHeaderLabels(headers);
+    ui->tableResults->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    ui->tableResults->horizontalHeader()->setStretchLastSection(true);
+}
+
+void MainWindow::startSimulation()
+{
+    ui->textLog->clear();
+    ui->textLog->append(QDateTime::currentDateTime().toString("hh:mm:ss") + " [INFO] Старт симуляції...");
+
+    int sourceID = ui->spinSourceID->value();
+    int destID = ui->spinTargetID->value();
+    currentMsgSize = ui->spinMsgSize->value();
+    currentPacketSize = ui->spinPacketSize->value();
+    currentErrorRate = ui->spinErrorProb->value();
+    isVirtualMode = ui->rbVirtual->isChecked();
+
+    if (!networkScene->node(sourceID))
+    {
+        ui->textLog->append("[ERROR] Стартовий вузол не знайдено!");
+        return;
+    }
+
+    routing->cancel(routeRequest);
+
+    if (isVirtualMode && circuitBandwidth > 0)
+    {
+        startConstrainedCircuit(sourceID, destID);
+        return;
+    }
+
+    ui->btnStartSimulation->setEnabled(false);
+
+    routeRequest = routing->requestTree(sourceID, routingState->minHops(), [=](std::shared_ptr<const RoutingResult> result)
+                                        {
+                                            ui->btnStartSimulation->setEnabled(true);
+
+                                            if (!result)
+                                            {
+                                                ui->textLog->append("[WARN] Розрахунок маршруту скасовано");
+                                                return;
+                                            }
+
+                                            int target = result->snapshot->indexOf(destID);
+                                            beginTransmission(result->pathTo(target), target >= 0 ? result->tree.cost[target] : 0);
+                                        });
+}
+
+// Канал із резервуванням прокладається CSPF по живій топології, а не по дереву найкоротших шляхів
+void MainWindow::startConstrainedCircuit(int sourceId, int destId)
+{
+    // Смуга попереднього каналу звільняється до пошуку нового шляху. Живий режим несе один канал,
+    // тож після цього на каналах немає чужих резервувань, а витіснення перевіряє експеримент ємності
+    teardownCircuit();
+
+    std::vector<Edge*> sceneLinks;
+    Topology topology = Network::capture(networkScene, true, &sceneLinks);
+    int source = -1;
+    int dest = -1;
+    for (int i = 0; i < (int)topology.nodes.size(); ++i)
+    {
+        if (topology.nodes[i].id == sourceId) source = i;
+        if (topology.nodes[i].id == destId) dest = i;
+    }
+
+    CapacityPlanner planner(topology, routingState->minHops());
+    Admission admission = planner.admit({source, dest, circuitBandwidth, circuitPriority, circuitPriority});
+    if (!admission.admitted)
+    {
+        ui->textLog->append("[CAC] Канал відхилено: немає шляху з вільною смугою " + QString::number(circuitBandwidth) + " Мбіт/с");
+        return;
+    }
+
+    std::vector<int> path;
+    for (int v : admission.path)
+        path.push_back(topology.nodes[v].id);
+
+    int cost = 0;
+    std::vector<Edge*> links;
+    for (int e : admission.links)
+    {
+        cost += topology.edges[e].weight;
+        links.push_back(sceneLinks[e]);
+    }
+
+    ui->textLog->append("[CAC] Резервується " + QString::number(circuitBandwidth) + " Мбіт/с з пріоритетом " +
+                        QString::number(circuitPriority) + " на " + QString::number(admission.links.size()) + " каналах");
+    beginTransmission(path, cost, links);
+}
+
+void MainWindow::showRoutingTable(int nodeId)
+{
+    bool minHops = routingState->minHops();
+
+    QProgressDialog *progress = new QProgressDialog("Розрахунок таблиці маршрутизації роутера #" + QString::number(nodeId) + "...",
+                                                    "Скасувати", 0, 0, this);
+    progress->setWindowTitle("Маршрутизація");
+    progress->setMinimumDuration(300);
+
+    int request = routing->requestTree(nodeId, minHops, [=](std::shared_ptr<const RoutingResult> result)
+                                       {
+                                           progress->deleteLater();
+                                           if (!result) return;
+
+                                           QDialog *tableWindow = new QDialog();
+                                           tableWindow->setAttribute(Qt::WA_DeleteOnClose);
+                                           QString algoName = minHops ? " (Min Hops)" : " (Weight)";
+                                           tableWindow->setWindowTitle("Таблиця маршрутизації роутера #" + QString::number(nodeId) + algoName);
+                                           tableWindow->resize(700, 450);
+
+                                           QTableView *table = new QTableView();
+                                           table->setModel(new RoutingTableModel(result, table));
+                                           table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+
+                                           table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+                                           table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+                                           table->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+                                           table->horizontalHeader()->setSectionResizeMode(3, QHeaderView::ResizeToContents);
+
+                                           table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+                                           table->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+                                           QVBoxLayout *layout = new QVBoxLayout();
+                                           layout->addWidget(table);
+                                           tableWindow->setLayout(layout);
+
+                                           tableWindow->show();
+                                       });
+
+    connect(progress, &QProgressDialog::canceled, this, [=]() { routing->cancel(request); });
+}
+
+void MainWindow::beginTransmission(const std::vector<int>& path, int pathCost, const std::vector<Edge*>& links)
+{
+    teardownCircuit();
+    circuitLinks = links;
+    dataTimer->stop();
+    liveWindow.reset();
+
+    currentPath = path;
+    currentRoute = std::make_shared<const std::vector<int>>(path);
+
+    if (currentPath.size() < 2)
+    {
+        ui->textLog->append("[ERROR] Шлях не знайдено!");
+        return;
+    }
+
+    // Віртуальний канал дізнається найменший MTU шляху під час встановлення, тож його дані не фрагментуються
+    int senderMtu = currentPacketSize;
+    int minMtu = pathMinMtu(currentPath);
+    if (isVirtualMode && minMtu > 0) currentPacketSize = qMin(currentPacketSize, minMtu);
+
+    int headerSize = packetHeaderBytes;
+    if (currentPacketSize <= headerSize)
+    {
+        QMessageBox::warning(this, "Помилка", "MTU замалий!");
+        return;
+    }
+
+    int maxPayload = currentPacketSize - headerSize;
+    totalPacketsToSend = (currentMsgSize + maxPayload - 1) / maxPayload;
+
+    calculatedServiceTraffic = totalPacketsToSend * headerSize;
+    if (isVirtualMode)
+        calculatedServiceTraffic += (3 * headerSize);
+
+    int totalTraffic = currentMsgSize + calculatedServiceTraffic;
+
+    int latencyPerHop = 10;
+    int totalHops = currentPath.size() - 1;
+    double baseTime = (double)totalTraffic / 10.0;
+    calculatedTime = baseTime + (totalHops * latencyPerHop);
+
+    if (isVirtualMode) calculatedTime *= 1.2;
+
+    ui->textLog->append("--------------------------------------------------");
+    ui->textLog->append("МАРШРУТ: Вартість = " + QString::number(pathCost));
+
+    QString pathStr = "Шлях: ";
+    for (size_t i = 0; i < currentPath.size(); ++i)
+    {
+        pathStr += QString::number(currentPath[i]);
+        if (i < currentPath.size() - 1) pathStr += " -> ";
+    }
+    ui->textLog->append(pathStr);
+
+    ui->textLog->append("--------------------------------------------------");
+    ui->textLog->append("ПАРАМЕТРИ ПЕРЕДАЧІ:");
+    ui->textLog->append("  MTU (Розмір пакету): " + QString::number(currentPacketSize) + " байт" +
+                        (currentPacketSize < senderMtu ? " (обмежено MTU каналів шляху)" : QString()));
+    if (!isVirtualMode && minMtu > 0 && minMtu < currentPacketSize)
+        ui->textLog->append("  Найменший MTU каналів шляху: " + QString::number(minMtu) + " байт - " +
+                            (fragmenter->mode() == PathMtuDiscovery ? "джерело дізнається його з Packet Too Big" : "пакети фрагментуватимуться"));
+    ui->textLog->append("  Корисна ємність (Payload): " + QString::number(maxPayload) + " байт");
+    ui->textLog->append("--------------------------------------------------");
+    ui->textLog->append("ПРОГНОЗ ТРАФІКУ:");
+    ui->textLog->append("  Всього пакетів даних: " + QString::number(totalPacketsToSend));
+    ui->textLog->append("  Службовий трафік: " + QString::number(calculatedServiceTraffic) + " байт");
+    ui->textLog->append("  Розрахунковий час: " + QString::number(calculatedTime) + " мс");
+    ui->textLog->append("--------------------------------------------------");
+
+    packetsSentCount = 0;
+    packetsDeliveredCount = 0;
+    fragmenter->reset();
+    telemetry.reset();
+
+    payload.reset(simulationSeed, currentMsgSize);
+
+    QSet<Edge*> links;
+    for (Node *node : networkScene->nodes())
+        for (Edge *edge : node->edges())
+            links.insert(edge);
+    for (Edge *edge : links)
+        edge->lossModel().reseed(simulationSeed);
+
+    ui->textLog->append("  Зерно генератора: " + QString::number(simulationSeed));
+
+    if (isVirtualMode)
+    {
+        ui->textLog->append("=== [Фаза 1] Встановлення з'єднання (Handshake) ===");
+        stepHandshakeReq();
+    }
+    else
+    {
+        ui->textLog->append("=== [Фаза 1] Дейтаграмний режим ===");
+        startDataTransmission();
+    }
+}
+
+void MainWindow::stepHandshakeReq()
+{
+    Node *ingress = networkScene->node(currentPath[0]);
+    if (!ingress) return;
+
+    circuitIngress = currentPath[0];
+    circuitLabel = ingress->allocateCircuit(currentPath[1], circuitBandwidth, circuitLinks.empty() ? nullptr : circuitLinks[0]);
+    setupLabel = circuitLabel;
+
+    sendSinglePacket(0, 0, CONN_REQ, currentRoute, false, [=](size_t hop) { installCircuitHop(hop); });
+}
+
+// CONN_REQ дійшов до path[hop + 1]: вузол виділяє вхідну мітку, і попередній вузол дізнається свою вихідну
+void MainWindow::installCircuitHop(size_t hop)
+{
+    Node *prev = networkScene->node(currentPath[hop]);
+    Node *node = networkScene->node(currentPath[hop + 1]);
+    if (!prev || !node) return;
+
+    int next = hop + 2 < currentPath.size() ? currentPath[hop + 2] : -1;
+    Edge *link = next >= 0 && hop + 1 < circuitLinks.size() ? circuitLinks[hop + 1] : nullptr;
+    int label = node->allocateCircuit(next, circuitBandwidth, link);
+
+    prev->setCircuitOutLabel(setupLabel, label);
+    setupLabel = label;
+}
+
+// Знімає записи каналу, проходячи ланцюжок міток від вхідного вузла; працює й для недобудованого каналу
+void MainWindow::teardownCircuit()
+{
+    int nodeId = circuitIngress;
+    int label = circuitLabel;
+
+    while (Node *node = networkScene->node(nodeId))
+    {
+        const CircuitEntry *entry = node->circuit(label);
+        if (!entry) break;
+
+        int next = entry->nextNode;
+        int out = entry->outLabel;
+        node->releaseCircuit(label);
+
+        if (next < 0 || out < 0) break;
+        nodeId = next;
+        label = out;
+    }
+
+    circuitIngress = -1;
+    circuitLabel = -1;
+    setupLabel = -1;
+}
+
+void MainWindow::stepHandshakeAck()
+{
+    auto pathBack = std::make_shared<std::vector<int>>(currentPath);
+    std::reverse(pathBack->begin(), pathBack->end());
+    sendSinglePacket(0, 0, CONN_ACK, pathBack);
+}
+
+void MainWindow::startDataTransmission()
+{
+    if (isVirtualMode)
+        ui->textLog->append("=== [Фаза 2] Передача даних (Потік) ===");
+
+    if (isVirtualMode && congestionControl)
+    {
+        liveWindow = std::make_unique<CongestionWindow>(congestionParams);
+        liveSentAt.clear();
+        liveInFlight = 0;
+        cwndTrace.clear();
+        traceWindow();
+        sendWindow();
+        return;
+    }
+
+    dataTimer->start(1000);
+    sendNextDataPacket();
+}
+
+// Відправник тримає в дорозі не більше пакетів, ніж дозволяє вікно; нові йдуть, коли приходять підтвердження
+void MainWindow::sendWindow()
+{
+    while (liveWindow && packetsSentCount < totalPacketsToSend && liveInFlight < (int)liveWindow->window())
+    {
+        liveSentAt[packetsSentCount + 1] = telemetry.clock.elapsed();
+        liveInFlight++;
+        sendNextDataPacket();
+    }
+}
+
+// Доставка пакета даних і є його підтвердженням: одержувач у моделі відповідає миттєво
+void MainWindow::onCircuitDataAcked(int id, bool marked)
+{
+    qint64 sentAt = liveSentAt.value(id, -1);
+    liveSentAt.remove(id);
+    liveInFlight--;
+
+    double rtt = sentAt >= 0 ? (telemetry.clock.elapsed() - sentAt) / 1000.0 : 0;
+    int reductions = liveWindow->reductions();
+    liveWindow->onAck(telemetry.simTime(), rtt, marked);
+    traceWindow();
+
+    if (liveWindow->reductions() != reductions)
+        ui->textLog->append("!! [ECN] Пакет #" + QString::number(id) + " позначено, вікно " +
+                            QString::number(liveWindow->window(), 'f', 1));
+
+    sendWindow();
+}
+
+void MainWindow::onCircuitDataLost(int id)
+{
+    // Повторна передача не дає вимірювання RTT
+    liveSentAt[id] = -1;
+
+    liveWindow->onLoss(telemetry.simTime());
+    traceWindow();
+    ui->textLog->append("!! [CC] Втрата пакету #" + QString::number(id) + ", вікно " + QString::number(liveWindow->window(), 'f', 1) +
+                        ", поріг " + QString::number(liveWindow->threshold(), 'f', 1));
+}
+
+void MainWindow::traceWindow()
+{
+    cwndTrace.push_back({telemetry.simTime(), -1, liveWindow->window(), liveWindow->threshold(), liveWindow->smoothedRtt()});
+}
+
+void MainWindow::sendNextDataPacket()
+{
+    if (packetsSentCount < totalPacketsToSend)
+    {
+        int headerSize = packetHeaderBytes;
+        int maxPayload = currentPacketSize - headerSize;
+        int currentPayload = (packetsSentCount == totalPacketsToSend - 1) ? (currentMsgSize - packetsSentCount * maxPayload) : maxPayload;
+
+        if (isVirtualMode)
+            sendLabelledPacket(packetsSentCount + 1, currentPayload, DATA, circuitIngress, circuitLabel);
+        else
+            sendDatagram(packetsSentCount + 1, currentPayload, currentPath.front(), currentPath.back());
+        packetsSentCount++;
+    }
+    else
+    {
+        dataTimer->stop();
+    }
+}
+
+void MainWindow::checkCompletion()
+{
+    if (packetsDeliveredCount >= totalPacketsToSend)
+    {
+        if (isVirtualMode)
+        {
+            if (liveWindow)
+                ui->textLog->append("  Вікно перевантаження: " + QString::number(liveWindow->window(), 'f', 1) + " пакетів, зменшень " +
+                                    QString::number(liveWindow->reductions()) + ", згладжений RTT " +
+                                    QString::number(liveWindow->smoothedRtt() * 1000, 'f', 0) + " мс");
+            if (payload.stats().sealed) logPayloadStats();
+            ui->textLog->append("=== [Фаза 3] Розрив з'єднання ===");
+            stepDisconnect();
+        }
+        else
+        {
+            ui->textLog->append("--------------------------------------------------");
+            ui->textLog->append("[FINISH] Передачу завершено.");
+            if (fragmenter->stats().datagrams || fragmenter->stats().tooBig) logFragmentationStats();
+            if (payload.stats().sealed) logPayloadStats();
+            logToTable(true);
+        }
+    }
+}
+
+void MainWindow::stepDisconnect()
+{
+    sendLabelledPacket(0, 0, DISCONNECT, circuitIngress, circuitLabel);
+}
+
+void MainWindow::logToTable(bool success)
+{
+    int row = ui->tableResults->rowCount();
+    ui->tableResults->insertRow(row);
+
+    QString pathStr;
+    for (size_t i = 0; i < currentPath.size(); ++i)
+    {
+        pathStr += QString::number(currentPath[i]);
+        if (i < currentPath.size() - 1) pathStr += "->";
+    }
+
+    ui->tableResults->setItem(row, 0, new QTableWidgetItem(QString::number(ui->spinSourceID->value())));
+    ui->tableResults->setItem(row, 1, new QTableWidgetItem(QString::number(ui->spinTargetID->value())));
+    ui->tableResults->setItem(row, 2, new QTableWidgetItem(isVirtualMode ? "Virtual" : "Datagram"));
+    ui->tableResults->setItem(row, 3, new QTableWidgetItem(QString::number(calculatedTime, 'f', 2)));
+    ui->tableResults->setItem(row, 4, new QTableWidgetItem(QString::number(calculatedServiceTraffic)));
+    ui->tableResults->setItem(row, 5, new QTableWidgetItem(QString::number(totalPacketsToSend)));
+    ui->tableResults->setItem(row, 6, new QTableWidgetItem(QString::number(currentMsgSize)));
+    ui->tableResults->setItem(row, 7, new QTableWidgetItem(pathStr));
+
+    QTableWidgetItem *statusItem = new QTableWidgetItem(success ? "Yes" : "No");
+    if (!success) statusItem->setBackground(Qt::red);
+    ui->tableResults->setItem(row, 8, statusItem);
+    ui->tableResults->setItem(row, 9, new QTableWidgetItem(QString::number(simulationSeed)));
+}
+
+void MainWindow::sendSinglePacket(int id, int size, PacketType type, Route path, bool isRetransmission,
+                                  std::function<void(size_t)> onArrive)
+{
+    if (isRetransmission)
+    {
+        ui->textLog->append("!! [RETRY] Повторна відправка пакету #" + QString::number(id));
+    }
+
+    Node *startNode = networkScene->node((*path)[0]);
+    if (!startNode) return;
+
+    Packet *pkt = new Packet(id, size, type);
+    networkScene->addItem(pkt);
+    pkt->setPos(startNode->pos());
+    pkt->setVisible(true);
+
+    int runId = telemetry.runId;
+    telemetry.packetsSent++;
+    telemetry.bytesSent += size + packetHeaderBytes;
+    telemetry.inFlight++;
+    if (isRetransmission) telemetry.retransmissions++;
+
+    QPointer<Packet> alive(pkt);
+    advancePacket(pkt, path, 0, onArrive, [=](bool lost, int lostNode)
+                  {
+                      if (telemetry.runId == runId)
+                      {
+                          telemetry.inFlight--;
+                          if (!lost && type == DATA) telemetry.payloadDelivered += size;
+                      }
+
+                      if (alive)
+                      {
+                          networkScene->removeItem(pkt);
+                          delete pkt;
+                      }
+
+                      if (lost)
+                      {
+                          ui->textLog->append("xx [LOSS] Пакет #" + QString::number(id) + " втрачено на шляху до вузла " + QString::number(lostNode));
+
+                          if (isVirtualMode && type == CONN_REQ)
+                          {
+                              // Недобудований канал знімається, і встановлення починається заново
+                              teardownCircuit();
+                              QTimer::singleShot(1500, this, [=]() {
+                                  if (telemetry.runId != runId) return;
+                                  ui->textLog->append("!! [RETRY] Повторна відправка пакету #" + QString::number(id));
+                                  stepHandshakeReq();
+                              });
+                          }
+                          else if (isVirtualMode)
+                          {
+                              QTimer::singleShot(1500, this, [=]() {
+                                  if (telemetry.runId != runId) return;
+                                  sendSinglePacket(id, size, type, path, true, onArrive);
+                              });
+                          }
+                      }
+                      else
+                      {
+                          onPacketDelivered(id, size, type);
+                      }
+                  });
+}
+
+void MainWindow::advancePacket(Packet *pkt, Route path, size_t hop, std::function<void(size_t)> onArrive, std::function<void(bool, int)> done)
+{
+    int fromId = (*path)[hop];
+    int toId = (*path)[hop + 1];
+
+    Node *from = networkScene->node(fromId);
+    Node *to = networkScene->node(toId);
+
+    if (!from || !to)
+    {
+        done(true, toId);
+        return;
+    }
+
+    transmit(pkt, fromId, toId, [=](bool lost)
+             {
+                 if (lost)
+                 {
+                     done(true, toId);
+                     return;
+                 }
+
+                 if (onArrive) onArrive(hop);
+
+                 if (hop + 2 >= path->size())
+                     done(false, 0);
+                 else
+                     advancePacket(pkt, path, hop + 1, onArrive, done);
+             });
+}
+
+// Нове покоління маршрутизації одразу стає FIB кожного вузла, тож пакети в дорозі підхоплюють нові маршрути.
+// Якщо дерева для всіх джерел не рахувалися, таблиці скидаються й заповнюються на запит
+void MainWindow::installForwardingTables()
+{
+    std::shared_ptr<const RoutingGeneration> generation = routingState->current();
+    if (!generation) return;
+
+    for (Node *node : networkScene->nodes())
+        node->setForwardingTable(generation->result(node->getId()));
+}
+
+bool MainWindow::linkDrops(Node *from, Node *to, int packetBytes)
+{
+    Edge *edge = from->edgeTo(to);
+    if (!edge) return true;
+
+    edge->load().carriedBytes += packetBytes;
+
+    if (!edge->isUp() || !to->isUp())
+    {
+        outageLost++;
+        return true;
+    }
+
+    return edge->lossModel().drop(packetBytes, currentErrorRate / 100.0);
+}
+
+// Пакет стає у вихідну чергу каналу й летить до сусіда, коли канал закінчить його передавати
+void MainWindow::transmit(Packet *pkt, int fromId, int toId, std::function<void(bool)> arrived)
+{
+    std::function<void(bool)> send = [=](bool dropped)
+    {
+        Node *from = networkScene->node(fromId);
+        Node *to = networkScene->node(toId);
+        if (dropped || !from || !to)
+        {
+            arrived(true);
+            return;
+        }
+
+        bool lost = linkDrops(from, to, pkt->getDataSize() + packetHeaderBytes);
+        if (!lost && pkt->getBuffer()) payload.corrupt(pkt);
+        animator->moveHop(pkt, fromId, toId, from->pos(), to->pos(), 1000, lost, [=](bool cancelled) { arrived(lost || cancelled); });
+    };
+
+    if (!linkQueuing)
+    {
+        send(false);
+        return;
+    }
+
+    quint64 key = ((quint64)(quint32)fromId << 32) | (quint32)toId;
+    auto it = linkQueues.find(key);
+    if (it == linkQueues.end())
+        it = linkQueues.emplace(key, LinkQueue{LinkScheduler<std::function<void(bool)>>(schedulerParams), false, nullptr, 0}).first;
+
+    LinkQueue& queue = it->second;
+    if (ecnThreshold > 0 && queue.scheduler.size() >= ecnThreshold) pkt->setCongestionMarked(true);
+
+    if (!queue.scheduler.enqueue(send, pkt->getTrafficClass(), pkt->getDataSize() + packetHeaderBytes, queueClock.elapsed() / 1000.0))
+    {
+        send(true);
+        return;
+    }
+
+    if (!queue.busy) serveLink(key);
+}
+
+// Швидкість черги - ємність каналу в момент передачі, як і в FlowSimulation: Мбіт/с -> байт/с
+double MainWindow::linkRate(int fromId, int toId) const
+{
+    Node *from = networkScene->node(fromId);
+    Edge *edge = from ? from->edgeTo(toId) : nullptr;
+    return qMax(1.0, edge ? edge->getCapacity() : 0.0) * 125000 * linkRateScale;
+}
+
+// Канал передає пакети один за одним у часі годинника черг: кожен закінчується через свій час серіалізації
+// після попереднього. Таймер лише будить канал, і за одне пробудження вирушають усі пакети, що вже закінчилися,
+// тож швидкий канал не обмежений одним пакетом на мілісекунду
+void MainWindow::serveLink(quint64 key)
+{
+    auto it = linkQueues.find(key);
+    if (it == linkQueues.end()) return;
+
+    LinkQueue& queue = it->second;
+    double now = queueClock.elapsed() / 1000.0;
+    if (!queue.busy) queue.busyUntil = qMax(queue.busyUntil, now);
+
+    std::vector<std::function<void(bool)>> finished;
+    while (!queue.scheduler.empty())
+    {
+        queue.scheduler.setRate(linkRate((int)(key >> 32), (int)(quint32)key));
+
+        auto item = queue.scheduler.dequeue(queue.busyUntil);
+        queue.busyUntil += queue.scheduler.transmissionTime(item.bytes);
+
+        if (queue.busyUntil <= now)
+        {
+            finished.push_back(item.payload);
+            continue;
+        }
+
+        queue.inService = item.payload;
+        break;
+    }
+
+    queue.busy = (bool)queue.inService;
+    int run = queueRun;
+
+    if (queue.busy)
+    {
+        int delay = qMax(1, (int)std::ceil((queue.busyUntil - now) * 1000));
+        QTimer::singleShot(delay, this, [=]()
+                           {
+                               // Черги скинуто під час передачі: пакет уже завершено як втрачений
+                               if (run != queueRun) return;
+
+                               std::function<void(bool)> send;
+                               send.swap(linkQueues[key].inService);
+                               send(false);
+                               if (run == queueRun) serveLink(key);
+                           });
+    }
+
+    // Відправка може знову поставити пакети в черги, тож виконується після оновлення стану каналу
+    for (auto& send : finished)
+    {
+        if (run != queueRun) return;
+        send(false);
+    }
+}
+
+// Пакети, що ще стоять у чергах, губляться, щоб їхні відправники не чекали вічно
+void MainWindow::resetLinkQueues()
+{
+    queueRun++;
+    queueClock.start();
+
+    std::unordered_map<quint64, LinkQueue> pending;
+    pending.swap(linkQueues);
+
+    for (auto& entry : pending)
+    {
+        if (entry.second.inService) entry.second.inService(true);
+        while (!entry.second.scheduler.empty())
+            entry.second.scheduler.dequeue(0).payload(true);
+    }
+}
+
+// Пакети, черги й таймери тримають сирі вказівники на елементи сцени, тож перед її перебудовою весь трафік завершується
+void MainWindow::quiesceTraffic()
+{
+    stopWorkload();
+    dataTimer->stop();
+    liveWindow.reset();
+    animator->cancelAll();
+    resetLinkQueues();
+    drainFibWaiters();
+    fragmenter->reset();
+    teardownCircuit();
+    telemetry.reset();
+}
+
+// Пакети, що чекають на FIB, губляться до очищення сцени: скасування запитів під час видалення вузлів на це не розраховує
+void MainWindow::drainFibWaiters()
+{
+    fibRun++;
+
+    QHash<int, std::vector<std::function<void(bool)>>> pending;
+    pending.swap(fibWaiters);
+
+    for (auto& waiters : pending)
+        for (auto& resume : waiters)
+            resume(false);
+}
+
+bool MainWindow::sendDatagram(int id, int size, int sourceId, int destId, std::function<void(bool)> onDone, int trafficClass)
+{
+    Node *startNode = networkScene->node(sourceId);
+    if (!startNode) return false;
+
+    Packet *pkt = new Packet(id, size, DATA);
+    pkt->setSource(sourceId);
+    pkt->setDestination(destId);
+    pkt->setTrafficClass(trafficClass);
+    if (!onDone) payload.attach(pkt, sourceId, destId, currentPacketSize - packetHeaderBytes);
+    networkScene->addItem(pkt);
+    pkt->setPos(startNode->pos());
+    pkt->setVisible(true);
+
+    int runId = telemetry.runId;
+    telemetry.packetsSent++;
+    telemetry.bytesSent += size + packetHeaderBytes;
+    telemetry.inFlight++;
+
+    QPointer<Packet> alive(pkt);
+    std::function<void(bool, int)> done = [=](bool lost, int lostNode)
+    {
+        if (telemetry.runId == runId)
+        {
+            telemetry.inFlight--;
+            if (!lost) telemetry.payloadDelivered += size;
+        }
+
+        if (alive)
+        {
+            networkScene->removeItem(pkt);
+            delete pkt;
+        }
+
+        if (onDone)
+            onDone(!lost);
+        else if (lost)
+            ui->textLog->append("xx [LOSS] Пакет #" + QString::number(id) + " втрачено на шляху до вузла " + QString::number(lostNode));
+        else
+            onPacketDelivered(id, size, DATA);
+    };
+
+    // З PMTUD ділить лише джерело, за MTU шляху, який йому повідомили маршрутизатори
+    int mtu = fragmenter->sourceMtu(sourceId, destId);
+    if (mtu > 0 && size + packetHeaderBytes > mtu)
+        fragmenter->fragment(pkt, sourceId, 64, mtu, done);
+    else
+        forwardDatagram(pkt, sourceId, 64, done);
+
+    return true;
+}
+
+// Запит скасовується кожною зміною топології, зокрема оновленням адаптивних вартостей і запланованою відмовою.
+// Тоді таблицю рахують заново над новою топологією; пакети губляться, лише якщо вузла вже немає або маршрут не порахувати
+void MainWindow::requestForwardingTable(int nodeId)
+{
+    int run = fibRun;
+    quint64 version = networkScene->topologyVersion();
+
+    routing->requestTree(nodeId, routingState->minHops(), [=](std::shared_ptr<const RoutingResult> result)
+                         {
+                             // Очікувачів уже злито разом зі старою топологією
+                             if (run != fibRun || !fibWaiters.contains(nodeId)) return;
+
+                             Node *current = networkScene->node(nodeId);
+                             if (!result && current && networkScene->topologyVersion() != version)
+                             {
+                                 // Скасування приходить посеред зміни сцени, тож новий запит - з наступної ітерації циклу подій
+                                 QTimer::singleShot(0, this, [=]()
+                                                    {
+                                                        if (run != fibRun || !fibWaiters.contains(nodeId)) return;
+
+                                                        if (networkScene->node(nodeId))
+                                                        {
+                                                            requestForwardingTable(nodeId);
+                                                            return;
+                                                        }
+
+                                                        std::vector<std::function<void(bool)>> waiters = fibWaiters.take(nodeId);
+                                                        for (auto& resume : waiters)
+                                                            resume(false);
+                                                    });
+                                 return;
+                             }
+
+                             if (result && current) current->setForwardingTable(result);
+
+                             std::vector<std::function<void(bool)>> waiters = fibWaiters.take(nodeId);
+                             for (auto& resume : waiters)
+                                 resume(result && current);
+                         });
+}
+
+void MainWindow::forwardDatagram(Packet *pkt, int nodeId, int ttl, std::function<void(bool, int)> done)
+{
+    Node *node = networkScene->node(nodeId);
+
+    if (!node || ttl <= 0)
+    {
+        done(true, nodeId);
+        return;
+    }
+
+    if (!node->isUp())
+    {
+        outageLost++;
+        done(true, nodeId);
+        return;
+    }
+
+    if (nodeId == pkt->getDestination())
+    {
+        if (!payload.verify(pkt))
+        {
+            ui->textLog->append("xx [CRC] Вузол " + QString::number(nodeId) + " відкинув спотворений пакет #" +
+                                QString::number(pkt->getSequenceNumber()));
+            done(true, nodeId);
+            return;
+        }
+
+        done(false, 0);
+        return;
+    }
+
+    if (!node->hasForwardingTable())
+    {
+        // Пакет чекає на вузлі, поки для нього порахують таблицю; один запит на вузол
+        bool requested = fibWaiters.contains(nodeId);
+        fibWaiters[nodeId].push_back([=](bool ready)
+                                     {
+                                         if (ready)
+                                             forwardDatagram(pkt, nodeId, ttl, done);
+                                         else
+                                             done(true, nodeId);
+                                     });
+        if (!requested) requestForwardingTable(nodeId);
+        return;
+    }
+
+    int nextId = node->nextHop(pkt->getDestination());
+    Node *next = networkScene->node(nextId);
+
+    // Основний канал мертвий, а FIB ще стара: у режимі LFA вузол одразу бере запасний крок, не чекаючи SPF
+    if (next && recoveryMode == FastRerouteRecovery && !linkUsable(node, next))
+    {
+        Node *backup = networkScene->node(node->backupHop(pkt->getDestination()));
+        if (backup && linkUsable(node, backup))
+        {
+            next = backup;
+            nextId = backup->getId();
+            fastReroutes++;
+        }
+    }
+
+    if (!next)
+    {
+        ui->textLog->append("xx [DROP] Вузол " + QString::number(nodeId) + " не має маршруту до " + QString::number(pkt->getDestination()));
+        done(true, nodeId);
+        return;
+    }
+
+    int mtu = linkMtu(node, next);
+    if (mtu > 0 && pkt->getDataSize() + packetHeaderBytes > mtu)
+    {
+        fragmenter->oversized(pkt, nodeId, nextId, ttl, mtu, done);
+        return;
+    }
+
+    transmit(pkt, nodeId, nextId, [=](bool lost)
+             {
+                 if (lost)
+                     done(true, nextId);
+                 else
+                     forwardDatagram(pkt, nextId, ttl - 1, done);
+             });
+}
+
+int MainWindow::linkMtu(Node *from, Node *to) const
+{
+    Edge *edge = from->edgeTo(to);
+    return edge ? edge->getMtu() : 0;
+}
+
+// 0 - жоден канал шляху не обмежує розмір пакета
+int MainWindow::pathMinMtu(const std::vector<int>& path) const
+{
+    int result = 0;
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+    {
+        Node *from = networkScene->node(path[i]);
+        Node *to = networkScene->node(path[i + 1]);
+        int mtu = from && to ? linkMtu(from, to) : 0;
+        if (mtu > 0 && (result == 0 || mtu < result)) result = mtu;
+    }
+    return result;
+}
+
+void MainWindow::sendLabelledPacket(int id, int size, PacketType type, int nodeId, int label, bool isRetransmission)
+{
+    if (isRetransmission)
+    {
+        ui->textLog->append("!! [RETRY] Повторна відправка пакету #" + QString::number(id));
+    }
+
+    Node *startNode = networkScene->node(nodeId);
+    if (!startNode) return;
+
+    Packet *pkt = new Packet(id, size, type);
+    pkt->setLabel(label);
+    if (type == DATA && !currentPath.empty()) payload.attach(pkt, circuitIngress, currentPath.back(), currentPacketSize - packetHeaderBytes);
+    networkScene->addItem(pkt);
+    pkt->setPos(startNode->pos());
+    pkt->setVisible(true);
+
+    int runId = telemetry.runId;
+    telemetry.packetsSent++;
+    telemetry.bytesSent += size + packetHeaderBytes;
+    telemetry.inFlight++;
+    if (isRetransmission) telemetry.retransmissions++;
+
+    QPointer<Packet> alive(pkt);
+    forwardLabelled(pkt, nodeId, [=](bool lost, int fromNode, int toNode)
+                    {
+                        if (telemetry.runId == runId)
+                        {
+                            telemetry.inFlight--;
+                            if (!lost && type == DATA) telemetry.payloadDelivered += size;
+                        }
+
+                        // Пакет міг зникнути разом зі сценою; тоді політ скасовано, і він рахується втраченим
+                        int heldLabel = alive ? pkt->getLabel() : -1;
+                        bool marked = alive && pkt->isCongestionMarked();
+                        if (alive)
+                        {
+                            networkScene->removeItem(pkt);
+                            delete pkt;
+                        }
+
+                        bool windowed = liveWindow && type == DATA && telemetry.runId == runId;
+
+                        if (!lost)
+                        {
+                            if (windowed) onCircuitDataAcked(id, marked);
+                            onPacketDelivered(id, size, type);
+                            return;
+                        }
+
+                        ui->textLog->append("xx [LOSS] Пакет #" + QString::number(id) + " втрачено на шляху до вузла " + QString::number(toNode));
+                        if (windowed) onCircuitDataLost(id);
+
+                        // Дані повторюються від вхідного вузла; DISCONNECT - від вузла, де записи ще не зняті
+                        QTimer::singleShot(1500, this, [=]() {
+                            if (telemetry.runId != runId) return;
+                            if (type == DISCONNECT)
+                                sendLabelledPacket(id, size, type, fromNode, heldLabel, true);
+                            else
+                                sendLabelledPacket(id, size, type, circuitIngress, circuitLabel, true);
+                        });
+                    });
+}
+
+// Пакет несе лише мітку: кожен вузол за O(1) знаходить наступний вузол і вихідну мітку
+void MainWindow::forwardLabelled(Packet *pkt, int nodeId, std::function<void(bool, int, int)> done)
+{
+    Node *node = networkScene->node(nodeId);
+    const CircuitEntry *entry = node ? node->circuit(pkt->getLabel()) : nullptr;
+
+    if (!entry)
+    {
+        done(true, nodeId, nodeId);
+        return;
+    }
+
+    if (entry->nextNode < 0)
+    {
+        if (!payload.verify(pkt))
+        {
+            ui->textLog->append("xx [CRC] Вузол " + QString::number(nodeId) + " відкинув спотворений пакет #" +
+                                QString::number(pkt->getSequenceNumber()));
+            done(true, nodeId, nodeId);
+            return;
+        }
+
+        if (pkt->getType() == DISCONNECT) node->releaseCircuit(pkt->getLabel());
+        done(false, nodeId, 0);
+        return;
+    }
+
+    int nextId = entry->nextNode;
+    int outLabel = entry->outLabel;
+    Node *next = networkScene->node(nextId);
+
+    if (!next || outLabel < 0)
+    {
+        done(true, nodeId, nextId);
+        return;
+    }
+
+    transmit(pkt, nodeId, nextId, [=](bool lost)
+             {
+                 if (lost)
+                 {
+                     done(true, nodeId, nextId);
+                     return;
+                 }
+
+                 if (pkt->getType() == DISCONNECT)
+                 {
+                     if (Node *from = networkScene->node(nodeId))
+                         from->releaseCircuit(pkt->getLabel());
+                 }
+
+                 pkt->setLabel(outLabel);
+                 forwardLabelled(pkt, nextId, done);
+             });
+}
+
+void MainWindow::onPacketDelivered(int id, int size, PacketType type)
+{
+    QString timeStr = QDateTime::currentDateTime().toString("hh:mm:ss");
 
     if (isVirtualMode)
     {
         if (type == CONN_REQ)
         {
             ui->textLog->append(timeStr + " >> [REQ] Запит доставлено.");
-            QTimer::singleShot(500, this, &MainWindow::stepHandshakeAck);
+            int run = telemetry.runId;
+            QTimer::singleShot(500, this, [=]() { if (telemetry.runId == run) stepHandshakeAck(); });
         }
         else if (type == CONN_ACK)
         {
             ui->textLog->append(timeStr + " >> [ACK] З'єднання встановлено!");
-            QTimer::singleShot(500, this, &MainWindow::startDataTransmission);
+            int run = telemetry.runId;
+            QTimer::singleShot(500, this, [=]() { if (telemetry.runId == run) startDataTransmission(); });
         }
         else if (type == DATA)
         {
             ui->textLog->append(timeStr + " >> [DATA] Пакет #" + QString::number(id) + " доставлено.");
 
-            std::vector<int> pathBack = currentPath;
-            std::reverse(pathBack.begin(), pathBack.end());
-
             ui->textLog->append("<< [ACK] Підтвердження для пакету #" + QString::number(id) + " відправлено.");
 
             packetsDeliveredCount++;
@@ -434,6 +3093,8 @@ void MainWindow::onPacketDelivered(int id, int size, PacketType type)
         else if (type == DISCONNECT)
         {
             ui->textLog->append(timeStr + " >> [FIN] З'єднання розірвано.");
+            circuitIngress = -1;
+            circuitLabel = -1;
             ui->textLog->append("--------------------------------------------------");
             ui->textLog->append("[FINISH] Симуляцію завершено успішно.");
             logToTable(true);
@@ -450,66 +3111,25 @@ void MainWindow::onPacketDelivered(int id, int size, PacketType type)
     }
 }
 
-QAbstractAnimation* MainWindow::createPacketAnim(Packet* pkt, std::vector<int> path, int errorRate)
-{
-    QSequentialAnimationGroup *seq = new QSequentialAnimationGroup;
-
-    for (size_t k = 0; k < path.size() - 1; ++k)
-    {
-        int id1 = path[k];
-        int id2 = path[k+1];
-        QPointF p1, p2;
-
-        QList<QGraphicsItem*> items = ui->graphicsView->scene()->items();
-        for(auto *item : items)
-        {
-            Node *n = dynamic_cast<Node*>(item);
-            if (n)
-            {
-                if (n->getId() == id1) p1 = n->pos();
-                if (n->getId() == id2) p2 = n->pos();
-            }
-        }
-
-        QPropertyAnimation *moveAnim = new QPropertyAnimation(pkt, "pos");
-        moveAnim->setDuration(1000);
-        moveAnim->setStartValue(p1);
-        moveAnim->setEndValue(p2);
-        moveAnim->setEasingCurve(QEasingCurve::InOutQuad);
-
-        int randomVal = rand() % 100;
-        if (randomVal < errorRate)
-        {
-            QParallelAnimationGroup *lossGroup = new QParallelAnimationGroup;
-            lossGroup->addAnimation(moveAnim);
-
-            QPropertyAnimation *fadeAnim = new QPropertyAnimation(pkt, "opacity");
-            fadeAnim->setDuration(1000);
-            fadeAnim->setStartValue(1.0);
-            fadeAnim->setEndValue(0.0);
-            lossGroup->addAnimation(fadeAnim);
-
-            seq->addAnimation(lossGroup);
-
-            pkt->setProperty("isLost", true);
-            pkt->setProperty("lostNode", id2);
-            break;
-        }
-        else
-        {
-            seq->addAnimation(moveAnim);
-        }
-    }
-    return seq;
-}
-
 void MainWindow::showChartServiceTraffic()
 {
     int msgSize = ui->spinMsgSize->value();
-    bool isVirtual = ui->rbVirtual->isChecked();
-    int headerSize = 40;
+    int headerSize = packetHeaderBytes;
 
-    std::vector<std::pair<double, double>> data;
+    std::vector<std::pair<double, double>> datagramData;
+    std::vector<std::pair<double, double>> virtualData;
+    std::vector<std::pair<double, double>> fragmentedData;
+    std::vector<std::pair<double, double>> discoveryData;
+
+    // MTU каналів останнього шляху: відправник не знає їх і шле пакети свого MTU
+    std::vector<int> hopMtus;
+    for (size_t i = 0; i + 1 < currentPath.size(); ++i)
+    {
+        Node *from = networkScene->node(currentPath[i]);
+        Node *to = networkScene->node(currentPath[i + 1]);
+        hopMtus.push_back(from && to ? linkMtu(from, to) : 0);
+    }
+    int minMtu = pathMinMtu(currentPath);
 
     for (int mtu = 50; mtu <= 1500; mtu += 10)
     {
@@ -519,35 +3139,64 @@ void MainWindow::showChartServiceTraffic()
         int packets = (msgSize + maxPayload - 1) / maxPayload;
 
         int serviceTraffic = packets * headerSize;
-        if (isVirtual) serviceTraffic += (3 * headerSize);
 
-        data.push_back({(double)mtu, (double)serviceTraffic});
+        datagramData.push_back({(double)mtu, (double)serviceTraffic});
+        virtualData.push_back({(double)mtu, (double)(serviceTraffic + 3 * headerSize)});
+
+        if (minMtu <= 0) continue;
+
+        int lastPayload = msgSize - (packets - 1) * maxPayload;
+        int fragments = (packets - 1) * Fragmentation::fragmentsAlongPath(maxPayload, hopMtus) +
+                        Fragmentation::fragmentsAlongPath(lastPayload, hopMtus);
+        if (fragments > 0) fragmentedData.push_back({(double)mtu, (double)(fragments * headerSize)});
+
+        int discoveredPayload = qMin(mtu, minMtu) - headerSize;
+        if (discoveredPayload > 0)
+            discoveryData.push_back({(double)mtu, (double)(((msgSize + discoveredPayload - 1) / discoveredPayload) * headerSize)});
     }
 
     ChartWindow *w = new ChartWindow("Залежність службового трафіку від MTU", "Розмір пакету (MTU), байт", "Службовий трафік, байт", this);
-    w->setData(data);
+    w->addSeries("Дейтаграмний", datagramData);
+    w->addSeries("Віртуальний канал", virtualData);
+    if (!fragmentedData.empty()) w->addSeries("Фрагментація на шляху", fragmentedData);
+    if (!discoveryData.empty()) w->addSeries("PMTUD (MTU шляху " + QString::number(minMtu) + ")", discoveryData);
     w->show();
 }
 
 void MainWindow::showChartPacketsCount()
 {
     int msgSize = ui->spinMsgSize->value();
-    int headerSize = 40;
+    int headerSize = packetHeaderBytes;
 
-    std::vector<std::pair<double, double>> data;
+    QList<int> errorRates = {0, 10, 20, 40};
+    int currentError = ui->spinErrorProb->value();
+    if (!errorRates.contains(currentError) && currentError < 100)
+    {
+        errorRates.append(currentError);
+        std::sort(errorRates.begin(), errorRates.end());
+    }
 
-    for (int mtu = 50; mtu <= 1500; mtu += 10)
+    ChartWindow *w = new ChartWindow("Залежність кількості пакетів від MTU", "Розмір пакету (MTU), байт", "Кількість пакетів, шт", this);
+
+    for (int error : errorRates)
     {
-        int maxPayload = mtu - headerSize;
-        if (maxPayload <= 0) continue;
+        double prob = (double)error / 100.0;
 
-        int packets = (msgSize + maxPayload - 1) / maxPayload;
+        std::vector<std::pair<double, double>> data;
+
+        for (int mtu = 50; mtu <= 1500; mtu += 10)
+        {
+            int maxPayload = mtu - headerSize;
+            if (maxPayload <= 0) continue;
+
+            int packets = (msgSize + maxPayload - 1) / maxPayload;
 
-        data.push_back({(double)mtu, (double)packets});
+            data.push_back({(double)mtu, (double)packets / (1.0 - prob)});
+        }
+
+        w->addSeries("Помилки " + QString::number(error) + "%", data);
     }
 
-    ChartWindow *w = new ChartWindow("Залежність кількості пакетів від MTU", "Розмір пакету (MTU), байт", "Кількість пакетів, шт", this);
-    w->setData(data);
     w->show();
 }
 
@@ -555,29 +3204,36 @@ void MainWindow::showChartErrorDependence()
 {
     int msgSize = ui->spinMsgSize->value();
     int mtu = ui->spinPacketSize->value();
-    bool isVirtual = ui->rbVirtual->isChecked();
-    int headerSize = 40;
+    int headerSize = packetHeaderBytes;
 
     if (mtu <= headerSize) return;
 
     int maxPayload = mtu - headerSize;
     int packets = (msgSize + maxPayload - 1) / maxPayload;
 
-    int baseTraffic = msgSize + (packets * headerSize);
-    if (isVirtual) baseTraffic += (3 * headerSize);
+    int datagramTraffic = msgSize + (packets * headerSize);
+    int virtualTraffic = datagramTraffic + (3 * headerSize);
 
-    std::vector<std::pair<double, double>> data;
+    std::vector<std::pair<double, double>> datagramData;
+    std::vector<std::pair<double, double>> virtualData;
 
     for (int error = 0; error <= 80; error += 2)
     {
         double prob = (double)error / 100.0;
 
-        double totalTraffic = (double)baseTraffic / (1.0 - prob);
-
-        data.push_back({(double)error, totalTraffic});
+        datagramData.push_back({(double)error, (double)datagramTraffic / (1.0 - prob)});
+        virtualData.push_back({(double)error, (double)virtualTraffic / (1.0 - prob)});
     }
 
     ChartWindow *w = new ChartWindow("Залежність трафіку від ймовірності помилок", "Ймовірність помилки, %", "Загальний трафік (прогноз), байт", this);
-    w->setData(data);
+    w->addSeries("Дейтаграмний", datagramData);
+    w->addSeries("Віртуальний канал", virtualData);
+    w->show();
+}
+
+void MainWindow::showLiveCharts()
+{
+    LiveChartWindow *w = new LiveChartWindow(&telemetry, this);
+    w->setAttribute(Qt::WA_DeleteOnClose);
     w->show();
 }
@@ -2,13 +2,37 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QPropertyAnimation>
-#include <QSequentialAnimationGroup>
-#include <QParallelAnimationGroup>
 #include <vector>
+#include <functional>
+#include <memory>
 #include <QTimer>
+#include <QPointer>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <atomic>
+#include <unordered_map>
 #include "packet.h"
 #include "chartwindow.h"
+#include "telemetry.h"
+#include "workload.h"
+#include "failureschedule.h"
+#include "convergence.h"
+#include "linkstate.h"
+#include "distancevector.h"
+#include "linkscheduler.h"
+#include "congestioncontrol.h"
+#include "flowsimulation.h"
+#include "payloadchannel.h"
+
+class Edge;
+class NetworkScene;
+class PacketAnimator;
+class LayoutWorker;
+class RoutingService;
+class RoutingState;
+class AdaptiveRouting;
+class DatagramFragmenter;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -22,15 +46,37 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
     Ui::MainWindow *ui;
+    NetworkScene *networkScene;
+    PacketAnimator *animator;
+    QPointer<LayoutWorker> layoutWorker;
+    RoutingState *routingState;
+    RoutingService *routing;
+    AdaptiveRouting *adaptive;
+    int routeRequest;
     QTimer *dataTimer;
 
     std::vector<int> currentPath;
+    std::shared_ptr<const std::vector<int>> currentRoute;
+
+    // Вхідний вузол і мітка поточного віртуального каналу; setupLabel - мітка на останньому вузлі, до якого дійшов CONN_REQ
+    int circuitIngress;
+    int circuitLabel;
+    int setupLabel;
+    // Канали шляху, допущені CAC: між сусідніми вузлами їх може бути кілька; порожньо - перший канал до сусіда
+    std::vector<Edge*> circuitLinks;
     int currentMsgSize;
     int currentPacketSize;
     int currentErrorRate;
 
+    // Смуга, що резервується для віртуального каналу (0 - без резервування), і її пріоритет 0..7
+    double circuitBandwidth;
+    int circuitPriority;
+
     int packetsSentCount;
     int packetsDeliveredCount;
     int totalPacketsToSend;
@@ -39,15 +85,137 @@ private:
     double calculatedTime;
     int calculatedServiceTraffic;
 
+    Telemetry telemetry;
+
+    // Усі випадкові рішення прогону - функції цього зерна, тож прогін можна точно повторити
+    quint64 simulationSeed;
+
+    // Навантаження з матриці трафіку: потоки беруться з генератора, коли настає їхній час
+    struct ActiveFlow
+    {
+        Flow flow;
+        int bytesLeft;
+        int trafficClass;
+    };
+
+    static const int workloadTickMs = 20;
+
+    std::unique_ptr<WorkloadGenerator> workload;
+    QTimer *workloadTimer;
+    QElapsedTimer workloadClock;
+    Flow pendingFlow;
+    bool hasPendingFlow;
+    std::vector<ActiveFlow> activeFlows;
+    int workloadRun;
+    double workloadLoad;
+
+    qint64 workloadFlows;
+    qint64 workloadPackets;
+    qint64 workloadDelivered;
+    qint64 workloadLost;
+    qint64 workloadBytes;
+    qint64 workloadLatencyMs;
+
+    // Заплановані відмови: відлік від запуску розкладу; відмова вважається відновленою,
+    // коли опубліковано покоління маршрутизації, що вже бачить її
+    struct Outage
+    {
+        QString what;
+        qint64 failedAt;
+        quint64 topologyVersion;
+        qint64 lostBefore;
+        qint64 reroutesBefore;
+        int affected;
+        int covered;
+    };
+
+    RecoveryMode recoveryMode;
+    QString failureScheduleText;
+    int failureRun;
+    QElapsedTimer failureClock;
+    std::vector<Outage> outages;
+    qint64 outageLost;
+    qint64 fastReroutes;
+
+    // Вихідні черги каналів, по одній на напрямок; без черг пакет вирушає одразу
+    struct LinkQueue
+    {
+        LinkScheduler<std::function<void(bool)>> scheduler;
+        bool busy;
+        std::function<void(bool)> inService;    // пакет, що зараз передається каналом
+        double busyUntil;                       // с годинника черг, коли канал закінчить передачу
+    };
+
+    bool linkQueuing;
+    SchedulerParams schedulerParams;
+    int interactiveShare;
+    double linkRateScale;               // частка ємності, з якою передають черги; менша - щоб перевантажити канали
+    std::unordered_map<quint64, LinkQueue> linkQueues;
+    int queueRun;
+    QElapsedTimer queueClock;
+
+    // Вікно перевантаження живого віртуального каналу; без нього дані йдуть за таймером раз на секунду
+    bool congestionControl;
+    CongestionParams congestionParams;
+    int ecnThreshold;
+    std::unique_ptr<CongestionWindow> liveWindow;
+    QHash<int, qint64> liveSentAt;      // номер пакета -> мс від старту передачі; -1 після втрати
+    int liveInFlight;
+    std::vector<CwndSample> cwndTrace;  // останнє трасування: живий канал або експеримент
+
+    DatagramFragmenter *fragmenter;
+
+    PayloadChannel payload;
+
+    // Експерименти з протоколами маршрутизації йдуть у фоні над знімком топології
+    QThreadPool experimentPool;
+    std::shared_ptr<std::atomic<bool>> experimentCancelled;
+
+    // Пакети, що чекають на FIB вузла, який ще рахується
+    QHash<int, std::vector<std::function<void(bool)>>> fibWaiters;
+    int fibRun;
+
     void startSimulation();
+    void startConstrainedCircuit(int sourceId, int destId);
+    void beginTransmission(const std::vector<int>& path, int pathCost, const std::vector<Edge*>& links = {});
+    void showRoutingTable(int nodeId);
     void startDataTransmission();
     void sendNextDataPacket();
+    void sendWindow();
+    void onCircuitDataAcked(int id, bool marked);
+    void onCircuitDataLost(int id);
+    void traceWindow();
 
     void stepHandshakeReq();
     void stepHandshakeAck();
     void stepDisconnect();
 
-    void sendSinglePacket(int id, int size, PacketType type, std::vector<int> path, bool isRetransmission = false);
+    using Route = std::shared_ptr<const std::vector<int>>;
+
+    void sendSinglePacket(int id, int size, PacketType type, Route path, bool isRetransmission = false,
+                          std::function<void(size_t)> onArrive = nullptr);
+    void advancePacket(Packet *pkt, Route path, size_t hop, std::function<void(size_t)> onArrive, std::function<void(bool, int)> done);
+
+    void sendLabelledPacket(int id, int size, PacketType type, int nodeId, int label, bool isRetransmission = false);
+    void forwardLabelled(Packet *pkt, int nodeId, std::function<void(bool, int, int)> done);
+
+    bool sendDatagram(int id, int size, int sourceId, int destId, std::function<void(bool)> onDone = nullptr,
+                      int trafficClass = BulkClass);
+    void forwardDatagram(Packet *pkt, int nodeId, int ttl, std::function<void(bool, int)> done);
+    void installForwardingTables();
+    bool linkDrops(Node *from, Node *to, int packetBytes);
+    void transmit(Packet *pkt, int fromId, int toId, std::function<void(bool)> arrived);
+    void serveLink(quint64 key);
+    double linkRate(int fromId, int toId) const;
+    void resetLinkQueues();
+    int linkMtu(Node *from, Node *to) const;
+    int pathMinMtu(const std::vector<int>& path) const;
+    void quiesceTraffic();
+    void drainFibWaiters();
+    void requestForwardingTable(int nodeId);
+
+    void installCircuitHop(size_t hop);
+    void teardownCircuit();
 
     void onPacketDelivered(int id, int size, PacketType type);
     void checkCompletion();
@@ -58,7 +226,63 @@ private:
     void showChartServiceTraffic();
     void showChartPacketsCount();
     void showChartErrorDependence();
+    void showLiveCharts();
+
+    void showGeneratorDialog();
+    void editSimulationSeed();
+
+    void showWorkloadDialog();
+    void startWorkload(const WorkloadParams& params);
+    void stopWorkload();
+    void workloadTick();
+    void finishWorkloadIfDone();
+
+    void showFailureDialog();
+    void startFailureSchedule(const std::vector<FailureEvent>& events);
+    void applyFailureEvent(const FailureEvent& event);
+    void restoreAllFailures();
+    void countProtected(Node *from, Node *to, bool excludeTarget, int& affected, int& covered);
+    void checkRecovery();
+
+    void showSchedulerDialog();
+    void logQueueStats();
+
+    void showCongestionDialog();
+    void showFlowExperimentDialog();
+    void runFlowExperiment(const FlowSimulationParams& params);
+    void exportCwndTrace();
+
+    void showMtuDialog();
+    void assignMixedMtus();
+    void logFragmentationStats();
+
+    void showPayloadDialog();
+    void logPayloadStats();
+    void runChecksumBenchmark();
+
+    void showAdaptiveDialog();
+    void stopAdaptiveRouting();
+    void logAdaptiveStats();
+
+    void showLinkStateDialog();
+    void runLinkStateExperiment(const LinkStateParams& params);
+    void showProtocolComparisonDialog();
+    void runProtocolComparison(const DistanceVectorParams& params);
+    bool prepareExperiment(Topology& topology, int& link, int maxRouters);
+    void startExperiment(const QString& label, std::function<std::function<void()>(const std::atomic<bool>*)> job);
+    int experimentLink(const Topology& topology);
+    void logConvergenceReport(const QString& title, const std::vector<ConvergenceStats>& report);
+
+    void showCircuitBandwidthDialog();
+    void showCapacityDialog();
+    void runCapacityExperiment(int requests, double minBandwidth, double maxBandwidth, int highPriorityShare);
+
+    void saveTopology();
+    void loadTopology();
+    void importTopology();
 
-    QAbstractAnimation* createPacketAnim(Packet* pkt, std::vector<int> path, int errorRate);
+    void runAutoLayout();
+    void applyLayout(const QList<int>& nodeIds, const QList<QPointF>& positions);
+    void stopAutoLayout();
 };
 #endif // MAINWINDOW_H
@@ -1,25 +1,27 @@
 #include "network.h"
 #include "node.h"
 #include "edge.h"
+#include "topologysnapshot.h"
+#include "counterrng.h"
 
-#include <cstdlib>
 #include <vector>
-#include <ctime>
+#include <QRectF>
+#include <QHash>
 
-int getRandomWeight()
+int getRandomWeight(CounterRng& rng)
 {
     int weights[] = {3, 5, 6, 7, 8, 10, 11, 15, 18, 21};
-    int index = rand() % 10;
+    int index = rng.below(10);
     return weights[index];
 }
 
-void connectNodes(Node* n1, Node* n2, QGraphicsScene* scene)
+void connectNodes(Node* n1, Node* n2, QGraphicsScene* scene, CounterRng& rng)
 {
     if (!n1 || !n2) return;
 
-    int weight = getRandomWeight();
+    int weight = getRandomWeight(rng);
 
-    EdgeType type = (rand() % 100 < 30) ? HalfDuplex : Duplex;
+    EdgeType type = (rng.below(100) < 30) ? HalfDuplex : Duplex;
 
     if (type == HalfDuplex)
     {
@@ -33,10 +35,12 @@ void connectNodes(Node* n1, Node* n2, QGraphicsScene* scene)
     n2->addEdge(edge);
 }
 
-void Network::generate(QGraphicsScene *scene)
+void Network::generate(QGraphicsScene *scene, uint64_t seed)
 {
     scene->clear();
 
+    CounterRng rng(seed);
+
     int regions = 3;
     int nodesPerRegion = 9;
     int currentId = 1;
@@ -69,9 +73,10 @@ void Network::generate(QGraphicsScene *scene)
         for (int i = 0; i < nodesPerRegion; ++i)
         {
             Node *node = new Node(currentId++);
+            node->setRegion(r);
 
-            int x = centerX + (rand() % 400 - 200);
-            int y = centerY + (rand() % 400 - 200);
+            int x = centerX + (rng.below(400) - 200);
+            int y = centerY + (rng.below(400) - 200);
 
             node->setPos(x, y);
             scene->addItem(node);
@@ -83,17 +88,17 @@ void Network::generate(QGraphicsScene *scene)
         {
             Node* n1 = currentRegionNodes[i];
             Node* n2 = currentRegionNodes[(i + 1) % nodesPerRegion];
-            connectNodes(n1, n2, scene);
+            connectNodes(n1, n2, scene, rng);
         }
 
         for (int k = 0; k < 4; ++k)
         {
-            int idx1 = rand() % nodesPerRegion;
-            int idx2 = rand() % nodesPerRegion;
+            int idx1 = rng.below(nodesPerRegion);
+            int idx2 = rng.below(nodesPerRegion);
 
             if (idx1 != idx2)
             {
-                connectNodes(currentRegionNodes[idx1], currentRegionNodes[idx2], scene);
+                connectNodes(currentRegionNodes[idx1], currentRegionNodes[idx2], scene, rng);
             }
         }
 
@@ -102,8 +107,140 @@ void Network::generate(QGraphicsScene *scene)
 
     if (regionGateways.size() >= 3)
     {
-        connectNodes(regionGateways[0], regionGateways[1], scene);
-        connectNodes(regionGateways[1], regionGateways[2], scene);
-        connectNodes(regionGateways[2], regionGateways[0], scene);
+        connectNodes(regionGateways[0], regionGateways[1], scene, rng);
+        connectNodes(regionGateways[1], regionGateways[2], scene, rng);
+        connectNodes(regionGateways[2], regionGateways[0], scene, rng);
+    }
+}
+
+void Network::generate(QGraphicsScene *scene, const GeneratorParams& params)
+{
+    build(scene, TopologyGenerator::generate(params));
+}
+
+void Network::build(QGraphicsScene *scene, const Topology& topology)
+{
+    scene->clear();
+
+    // Без BSP-індексу під час масового додавання, індекс перебудовується один раз у кінці
+    QGraphicsScene::ItemIndexMethod indexMethod = scene->itemIndexMethod();
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+
+    std::vector<Node*> nodes;
+    nodes.reserve(topology.nodes.size());
+
+    QRectF bounds;
+
+    for (const TopologyNode& tn : topology.nodes)
+    {
+        Node *node = new Node(tn.id);
+        node->setRegion(tn.region);
+        node->setPos(tn.x, tn.y);
+        scene->addItem(node);
+        nodes.push_back(node);
+
+        bounds |= QRectF(tn.x - 50, tn.y - 50, 100, 100);
+    }
+
+    for (const TopologyEdge& te : topology.edges)
+    {
+        if (te.source < 0 || te.dest < 0 || te.source >= (int)nodes.size() || te.dest >= (int)nodes.size()) continue;
+
+        Node *n1 = nodes[te.source];
+        Node *n2 = nodes[te.dest];
+
+        Edge *edge = new Edge(n1, n2, te.weight, te.type);
+        edge->setCapacity(te.capacity);
+        edge->setMtu(te.mtu);
+        scene->addItem(edge);
+
+        n1->addEdge(edge);
+        n2->addEdge(edge);
+    }
+
+    scene->setItemIndexMethod(indexMethod);
+    scene->setSceneRect(bounds.united(QRectF(-500, -500, 1000, 1000)));
+}
+
+Topology Network::capture(QGraphicsScene *scene, bool routingView, std::vector<Edge*> *links)
+{
+    Topology topology;
+    QHash<Node*, int> indexOf;
+    QList<Edge*> edges;
+
+    foreach (QGraphicsItem *item, scene->items(Qt::AscendingOrder))
+    {
+        if (Node *node = dynamic_cast<Node*>(item))
+        {
+            indexOf.insert(node, (int)topology.nodes.size());
+            topology.nodes.push_back({node->getId(), node->pos().x(), node->pos().y(), node->getRegion()});
+        }
+        else if (Edge *edge = dynamic_cast<Edge*>(item))
+        {
+            edges.append(edge);
+        }
+    }
+
+    topology.edges.reserve(edges.size());
+    if (links) links->clear();
+    for (Edge *edge : edges)
+    {
+        if (!indexOf.contains(edge->sourceNode()) || !indexOf.contains(edge->destNode())) continue;
+        if (routingView && (!edge->isUp() || !edge->sourceNode()->isUp() || !edge->destNode()->isUp())) continue;
+        topology.edges.push_back({indexOf.value(edge->sourceNode()), indexOf.value(edge->destNode()),
+                                  routingView ? edge->getCost() : edge->getWeight(), edge->getType(), edge->getCapacity(), edge->getMtu()});
+        if (links) links->push_back(edge);
+    }
+
+    return topology;
+}
+
+bool Network::save(QGraphicsScene *scene, const QString& path, QString *error)
+{
+    QList<Node*> nodes;
+    QList<Edge*> edges;
+
+    foreach (QGraphicsItem *item, scene->items(Qt::AscendingOrder))
+    {
+        if (Node *node = dynamic_cast<Node*>(item))
+            nodes.append(node);
+        else if (Edge *edge = dynamic_cast<Edge*>(item))
+            edges.append(edge);
     }
+
+    QHash<Node*, int> indexOf;
+    indexOf.reserve(nodes.size());
+    for (int i = 0; i < nodes.size(); ++i)
+        indexOf.insert(nodes[i], i);
+
+    SnapshotWriter writer;
+    if (!writer.open(path, nodes.size(), edges.size()))
+    {
+        if (error) *error = writer.errorString();
+        return false;
+    }
+
+    for (Node *node : nodes)
+        writer.addNode(node->getId(), node->pos().x(), node->pos().y(), node->getRegion());
+
+    for (Edge *edge : edges)
+        writer.addEdge(indexOf.value(edge->sourceNode(), -1), indexOf.value(edge->destNode(), -1), edge->getWeight(), edge->getType(),
+                       edge->getCapacity(), edge->getMtu());
+
+    if (!writer.finish())
+    {
+        if (error) *error = writer.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<const TopologySnapshot> Network::load(QGraphicsScene *scene, const QString& path, QString *error)
+{
+    std::shared_ptr<const TopologySnapshot> snapshot = TopologySnapshot::open(path, error);
+    if (!snapshot) return nullptr;
+
+    build(scene, snapshot->toTopology());
+    return snapshot;
 }
@@ -2,11 +2,27 @@
 #define NETWORK_H
 
 #include <QGraphicsScene>
+#include <memory>
+#include "topology.h"
+#include "topologygenerator.h"
+
+class Edge;
+class TopologySnapshot;
 
 class Network
 {
 public:
-    static void generate(QGraphicsScene *scene);
+    static void generate(QGraphicsScene *scene, uint64_t seed);
+    static void generate(QGraphicsScene *scene, const GeneratorParams& params);
+
+    static void build(QGraphicsScene *scene, const Topology& topology);
+    // routingView - топологія очима маршрутизації: без вимкнених каналів і вузлів, з ефективними вартостями каналів
+    // links, якщо задано, отримує канал сцени для кожного ребра топології
+    static Topology capture(QGraphicsScene *scene, bool routingView = false, std::vector<Edge*> *links = nullptr);
+
+    static bool save(QGraphicsScene *scene, const QString& path, QString *error = nullptr);
+    // Повертає відкритий знімок, щоб маршрутизація працювала прямо над ним; nullptr - помилка
+    static std::shared_ptr<const TopologySnapshot> load(QGraphicsScene *scene, const QString& path, QString *error = nullptr);
 };
 
 #endif // NETWORK_H
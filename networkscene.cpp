@@ -0,0 +1,148 @@
+#include "networkscene.h"
+#include "edge.h"
+#include "node.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <utility>
+
+NetworkScene::NetworkScene(QObject *parent)
+    : QGraphicsScene(parent), version(0), versionObserved(false), indexSuspended(false), edgePathsDirty(true)
+{
+    adjustTimer = new QTimer(this);
+    adjustTimer->setSingleShot(true);
+    adjustTimer->setInterval(frameIntervalMs);
+    connect(adjustTimer, &QTimer::timeout, this, &NetworkScene::flushAdjustments);
+
+    restoreIndexTimer = new QTimer(this);
+    restoreIndexTimer->setSingleShot(true);
+    restoreIndexTimer->setInterval(250);
+    connect(restoreIndexTimer, &QTimer::timeout, this, &NetworkScene::restoreIndex);
+}
+
+NetworkScene::~NetworkScene()
+{
+    // Елементи видаляються, поки сцена ще є NetworkScene, щоб деструктори ребер могли до неї звертатися
+    clear();
+}
+
+void NetworkScene::registerNode(Node *node)
+{
+    nodesById.insert(node->getId(), node);
+    touchTopology();
+}
+
+void NetworkScene::unregisterNode(Node *node)
+{
+    auto it = nodesById.find(node->getId());
+    if (it != nodesById.end() && it.value() == node)
+        nodesById.erase(it);
+
+    movedNodes.remove(node);
+    touchTopology();
+}
+
+quint64 NetworkScene::topologyVersion() const
+{
+    versionObserved = true;
+    return version;
+}
+
+void NetworkScene::touchTopology()
+{
+    version++;
+
+    // Масова побудова сцени не повинна генерувати сигнал на кожен елемент
+    if (versionObserved)
+    {
+        versionObserved = false;
+        emit topologyChanged();
+    }
+}
+
+void NetworkScene::scheduleAdjust(Node *node)
+{
+    movedNodes.insert(node);
+    if (!adjustTimer->isActive())
+        adjustTimer->start();
+}
+
+// Кожне ребро, зачеплене переміщенням за кадр, перераховується рівно один раз
+void NetworkScene::flushAdjustments()
+{
+    adjustTimer->stop();
+    if (movedNodes.isEmpty()) return;
+
+    QSet<Edge*> edges;
+    for (Node *node : std::as_const(movedNodes))
+        for (Edge *edge : node->edges())
+            edges.insert(edge);
+    movedNodes.clear();
+
+    if (edges.size() > indexSuspendThreshold && itemIndexMethod() == BspTreeIndex)
+    {
+        setItemIndexMethod(NoIndex);
+        indexSuspended = true;
+    }
+
+    for (Edge *edge : std::as_const(edges))
+        edge->adjust();
+
+    if (indexSuspended)
+        restoreIndexTimer->start();
+}
+
+void NetworkScene::restoreIndex()
+{
+    if (!indexSuspended) return;
+
+    flushAdjustments();
+    indexSuspended = false;
+    setItemIndexMethod(BspTreeIndex);
+}
+
+void NetworkScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
+{
+    QGraphicsScene::mouseReleaseEvent(event);
+
+    flushAdjustments();
+    restoreIndexTimer->stop();
+    restoreIndex();
+}
+
+void NetworkScene::rebuildEdgePaths()
+{
+    duplexPath = QPainterPath();
+    halfDuplexPath = QPainterPath();
+
+    foreach (QGraphicsItem *item, items())
+    {
+        Edge *edge = dynamic_cast<Edge*>(item);
+        if (!edge) continue;
+
+        QPainterPath &path = (edge->getType() == HalfDuplex) ? halfDuplexPath : duplexPath;
+        path.moveTo(edge->line().p1());
+        path.lineTo(edge->line().p2());
+    }
+
+    edgePathsDirty = false;
+}
+
+void NetworkScene::drawBackground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsScene::drawBackground(painter, rect);
+
+    qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    if (lod >= edgeBatchLod) return;
+
+    if (edgePathsDirty) rebuildEdgePaths();
+
+    static const QPen duplexPen(Qt::black, 0);
+    static const QPen halfDuplexPen(Qt::darkGray, 0);
+
+    painter->setBrush(Qt::NoBrush);
+    painter->setPen(duplexPen);
+    painter->drawPath(duplexPath);
+    painter->setPen(halfDuplexPen);
+    painter->drawPath(halfDuplexPath);
+}
@@ -0,0 +1,71 @@
+#ifndef NETWORKSCENE_H
+#define NETWORKSCENE_H
+
+#include <QGraphicsScene>
+#include <QHash>
+#include <QPainterPath>
+#include <QSet>
+#include <QTimer>
+
+class Node;
+
+class NetworkScene : public QGraphicsScene
+{
+    Q_OBJECT
+
+public:
+    explicit NetworkScene(QObject *parent = nullptr);
+    ~NetworkScene();
+
+    // Нижче цього масштабу ребра малюються сценою одним шляхом, а не кожне окремо
+    static constexpr qreal edgeBatchLod = 0.35;
+    static constexpr qreal labelLod = 0.6;
+
+    // Якщо за кадр зсувається більше ребер, BSP-індекс вимикається до кінця перетягування
+    static const int indexSuspendThreshold = 200;
+    static const int frameIntervalMs = 16;
+
+    void markEdgesDirty() { edgePathsDirty = true; }
+
+    void registerNode(Node *node);
+    void unregisterNode(Node *node);
+    Node *node(int id) const { return nodesById.value(id, nullptr); }
+    QList<Node*> nodes() const { return nodesById.values(); }
+
+    void scheduleAdjust(Node *node);
+    void flushAdjustments();
+
+    // Зростає при кожній зміні вузлів, ребер чи ваг; переміщення вузлів топологію не змінюють
+    quint64 topologyVersion() const;
+    void touchTopology();
+
+signals:
+    // Випускається один раз після того, як поточну версію хтось прочитав
+    void topologyChanged();
+    void routingTableRequested(int nodeId);
+
+protected:
+    void drawBackground(QPainter *painter, const QRectF &rect) override;
+    void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
+
+private:
+    QHash<int, Node*> nodesById;
+
+    quint64 version;
+    mutable bool versionObserved;
+
+    QSet<Node*> movedNodes;
+    QTimer *adjustTimer;
+    QTimer *restoreIndexTimer;
+    bool indexSuspended;
+
+    void restoreIndex();
+
+    bool edgePathsDirty;
+    QPainterPath duplexPath;
+    QPainterPath halfDuplexPath;
+
+    void rebuildEdgePaths();
+};
+
+#endif // NETWORKSCENE_H
@@ -1,21 +1,27 @@
 #include "node.h"
 #include "edge.h"
-#include "dijkstra.h"
+#include "networkscene.h"
+#include "routingservice.h"
+#include "topologysnapshot.h"
 
 #include <QGraphicsScene>
-#include <QDialog>
-#include <QTableWidget>
-#include <QVBoxLayout>
-#include <QHeaderView>
+#include <QStyleOptionGraphicsItem>
 
-Node::Node(int id) : id(id)
+Node::Node(int id) : id(id), region(0), up(true), activeCircuits(0)
 {
     setFlag(ItemIsMovable);
     setFlag(ItemSendsGeometryChanges);
     setFlag(ItemIsSelectable);
+    setCacheMode(DeviceCoordinateCache);
     sprite.load(":/image/router.png");
 }
 
+Node::~Node()
+{
+    if (NetworkScene *networkScene = dynamic_cast<NetworkScene*>(scene()))
+        networkScene->unregisterNode(this);
+}
+
 void Node::addEdge(Edge *edge)
 {
     edgeList << edge;
@@ -32,126 +38,194 @@ QList<Edge *> Node::edges() const
     return edgeList;
 }
 
-QRectF Node::boundingRect() const
+void Node::setUp(bool isUp)
 {
-    return QRectF(-35, -45, 70, 70);
+    if (up == isUp) return;
+
+    up = isUp;
+    update();
+    for (Edge *edge : edgeList)
+        edge->update();
+
+    if (NetworkScene *networkScene = dynamic_cast<NetworkScene*>(scene()))
+        networkScene->touchTopology();
 }
 
-void Node::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+int Node::allocateCircuit(int nextNode, double bandwidth, Edge *link)
 {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
+    int label;
+    if (!freeLabels.empty())
+    {
+        label = freeLabels.back();
+        freeLabels.pop_back();
+    }
+    else
+    {
+        label = (int)circuits.size();
+        circuits.push_back(CircuitEntry());
+    }
 
-    painter->drawPixmap(-30, -20, 60, 40, sprite);
+    if (!link && nextNode >= 0) link = edgeTo(nextNode);
 
-    QRectF textRect(-15, -42, 30, 20);
+    circuits[label] = {nextNode, -1, bandwidth, true, link};
+    activeCircuits++;
+    return label;
+}
 
-    painter->setBrush(QColor(0, 100, 255));
-    painter->setPen(Qt::NoPen);
-    painter->drawRoundedRect(textRect, 5, 5);
+void Node::setCircuitOutLabel(int label, int outLabel)
+{
+    if (label < 0 || label >= (int)circuits.size() || !circuits[label].active) return;
 
-    painter->setPen(Qt::white);
-    painter->setFont(QFont("Arial", 9, QFont::Bold));
-    painter->drawText(textRect, Qt::AlignCenter, QString::number(id));
+    CircuitEntry& entry = circuits[label];
+    if (entry.outLabel < 0 && entry.bandwidth > 0 && edgeList.contains(entry.link))
+        entry.link->reserve(entry.bandwidth);
 
-    if (isSelected())
-    {
-        painter->setPen(QPen(Qt::yellow, 2, Qt::DashLine));
-        painter->setBrush(Qt::NoBrush);
-        painter->drawRect(boundingRect());
-    }
+    entry.outLabel = outLabel;
 }
 
-QVariant Node::itemChange(GraphicsItemChange change, const QVariant &value)
+const CircuitEntry *Node::circuit(int label) const
 {
-    if (change == ItemPositionChange)
-        foreach (Edge *edge, edgeList)
-            edge->adjust();
-    return QGraphicsItem::itemChange(change, value);
+    if (label < 0 || label >= (int)circuits.size() || !circuits[label].active) return nullptr;
+    return &circuits[label];
 }
 
-void Node::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
+void Node::releaseCircuit(int label)
 {
-    QList<Node*> allNodes;
-    foreach (QGraphicsItem *item, scene()->items())
-    {
-        Node *n = dynamic_cast<Node*>(item);
-        if (n) allNodes.append(n);
-    }
+    if (label < 0 || label >= (int)circuits.size() || !circuits[label].active) return;
 
-    std::vector<RoutingEntry> tableData;
+    const CircuitEntry& entry = circuits[label];
+    // Канал міг бути видалений разом із резервуванням
+    if (entry.outLabel >= 0 && entry.bandwidth > 0 && edgeList.contains(entry.link))
+        entry.link->release(entry.bandwidth);
 
-    if (Dijkstra::useMinHops)
-    {
-        tableData = Dijkstra::calculateMinHops(this, allNodes);
-    }
-    else
-    {
-        tableData = Dijkstra::calculate(this, allNodes);
-    }
+    circuits[label].active = false;
+    freeLabels.push_back(label);
+    activeCircuits--;
+}
 
-    QDialog *tableWindow = new QDialog();
-    QString algoName = Dijkstra::useMinHops ? " (Min Hops)" : " (Weight)";
-    tableWindow->setWindowTitle("Таблиця маршрутизації роутера #" + QString::number(id) + algoName);
-    tableWindow->resize(700, 450);
+int Node::nextHop(int destinationId) const
+{
+    if (!fib) return -1;
 
-    QTableWidget *table = new QTableWidget();
+    int dest = fib->snapshot->indexOf(destinationId);
+    if (dest < 0 || fib->firstHop[dest] < 0) return -1;
 
-    table->setColumnCount(4);
-    table->setHorizontalHeaderLabels({"Direction", "Next Hop", "Full Path", "Metric"});
+    return fib->snapshot->nodes()[fib->firstHop[dest]].id;
+}
 
-    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
-    table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
-    table->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
-    table->horizontalHeader()->setSectionResizeMode(3, QHeaderView::ResizeToContents);
+int Node::backupHop(int destinationId) const
+{
+    if (!fib || fib->backupHop.empty()) return -1;
 
-    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    int dest = fib->snapshot->indexOf(destinationId);
+    if (dest < 0 || fib->backupHop[dest] < 0) return -1;
 
-    table->setRowCount(tableData.size());
+    return fib->snapshot->nodes()[fib->backupHop[dest]].id;
+}
 
-    std::sort(tableData.begin(), tableData.end(), [](const RoutingEntry& a, const RoutingEntry& b) {
-        return a.destinationID < b.destinationID;
-    });
+Edge *Node::edgeTo(const Node *other) const
+{
+    for (Edge *edge : edgeList)
+        if (edge->sourceNode() == other || edge->destNode() == other)
+            return edge;
+    return nullptr;
+}
 
-    for (int i = 0; i < tableData.size(); ++i)
+Edge *Node::edgeTo(int otherId) const
+{
+    for (Edge *edge : edgeList)
     {
-        RoutingEntry entry = tableData[i];
+        Node *other = edge->sourceNode() == this ? edge->destNode() : edge->sourceNode();
+        if (other && other->getId() == otherId) return edge;
+    }
+    return nullptr;
+}
+
+QRectF Node::boundingRect() const
+{
+    return QRectF(-35, -45, 70, 70);
+}
+
+void Node::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
 
-        QString dirStr = QString::number(id) + " -> " + QString::number(entry.destinationID);
+    static const QFont labelFont("Arial", 9, QFont::Bold);
+    static const QPen selectionPen(Qt::yellow, 2, Qt::DashLine);
 
-        QString nextHopStr = (entry.fullPath.size() > 1) ? QString::number(entry.fullPath[1]) : "-";
+    qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
 
-        QString pathStr = "";
-        for (int k = 0; k < entry.fullPath.size(); ++k)
+    if (!up) painter->setOpacity(0.35);
+
+    if (lod < NetworkScene::edgeBatchLod)
+    {
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(isSelected() ? QColor(Qt::yellow) : QColor(0, 100, 255));
+        painter->drawRect(QRectF(-20, -20, 40, 40));
+        return;
+    }
+
+    painter->drawPixmap(-30, -20, 60, 40, sprite);
+
+    if (lod < NetworkScene::labelLod)
+    {
+        if (isSelected())
         {
-            pathStr += QString::number(entry.fullPath[k]);
-            if (k < entry.fullPath.size() - 1) pathStr += " -> ";
+            painter->setPen(selectionPen);
+            painter->setBrush(Qt::NoBrush);
+            painter->drawRect(boundingRect());
         }
+        return;
+    }
 
-        QString costStr = QString::number(entry.totalCost);
+    QRectF textRect(-15, -42, 30, 20);
 
-        QTableWidgetItem *itemDir = new QTableWidgetItem(dirStr);
-        QTableWidgetItem *itemNext = new QTableWidgetItem(nextHopStr);
-        QTableWidgetItem *itemPath = new QTableWidgetItem(pathStr);
-        QTableWidgetItem *itemCost = new QTableWidgetItem(costStr);
+    painter->setBrush(QColor(0, 100, 255));
+    painter->setPen(Qt::NoPen);
+    painter->drawRoundedRect(textRect, 5, 5);
+
+    painter->setPen(Qt::white);
+    painter->setFont(labelFont);
+    painter->drawText(textRect, Qt::AlignCenter, QString::number(id));
+
+    if (isSelected())
+    {
+        painter->setPen(selectionPen);
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRect(boundingRect());
+    }
+}
 
-        itemDir->setTextAlignment(Qt::AlignCenter);
-        itemNext->setTextAlignment(Qt::AlignCenter);
-        itemPath->setTextAlignment(Qt::AlignCenter);
-        itemCost->setTextAlignment(Qt::AlignCenter);
+QVariant Node::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    if (change == ItemPositionHasChanged)
+    {
+        if (NetworkScene *networkScene = dynamic_cast<NetworkScene*>(scene()))
+            networkScene->scheduleAdjust(this);
+        else
+            foreach (Edge *edge, edgeList)
+                edge->adjust();
+    }
 
-        table->setItem(i, 0, itemDir);
-        table->setItem(i, 1, itemNext);
-        table->setItem(i, 2, itemPath);
-        table->setItem(i, 3, itemCost);
+    if (change == ItemSceneChange)
+    {
+        if (NetworkScene *networkScene = dynamic_cast<NetworkScene*>(scene()))
+            networkScene->unregisterNode(this);
+    }
+    else if (change == ItemSceneHasChanged)
+    {
+        if (NetworkScene *networkScene = dynamic_cast<NetworkScene*>(scene()))
+            networkScene->registerNode(this);
     }
 
-    QVBoxLayout *layout = new QVBoxLayout();
-    layout->addWidget(table);
-    tableWindow->setLayout(layout);
+    return QGraphicsItem::itemChange(change, value);
+}
 
-    tableWindow->show();
+void Node::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
+{
+    // Таблицю рахує RoutingService у фоні; сцена лише передає запит вікну
+    if (NetworkScene *networkScene = dynamic_cast<NetworkScene*>(scene()))
+        emit networkScene->routingTableRequested(id);
 
     QGraphicsItem::mouseDoubleClickEvent(event);
 }
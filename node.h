@@ -4,33 +4,80 @@
 #include <QGraphicsItem>
 #include <QPainter>
 #include <QPixmap>
+#include <memory>
+#include <vector>
 
 class Edge;
+struct RoutingResult;
+
+// Запис таблиці віртуальних каналів вузла, індексований вхідною міткою
+struct CircuitEntry
+{
+    int nextNode;   // -1 на вихідному вузлі каналу
+    int outLabel;   // -1, поки наступний вузол не призначив мітку
+    double bandwidth; // резервується на каналі link, щойно відома вихідна мітка
+    bool active;
+    Edge *link;       // канал до nextNode, на який допущено запис; між вузлами їх може бути кілька
+};
 
 class Node : public QGraphicsItem
 {
 public:
     Node(int id);
+    ~Node();
 
     void addEdge(Edge *edge);
     void removeEdge(Edge *edge);
 
     QList<Edge *> edges() const;
+    Edge *edgeTo(const Node *other) const;
+    Edge *edgeTo(int otherId) const;
 
     QRectF boundingRect() const override;  //хітбокс
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
 
     int getId() const { return id; }
 
+    int getRegion() const { return region; }
+    void setRegion(int r) { region = r; }
+
+    // Вимкнений вузол відкидає всі пакети, а його канали не потрапляють у топологію маршрутизації
+    bool isUp() const { return up; }
+    void setUp(bool isUp);
+
+    // Мітки локальні для вузла й повторно використовуються після розриву каналу
+    int allocateCircuit(int nextNode, double bandwidth = 0, Edge *link = nullptr);
+    void setCircuitOutLabel(int label, int outLabel);
+    const CircuitEntry *circuit(int label) const;
+    void releaseCircuit(int label);
+    int circuitCount() const { return activeCircuits; }
+
+    // FIB вузла - масив перших кроків його дерева найкоротших шляхів, індексований вузлом призначення
+    void setForwardingTable(std::shared_ptr<const RoutingResult> table) { fib = std::move(table); }
+    bool hasForwardingTable() const { return fib != nullptr; }
+    std::shared_ptr<const RoutingResult> forwardingTable() const { return fib; }
+    int nextHop(int destinationId) const;
+
+    // Заздалегідь обчислений безпетельний запасний крок (LFA); -1, якщо захисту немає
+    int backupHop(int destinationId) const;
+
 protected:
     QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
     void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event) override;
 
 private:
     int id;
+    int region;
+    bool up;
     QPixmap sprite;
 
     QList<Edge *> edgeList;
+
+    std::vector<CircuitEntry> circuits;
+    std::vector<int> freeLabels;
+    int activeCircuits;
+
+    std::shared_ptr<const RoutingResult> fib;
 };
 
 #endif // NODE_H
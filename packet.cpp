@@ -1,7 +1,9 @@
 #include "packet.h"
 
 Packet::Packet(int sequenceNumber, int dataSize, PacketType type)
-    : seqNum(sequenceNumber), size(dataSize), type(type)
+    : seqNum(sequenceNumber), size(dataSize), type(type), label(-1), destination(-1),
+      source(-1), datagram(0), fragmentOffset(0), moreFragments(false),
+      trafficClass(type == DATA ? BulkClass : ControlClass), congestionMarked(false)
 {
     switch (type)
     {
@@ -37,7 +39,9 @@ void Packet::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QW
 
     painter->drawPixmap(-25, -20, 50, 50, sprite);
 
+    static const QFont font("Arial", 12, QFont::Bold);
+
     painter->setPen(Qt::black);
-    painter->setFont(QFont("Arial", 12, QFont::Bold));
+    painter->setFont(font);
     painter->drawText(boundingRect(), Qt::AlignCenter, QString::number(seqNum));
 }
@@ -5,6 +5,9 @@
 #include <QGraphicsItem>
 #include <QPainter>
 #include <QPixmap>
+#include <memory>
+#include "linkscheduler.h"
+#include "payloadbuffer.h"
 
 enum PacketType
 {
@@ -29,6 +32,42 @@ public:
 
     int getSequenceNumber() const { return seqNum; }
     int getDataSize() const { return size; }
+    PacketType getType() const { return type; }
+
+    // Мітка віртуального каналу на поточному вузлі; -1 для пакетів з явним маршрутом
+    int getLabel() const { return label; }
+    void setLabel(int l) { label = l; }
+
+    // Призначення дейтаграми; маршрут вибирає кожен вузол за своєю FIB
+    int getDestination() const { return destination; }
+    void setDestination(int id) { destination = id; }
+
+    // Джерело дейтаграми: йому маршрутизатор повідомляє MTU, коли пакет не вміщається (PMTUD)
+    int getSource() const { return source; }
+    void setSource(int id) { source = id; }
+
+    // Фрагмент дейтаграми datagram: зміщення даних в оригіналі й чи будуть ще фрагменти; 0 - не фрагмент
+    quint64 getDatagram() const { return datagram; }
+    int getFragmentOffset() const { return fragmentOffset; }
+    bool hasMoreFragments() const { return moreFragments; }
+    void setFragment(quint64 id, int offset, bool more)
+    {
+        datagram = id;
+        fragmentOffset = offset;
+        moreFragments = more;
+    }
+
+    // Клас у вихідних чергах каналів: керуючі пакети - ControlClass, дані - за потоком
+    int getTrafficClass() const { return trafficClass; }
+    void setTrafficClass(int c) { trafficClass = c; }
+
+    // Позначка ECN: пакет пройшов чергу, довшу за поріг
+    bool isCongestionMarked() const { return congestionMarked; }
+    void setCongestionMarked(bool marked) { congestionMarked = marked; }
+
+    // Справжні байти пакета в режимі з даними; nullptr - пакет моделюється лише розміром
+    PacketBuffer* getBuffer() const { return bytes.get(); }
+    void setBuffer(std::unique_ptr<PacketBuffer> buffer) { bytes = std::move(buffer); }
 
     void setOpacity(qreal opacity)
     {
@@ -44,6 +83,15 @@ private:
     int seqNum;
     int size;
     PacketType type;
+    int label;
+    int destination;
+    int source;
+    quint64 datagram;
+    int fragmentOffset;
+    bool moreFragments;
+    int trafficClass;
+    bool congestionMarked;
+    std::unique_ptr<PacketBuffer> bytes;
     QPixmap sprite;
 };
 
@@ -0,0 +1,238 @@
+#include "packetanimator.h"
+
+#include <QGraphicsScene>
+#include <QHash>
+#include <QPainter>
+#include <QParallelAnimationGroup>
+#include <QPropertyAnimation>
+#include <cmath>
+
+FlowOverlay::FlowOverlay()
+{
+    setZValue(9);
+}
+
+void FlowOverlay::setFlows(std::vector<Flow> &&newFlows)
+{
+    QRectF newBounds;
+    for (const Flow& flow : newFlows)
+        newBounds |= QRectF(flow.line.p1(), flow.line.p2()).normalized().adjusted(-8, -8, 8, 8);
+
+    if (newBounds != bounds)
+    {
+        prepareGeometryChange();
+        bounds = newBounds;
+    }
+
+    flows = std::move(newFlows);
+    update();
+}
+
+QRectF FlowOverlay::boundingRect() const
+{
+    return bounds;
+}
+
+void FlowOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    QPen pen;
+    pen.setCapStyle(Qt::RoundCap);
+
+    for (const Flow& flow : flows)
+    {
+        double load = std::log2(1.0 + flow.count);
+        int red = qMin(255, 150 + (int)(load * 15));
+        int green = qMax(0, 220 - (int)(load * 25));
+
+        pen.setColor(QColor(red, green, 0, 200));
+        pen.setWidthF(qMin(2.0 + load * 1.5, 14.0));
+        painter->setPen(pen);
+        painter->drawLine(flow.line);
+    }
+}
+
+PacketAnimator::PacketAnimator(QGraphicsScene *scene, QObject *parent)
+    : QObject(parent), scene(scene), batched(true), aggregated(false)
+{
+    frameTimer = new QTimer(this);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &PacketAnimator::onFrame);
+    clock.start();
+}
+
+PacketAnimator::~PacketAnimator()
+{
+}
+
+void PacketAnimator::moveHop(Packet *pkt, int fromId, int toId, QPointF from, QPointF to, int durationMs, bool lost, std::function<void(bool)> onFinished)
+{
+    if (!batched)
+    {
+        moveHopAnimated(pkt, from, to, durationMs, lost, std::move(onFinished));
+        return;
+    }
+
+    pkt->setPos(from);
+    flights.push_back({pkt, fromId, toId, from, to, clock.elapsed(), qMax(durationMs, 1), lost, std::move(onFinished)});
+
+    if (!frameTimer->isActive())
+        frameTimer->start(frameIntervalMs);
+}
+
+void PacketAnimator::moveHopAnimated(Packet *pkt, QPointF from, QPointF to, int durationMs, bool lost, std::function<void(bool)> onFinished)
+{
+    QPropertyAnimation *moveAnim = new QPropertyAnimation(pkt, "pos");
+    moveAnim->setDuration(durationMs);
+    moveAnim->setStartValue(from);
+    moveAnim->setEndValue(to);
+    moveAnim->setEasingCurve(QEasingCurve::InOutQuad);
+
+    QAbstractAnimation *anim = moveAnim;
+
+    if (lost)
+    {
+        QParallelAnimationGroup *lossGroup = new QParallelAnimationGroup;
+        lossGroup->addAnimation(moveAnim);
+
+        QPropertyAnimation *fadeAnim = new QPropertyAnimation(pkt, "opacity");
+        fadeAnim->setDuration(durationMs);
+        fadeAnim->setStartValue(1.0);
+        fadeAnim->setEndValue(0.0);
+        lossGroup->addAnimation(fadeAnim);
+
+        anim = lossGroup;
+    }
+
+    animations.insert(anim, std::move(onFinished));
+    connect(anim, &QAbstractAnimation::finished, this, [this, anim]()
+            {
+                std::function<void(bool)> callback = animations.take(anim);
+                if (callback) callback(false);
+            });
+
+    // Анімація зупиняється без finished, якщо її пакет видалили
+    connect(anim, &QObject::destroyed, this, [this, anim]()
+            {
+                std::function<void(bool)> callback = animations.take(anim);
+                if (callback) callback(true);
+            });
+
+    anim->start(QAbstractAnimation::DeleteWhenStopped);
+}
+
+void PacketAnimator::cancelAll()
+{
+    std::vector<std::function<void(bool)>> cancelled;
+
+    for (Flight &f : flights)
+        cancelled.push_back(std::move(f.onFinished));
+    flights.clear();
+    frameTimer->stop();
+
+    QHash<QAbstractAnimation*, std::function<void(bool)>> running;
+    running.swap(animations);
+    for (auto it = running.begin(); it != running.end(); ++it)
+    {
+        it.key()->stop();
+        cancelled.push_back(std::move(it.value()));
+    }
+
+    aggregated = false;
+    updateOverlay();
+
+    for (auto &callback : cancelled)
+        callback(true);
+}
+
+void PacketAnimator::onFrame()
+{
+    qint64 now = clock.elapsed();
+    bool dense = (int)flights.size() > flowDensityThreshold;
+
+    std::vector<std::pair<std::function<void(bool)>, bool>> finished;
+
+    for (size_t i = 0; i < flights.size();)
+    {
+        Flight &f = flights[i];
+
+        // Пакет видалили посеред польоту: відправник однаково має дізнатися, що він не долетів
+        if (!f.pkt)
+        {
+            finished.emplace_back(std::move(f.onFinished), true);
+            f = std::move(flights.back());
+            flights.pop_back();
+            continue;
+        }
+
+        double t = qMin(1.0, (double)(now - f.start) / f.duration);
+
+        if (f.pkt->isVisible() == dense)
+            f.pkt->setVisible(!dense);
+
+        if (!dense)
+        {
+            double eased = (t < 0.5) ? 2 * t * t : 1 - std::pow(-2 * t + 2, 2) / 2;
+            f.pkt->setPos(f.from + (f.to - f.from) * eased);
+            if (f.lost) f.pkt->setOpacity(1.0 - t);
+        }
+
+        if (t >= 1.0)
+        {
+            f.pkt->setPos(f.to);
+            finished.emplace_back(std::move(f.onFinished), false);
+            f = std::move(flights.back());
+            flights.pop_back();
+            continue;
+        }
+
+        ++i;
+    }
+
+    aggregated = dense;
+    updateOverlay();
+
+    // Зворотні виклики можуть запускати наступні стрибки, тому виконуються після проходу по масиву
+    for (auto &callback : finished)
+        callback.first(callback.second);
+
+    if (flights.empty())
+        frameTimer->stop();
+}
+
+void PacketAnimator::updateOverlay()
+{
+    if (!aggregated)
+    {
+        if (overlay) overlay->setFlows({});
+        return;
+    }
+
+    if (!overlay)
+    {
+        overlay = new FlowOverlay();
+        scene->addItem(overlay);
+    }
+
+    QHash<quint64, int> index;
+    std::vector<FlowOverlay::Flow> flows;
+
+    for (const Flight &f : flights)
+    {
+        quint64 key = ((quint64)(quint32)qMin(f.fromId, f.toId) << 32) | (quint32)qMax(f.fromId, f.toId);
+        auto it = index.find(key);
+        if (it == index.end())
+        {
+            index.insert(key, (int)flows.size());
+            flows.push_back({QLineF(f.from, f.to), 1});
+        }
+        else
+        {
+            flows[it.value()].count++;
+        }
+    }
+
+    overlay->setFlows(std::move(flows));
+}
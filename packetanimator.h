@@ -0,0 +1,94 @@
+#ifndef PACKETANIMATOR_H
+#define PACKETANIMATOR_H
+
+#include <QObject>
+#include <QGraphicsObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QTimer>
+#include <functional>
+#include <vector>
+
+#include "packet.h"
+
+class QAbstractAnimation;
+class QGraphicsScene;
+
+// Агреговані індикатори потоків: один елемент сцени малює кількість пакетів на кожному каналі
+class FlowOverlay : public QGraphicsObject
+{
+    Q_OBJECT
+
+public:
+    struct Flow
+    {
+        QLineF line;
+        int count;
+    };
+
+    FlowOverlay();
+
+    void setFlows(std::vector<Flow> &&flows);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    std::vector<Flow> flows;
+    QRectF bounds;
+};
+
+class PacketAnimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PacketAnimator(QGraphicsScene *scene, QObject *parent = nullptr);
+    ~PacketAnimator();
+
+    // Вище цієї кількості пакетів у польоті спрайти ховаються, а канали показують агрегований потік
+    static const int flowDensityThreshold = 300;
+    static const int frameIntervalMs = 16;
+
+    void setBatched(bool enabled) { batched = enabled; }
+    bool isBatched() const { return batched; }
+
+    int inFlight() const { return (int)flights.size() + animations.size(); }
+
+    // onFinished(true) - політ скасовано: пакет не долетів, і відправник має завершити його як втрачений
+    void moveHop(Packet *pkt, int fromId, int toId, QPointF from, QPointF to, int durationMs, bool lost, std::function<void(bool)> onFinished);
+
+    // Синхронно завершує всі польоти як скасовані; викликається до того, як сцена видалить пакети
+    void cancelAll();
+
+private:
+    struct Flight
+    {
+        QPointer<Packet> pkt;
+        int fromId;
+        int toId;
+        QPointF from;
+        QPointF to;
+        qint64 start;
+        int duration;
+        bool lost;
+        std::function<void(bool)> onFinished;
+    };
+
+    QGraphicsScene *scene;
+    bool batched;
+    bool aggregated;
+
+    std::vector<Flight> flights;
+    QHash<QAbstractAnimation*, std::function<void(bool)>> animations;
+    QTimer *frameTimer;
+    QElapsedTimer clock;
+    QPointer<FlowOverlay> overlay;
+
+    void onFrame();
+    void updateOverlay();
+    void moveHopAnimated(Packet *pkt, QPointF from, QPointF to, int durationMs, bool lost, std::function<void(bool)> onFinished);
+};
+
+#endif // PACKETANIMATOR_H
@@ -0,0 +1,170 @@
+#include "payloadbuffer.h"
+#include "crc32c.h"
+#include "fragmentation.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+// source, dest, sequence, length, datagram, fragmentOffset, flags, резерв, CRC32C - little-endian
+const int checksumOffset = 36;
+
+static_assert(checksumOffset + 4 == packetHeaderBytes, "заголовок на дроті має займати packetHeaderBytes");
+static_assert(packetHeaderBytes <= HeaderPool::blockBytes, "заголовок має вміщатися в блок запасу");
+
+void put32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+uint32_t get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+}
+
+PayloadSlice PayloadSlice::wrap(std::vector<uint8_t> bytes)
+{
+    PayloadSlice result;
+    result.length = bytes.size();
+    result.storage = std::make_shared<std::vector<uint8_t>>(std::move(bytes));
+    return result;
+}
+
+PayloadSlice PayloadSlice::slice(size_t from, size_t count) const
+{
+    PayloadSlice result = *this;
+    result.offset = offset + std::min(from, length);
+    result.length = std::min(count, length - std::min(from, length));
+    return result;
+}
+
+uint8_t* PayloadSlice::mutableData(bool *copied)
+{
+    bool copy = storage && storage.use_count() > 1;
+    if (copy)
+    {
+        storage = std::make_shared<std::vector<uint8_t>>(data(), data() + length);
+        offset = 0;
+    }
+
+    if (copied) *copied = copy;
+    return storage ? storage->data() + offset : nullptr;
+}
+
+uint8_t* HeaderPool::acquire()
+{
+    if (freeBlocks.empty())
+    {
+        slabs.emplace_back(new uint8_t[blockBytes * slabBlocks]);
+        counters.slabs++;
+        for (int i = slabBlocks - 1; i >= 0; --i)
+            freeBlocks.push_back(slabs.back().get() + i * blockBytes);
+    }
+
+    uint8_t *block = freeBlocks.back();
+    freeBlocks.pop_back();
+
+    counters.acquired++;
+    counters.inUse++;
+    counters.peakInUse = std::max(counters.peakInUse, counters.inUse);
+    return block;
+}
+
+void HeaderPool::release(uint8_t *block)
+{
+    freeBlocks.push_back(block);
+    counters.inUse--;
+}
+
+PacketBuffer::PacketBuffer(std::shared_ptr<HeaderPool> pool, PayloadSlice payload)
+    : PacketBuffer(std::move(pool), payload, payload)
+{
+}
+
+PacketBuffer::PacketBuffer(std::shared_ptr<HeaderPool> pool, PayloadSlice payload, PayloadSlice pristine)
+    : pool(std::move(pool)), block(this->pool->acquire()), data(std::move(payload)), pristine(std::move(pristine))
+{
+}
+
+PacketBuffer::~PacketBuffer()
+{
+    pool->release(block);
+}
+
+uint8_t* PacketBuffer::headerStart() const
+{
+    return block + HeaderPool::blockBytes - packetHeaderBytes;
+}
+
+uint32_t PacketBuffer::checksum() const
+{
+    uint32_t crc = Crc32c::compute(headerStart(), checksumOffset);
+    return Crc32c::compute(data.data(), data.size(), crc);
+}
+
+void PacketBuffer::seal(const WireHeader& header)
+{
+    uint8_t *p = headerStart();
+    put32(p, header.source);
+    put32(p + 4, header.dest);
+    put32(p + 8, header.sequence);
+    put32(p + 12, header.length);
+    put32(p + 16, (uint32_t)header.datagram);
+    put32(p + 20, (uint32_t)(header.datagram >> 32));
+    put32(p + 24, header.fragmentOffset);
+    put32(p + 28, header.flags);
+    put32(p + 32, 0);
+    put32(p + checksumOffset, checksum());
+}
+
+bool PacketBuffer::verify() const
+{
+    return get32(headerStart() + checksumOffset) == checksum();
+}
+
+WireHeader PacketBuffer::header() const
+{
+    const uint8_t *p = headerStart();
+    WireHeader header;
+    header.source = get32(p);
+    header.dest = get32(p + 4);
+    header.sequence = get32(p + 8);
+    header.length = get32(p + 12);
+    header.datagram = get32(p + 16) | ((uint64_t)get32(p + 20) << 32);
+    header.fragmentOffset = get32(p + 24);
+    header.flags = get32(p + 28);
+    return header;
+}
+
+bool PacketBuffer::intact() const
+{
+    if (data.data() == pristine.data()) return data.size() == pristine.size();
+    return data.size() == pristine.size() && std::equal(data.data(), data.data() + data.size(), pristine.data());
+}
+
+int64_t PacketBuffer::bits() const
+{
+    return ((int64_t)packetHeaderBytes + (int64_t)data.size()) * 8;
+}
+
+bool PacketBuffer::flipBit(int64_t bit)
+{
+    int64_t byte = bit / 8;
+    uint8_t mask = (uint8_t)(1u << (bit % 8));
+
+    if (byte < packetHeaderBytes)
+    {
+        headerStart()[byte] ^= mask;
+        return false;
+    }
+
+    bool copied = false;
+    uint8_t *bytes = data.mutableData(&copied);
+    bytes[byte - packetHeaderBytes] ^= mask;
+    return copied;
+}
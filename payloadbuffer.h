@@ -0,0 +1,106 @@
+#ifndef PAYLOADBUFFER_H
+#define PAYLOADBUFFER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Зріз спільного буфера повідомлення. Копії зрізів лише збільшують лічильник посилань;
+// байти копіюються тільки тоді, коли зріз змінюють, а буфер ще ділять інші (копіювання під час запису)
+class PayloadSlice
+{
+public:
+    PayloadSlice() : offset(0), length(0) {}
+
+    static PayloadSlice wrap(std::vector<uint8_t> bytes);
+
+    PayloadSlice slice(size_t from, size_t count) const;
+
+    const uint8_t* data() const { return storage ? storage->data() + offset : nullptr; }
+    size_t size() const { return length; }
+    long references() const { return storage.use_count(); }
+
+    // copied = true, якщо довелося зробити власну копію байтів
+    uint8_t* mutableData(bool *copied = nullptr);
+
+private:
+    std::shared_ptr<std::vector<uint8_t>> storage;
+    size_t offset;
+    size_t length;
+};
+
+struct HeaderPoolStats
+{
+    int64_t acquired = 0;
+    int slabs = 0;
+    int inUse = 0;
+    int peakInUse = 0;
+};
+
+// Блоки запасу під заголовки фіксованого розміру, виділені пачками й повторно використані через список вільних.
+// Не потокобезпечний: кожен потік має свій пул
+class HeaderPool
+{
+public:
+    static const int blockBytes = 64;
+    static const int slabBlocks = 256;
+
+    uint8_t* acquire();
+    void release(uint8_t *block);
+
+    const HeaderPoolStats& stats() const { return counters; }
+
+private:
+    std::vector<std::unique_ptr<uint8_t[]>> slabs;
+    std::vector<uint8_t*> freeBlocks;
+    HeaderPoolStats counters;
+};
+
+// Поля заголовка на дроті; разом із CRC32C займають packetHeaderBytes
+struct WireHeader
+{
+    uint32_t source = 0;
+    uint32_t dest = 0;
+    uint32_t sequence = 0;
+    uint32_t length = 0;
+    uint64_t datagram = 0;
+    uint32_t fragmentOffset = 0;
+    uint32_t flags = 0;
+};
+
+// Пакет з байтами: заголовок записується в кінець блоку запасу, тобто безпосередньо перед даними,
+// які лишаються зрізом буфера повідомлення. CRC32C покриває заголовок і дані.
+// pristine - ті самі байти до спотворень; за ним видно помилки, які CRC не виявила
+class PacketBuffer
+{
+public:
+    PacketBuffer(std::shared_ptr<HeaderPool> pool, PayloadSlice payload);
+    PacketBuffer(std::shared_ptr<HeaderPool> pool, PayloadSlice payload, PayloadSlice pristine);
+    ~PacketBuffer();
+
+    PacketBuffer(const PacketBuffer&) = delete;
+    PacketBuffer& operator=(const PacketBuffer&) = delete;
+
+    void seal(const WireHeader& header);
+    bool verify() const;
+    WireHeader header() const;
+
+    const PayloadSlice& payload() const { return data; }
+    const PayloadSlice& pristinePayload() const { return pristine; }
+    bool intact() const;
+
+    // Біти нумеруються від початку заголовка; true - дані довелося скопіювати перед зміною
+    int64_t bits() const;
+    bool flipBit(int64_t bit);
+
+private:
+    std::shared_ptr<HeaderPool> pool;
+    uint8_t *block;
+    PayloadSlice data;
+    PayloadSlice pristine;
+
+    uint8_t* headerStart() const;
+    uint32_t checksum() const;
+};
+
+#endif // PAYLOADBUFFER_H
@@ -0,0 +1,183 @@
+#include "payloadchannel.h"
+#include "counterrng.h"
+#include "crc32c.h"
+#include "fragmentation.h"
+#include "packet.h"
+
+#include <QElapsedTimer>
+
+#include <cmath>
+
+namespace
+{
+
+// Скільки бітів пройде без помилки до наступного інвертованого
+qint64 errorGap(CounterRng& rng, double bitErrorRate)
+{
+    if (bitErrorRate >= 1) return 0;
+    return (qint64)std::floor(std::log(1 - rng.uniform()) / std::log1p(-bitErrorRate));
+}
+
+}
+
+PayloadChannel::PayloadChannel()
+    : payloadMode(false), flipRate(1e-5), seed(0), headerPool(std::make_shared<HeaderPool>()), corruptionDraws(0)
+{
+}
+
+void PayloadChannel::configure(bool enabled, double newFlipRate)
+{
+    payloadMode = enabled;
+    flipRate = newFlipRate;
+}
+
+void PayloadChannel::reset(quint64 newSeed, int messageSize)
+{
+    seed = newSeed;
+    messagePayload = PayloadSlice();
+    counters = PayloadStats();
+    corruptionDraws = 0;
+    if (!payloadMode) return;
+
+    std::vector<uint8_t> message(messageSize);
+    CounterRng rng(seed, 0x5042);
+    for (size_t i = 0; i < message.size(); i += 8)
+    {
+        uint64_t word = rng.next64();
+        for (size_t b = 0; b < 8 && i + b < message.size(); ++b)
+            message[i + b] = (uint8_t)(word >> (8 * b));
+    }
+    messagePayload = PayloadSlice::wrap(std::move(message));
+}
+
+void PayloadChannel::attach(Packet *pkt, int sourceId, int destId, int packetPayload)
+{
+    if (!payloadMode || messagePayload.size() == 0) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    size_t offset = (size_t)(pkt->getSequenceNumber() - 1) * packetPayload;
+    auto bytes = std::make_unique<PacketBuffer>(headerPool, messagePayload.slice(offset, pkt->getDataSize()));
+
+    WireHeader header;
+    header.source = sourceId;
+    header.dest = destId;
+    header.sequence = pkt->getSequenceNumber();
+    header.length = (uint32_t)bytes->payload().size();
+    bytes->seal(header);
+
+    counters.sealNs += timer.nsecsElapsed();
+    counters.sealed++;
+    counters.sealBytes += packetHeaderBytes + bytes->payload().size();
+    pkt->setBuffer(std::move(bytes));
+}
+
+void PayloadChannel::seal(Packet *fragment, const PacketBuffer& original, int sliceOffset)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto bytes = std::make_unique<PacketBuffer>(headerPool, original.payload().slice(sliceOffset, fragment->getDataSize()),
+                                                original.pristinePayload().slice(sliceOffset, fragment->getDataSize()));
+
+    WireHeader header = original.header();
+    header.length = (uint32_t)bytes->payload().size();
+    header.datagram = fragment->getDatagram();
+    header.fragmentOffset = fragment->getFragmentOffset();
+    header.flags = fragment->hasMoreFragments() ? 1 : 0;
+    bytes->seal(header);
+
+    counters.sealNs += timer.nsecsElapsed();
+    counters.sealed++;
+    counters.sealBytes += packetHeaderBytes + bytes->payload().size();
+    fragment->setBuffer(std::move(bytes));
+}
+
+void PayloadChannel::corrupt(Packet *pkt)
+{
+    PacketBuffer *bytes = pkt->getBuffer();
+    if (!bytes || flipRate <= 0) return;
+
+    CounterRng rng(seed, 0x4246, (quint32)corruptionDraws, (quint32)(corruptionDraws >> 32));
+    corruptionDraws++;
+
+    qint64 flipped = 0;
+    for (qint64 bit = errorGap(rng, flipRate); bit < bytes->bits(); bit += 1 + errorGap(rng, flipRate))
+    {
+        if (bytes->flipBit(bit)) counters.copies++;
+        flipped++;
+    }
+
+    counters.flippedBits += flipped;
+    if (flipped) counters.corruptedPackets++;
+}
+
+bool PayloadChannel::verify(Packet *pkt)
+{
+    PacketBuffer *bytes = pkt->getBuffer();
+    if (!bytes) return true;
+
+    QElapsedTimer timer;
+    timer.start();
+    bool valid = bytes->verify();
+    counters.verifyNs += timer.nsecsElapsed();
+    counters.verified++;
+    counters.verifyBytes += packetHeaderBytes + bytes->payload().size();
+
+    if (!valid)
+        counters.detected++;
+    else if (!bytes->intact())
+        counters.undetected++;
+    return valid;
+}
+
+std::vector<ChecksumBenchmarkRow> PayloadChannel::benchmark(quint64 seed, const std::atomic<bool> *cancelled)
+{
+    const qint64 volume = 64 << 20;
+    std::vector<uint8_t> bytes(65536);
+    CounterRng rng(seed, 0x4243);
+    for (uint8_t& b : bytes)
+        b = (uint8_t)rng();
+    PayloadSlice message = PayloadSlice::wrap(bytes);
+
+    auto rate = [=](qint64 ns) { return ns > 0 ? (double)volume / ns * 1000 : 0.0; };
+    std::vector<ChecksumBenchmarkRow> rows;
+    volatile uint32_t sink = 0;
+
+    for (int size : {64, 576, 1500, 9000, 65536})
+    {
+        if (cancelled->load()) break;
+
+        qint64 rounds = volume / size;
+        QElapsedTimer timer;
+        ChecksumBenchmarkRow row = {size, 0, 0, 0, 0};
+
+        timer.start();
+        for (qint64 r = 0; r < rounds; ++r)
+            sink = sink ^ Crc32c::compute(bytes.data(), size);
+        row.hardware = rate(timer.nsecsElapsed());
+
+        timer.start();
+        for (qint64 r = 0; r < rounds; ++r)
+            sink = sink ^ Crc32c::computePortable(bytes.data(), size);
+        row.table = rate(timer.nsecsElapsed());
+
+        timer.start();
+        for (qint64 r = 0; r < rounds; ++r)
+            sink = sink ^ message.slice(0, size).data()[size - 1];
+        row.slice = rate(timer.nsecsElapsed());
+
+        timer.start();
+        for (qint64 r = 0; r < rounds; ++r)
+        {
+            std::vector<uint8_t> copy(bytes.begin(), bytes.begin() + size);
+            sink = sink ^ copy[size - 1];
+        }
+        row.copy = rate(timer.nsecsElapsed());
+
+        rows.push_back(row);
+    }
+
+    return rows;
+}
@@ -0,0 +1,82 @@
+#ifndef PAYLOADCHANNEL_H
+#define PAYLOADCHANNEL_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "payloadbuffer.h"
+
+class Packet;
+
+// Режим з байтами: повідомлення - один буфер, пакети - його зрізи; канали псують біти, одержувач перевіряє CRC32C
+struct PayloadStats
+{
+    qint64 sealed = 0;
+    qint64 verified = 0;
+    qint64 sealBytes = 0;
+    qint64 verifyBytes = 0;
+    qint64 sealNs = 0;
+    qint64 verifyNs = 0;
+    qint64 flippedBits = 0;
+    qint64 corruptedPackets = 0;
+    qint64 copies = 0;              // зрізи, що отримали власні байти перед спотворенням
+    qint64 detected = 0;
+    qint64 undetected = 0;          // CRC збіглася, а дані відрізняються від оригіналу
+};
+
+// Швидкість обробки пакета одного розміру, МБ/с
+struct ChecksumBenchmarkRow
+{
+    int size;
+    double hardware;
+    double table;
+    double slice;
+    double copy;
+};
+
+// Байти пакетів: буфер повідомлення, пул заголовків, спотворення на каналах і перевірка CRC32C
+class PayloadChannel
+{
+public:
+    PayloadChannel();
+
+    bool enabled() const { return payloadMode; }
+    double bitFlipRate() const { return flipRate; }
+
+    // flipRate - ймовірність інвертувати кожен біт на кожному каналі
+    void configure(bool enabled, double flipRate);
+
+    // Новий прогін: вміст повідомлення - функція зерна, тож спотворення повторюються разом із прогоном
+    void reset(quint64 seed, int messageSize);
+
+    // Пакет повідомлення отримує зріз буфера без копіювання й заголовок у блоці з пулу
+    void attach(Packet *pkt, int sourceId, int destId, int packetPayload);
+
+    // Фрагмент ділить байти з пакетом, з якого його вирізано; CRC рахується заново разом з новим заголовком
+    void seal(Packet *fragment, const PacketBuffer& original, int sliceOffset);
+
+    // Помилки розкидані по бітах пакета геометрично; перед першою зміною даних зріз отримує власну копію
+    void corrupt(Packet *pkt);
+
+    // Пакет без байтів вважається цілим
+    bool verify(Packet *pkt);
+
+    const PayloadStats& stats() const { return counters; }
+    const HeaderPoolStats& poolStats() const { return headerPool->stats(); }
+    const PayloadSlice& message() const { return messagePayload; }
+
+    // Скільки коштує обробка на кінцевому вузлі: CRC32C обома ядрами й зріз проти копії даних пакета
+    static std::vector<ChecksumBenchmarkRow> benchmark(quint64 seed, const std::atomic<bool> *cancelled);
+
+private:
+    bool payloadMode;
+    double flipRate;
+    quint64 seed;
+    PayloadSlice messagePayload;
+    std::shared_ptr<HeaderPool> headerPool;
+    PayloadStats counters;
+    quint64 corruptionDraws;
+};
+
+#endif // PAYLOADCHANNEL_H
@@ -0,0 +1,230 @@
+#include "routingservice.h"
+#include "network.h"
+#include "networkscene.h"
+#include "routingstate.h"
+#include "topologysnapshot.h"
+
+#include <QThread>
+#include <algorithm>
+#include <climits>
+
+std::vector<int> RoutingResult::pathTo(int targetIndex) const
+{
+    std::vector<int> path;
+    if (targetIndex < 0 || targetIndex >= (int)tree.parent.size() || tree.dist[targetIndex] == INT_MAX) return path;
+
+    const SnapshotNode *nodes = snapshot->nodes();
+    for (int v = targetIndex; v != -1; v = tree.parent[v])
+        path.push_back(nodes[v].id);
+    std::reverse(path.begin(), path.end());
+
+    return path;
+}
+
+std::shared_ptr<RoutingResult> RoutingResult::compute(std::shared_ptr<const TopologySnapshot> graph, int sourceIndex,
+                                                      bool minHops, const std::atomic<bool> *cancelled)
+{
+    auto result = std::make_shared<RoutingResult>();
+    result->snapshot = graph;
+    result->minHops = minHops;
+    result->tree = Dijkstra::shortestPathTree(*graph, sourceIndex, minHops, cancelled);
+
+    // Перший крок успадковується від батька; кожен вузол обчислюється один раз
+    int n = graph->nodeCount();
+    result->firstHop.assign(n, -1);
+    std::vector<int> chain;
+    for (int v = 0; v < n; ++v)
+    {
+        if (v == sourceIndex || result->tree.dist[v] == INT_MAX || result->firstHop[v] >= 0) continue;
+
+        int u = v;
+        while (result->firstHop[u] < 0 && result->tree.parent[u] != sourceIndex)
+        {
+            chain.push_back(u);
+            u = result->tree.parent[u];
+        }
+
+        int hop = result->firstHop[u] >= 0 ? result->firstHop[u] : u;
+        result->firstHop[u] = hop;
+        for (int w : chain)
+            result->firstHop[w] = hop;
+        chain.clear();
+    }
+
+    // Індекс знімка вже впорядкований за id, тож рядки таблиці не потрібно сортувати
+    const SnapshotIdEntry *order = graph->idOrder();
+    for (quint32 i = 0; i < graph->nodeCount(); ++i)
+    {
+        int index = order[i].index;
+        if (index != sourceIndex && result->tree.dist[index] != INT_MAX)
+            result->reachable.push_back(index);
+    }
+
+    return result;
+}
+
+// Сусід N - безпетельна альтернатива джерела S до D, якщо dist(N, D) < dist(N, S) + dist(S, D):
+// тоді N не поверне пакет назад через S. Серед таких сусідів обирається найкоротший обхід
+void RoutingResult::assignAlternates(const std::vector<std::shared_ptr<RoutingResult>>& all, const std::atomic<bool> *cancelled)
+{
+    if (all.empty()) return;
+
+    const TopologySnapshot *graph = all.front()->snapshot.get();
+    const quint32 *offsets = graph->arcOffsets();
+    const SnapshotArc *arcs = graph->arcs();
+    const SnapshotEdge *edges = graph->edges();
+    int n = (int)all.size();
+
+    for (int s = 0; s < n; ++s)
+    {
+        if (cancelled && cancelled->load()) return;
+
+        RoutingResult& source = *all[s];
+        const std::vector<int>& distS = source.tree.dist;
+        source.backupHop.assign(n, -1);
+
+        for (int d = 0; d < n; ++d)
+        {
+            if (d == s || distS[d] == INT_MAX) continue;
+
+            int primary = source.firstHop[d];
+            long long best = LLONG_MAX;
+
+            for (quint32 a = offsets[s]; a < offsets[s + 1]; ++a)
+            {
+                int neighbor = arcs[a].neighbor;
+                if (neighbor == primary || neighbor == s) continue;
+
+                const std::vector<int>& distN = all[neighbor]->tree.dist;
+                if (distN[d] == INT_MAX || distN[s] == INT_MAX) continue;
+                if ((long long)distN[d] >= (long long)distN[s] + distS[d]) continue;
+
+                long long cost = (source.minHops ? 1 : edges[arcs[a].edge].weight) + (long long)distN[d];
+                if (cost < best)
+                {
+                    best = cost;
+                    source.backupHop[d] = neighbor;
+                }
+            }
+        }
+    }
+}
+
+RoutingService::RoutingService(NetworkScene *scene, RoutingState *state, QObject *parent)
+    : QObject(parent), scene(scene), state(state), snapshotVersion(0), nextRequestId(1)
+{
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    connect(scene, &NetworkScene::topologyChanged, this, &RoutingService::cancelAll);
+}
+
+RoutingService::~RoutingService()
+{
+    for (const Request& request : std::as_const(pending))
+        request.cancelled->store(true);
+    pending.clear();
+
+    pool.waitForDone();
+}
+
+std::shared_ptr<const TopologySnapshot> RoutingService::currentSnapshot()
+{
+    quint64 version = scene->topologyVersion();
+
+    std::shared_ptr<const RoutingGeneration> generation = state->current();
+    if (generation && generation->topologyVersion == version && generation->snapshot)
+        return generation->snapshot;
+
+    if (!snapshot || snapshotVersion != version)
+    {
+        snapshot = TopologySnapshot::fromTopology(Network::capture(scene, true));
+        snapshotVersion = version;
+    }
+
+    return snapshot;
+}
+
+void RoutingService::seed(std::shared_ptr<const TopologySnapshot> graph)
+{
+    snapshot = std::move(graph);
+    snapshotVersion = scene->topologyVersion();
+}
+
+int RoutingService::requestTree(int sourceId, bool minHops, Callback onReady)
+{
+    int requestId = nextRequestId++;
+
+    Request request;
+    request.onReady = std::move(onReady);
+    request.cancelled = std::make_shared<std::atomic<bool>>(false);
+    pending.insert(requestId, request);
+
+    std::shared_ptr<const RoutingGeneration> generation = state->current();
+    if (generation && state->isFresh(*generation) && generation->minHops == minHops)
+    {
+        if (std::shared_ptr<const RoutingResult> ready = generation->result(sourceId))
+        {
+            QMetaObject::invokeMethod(this, [this, requestId, ready]() { deliver(requestId, ready); }, Qt::QueuedConnection);
+            return requestId;
+        }
+    }
+
+    std::shared_ptr<const TopologySnapshot> graph = currentSnapshot();
+    int sourceIndex = graph ? graph->indexOf(sourceId) : -1;
+
+    if (sourceIndex < 0)
+    {
+        QMetaObject::invokeMethod(this, [this, requestId]() { deliver(requestId, nullptr); }, Qt::QueuedConnection);
+        return requestId;
+    }
+
+    std::shared_ptr<std::atomic<bool>> cancelled = request.cancelled;
+
+    pool.start([this, requestId, graph, sourceIndex, minHops, cancelled]()
+               {
+                   if (cancelled->load()) return;
+
+                   std::shared_ptr<const RoutingResult> result = RoutingResult::compute(graph, sourceIndex, minHops, cancelled.get());
+                   if (cancelled->load()) return;
+
+                   QMetaObject::invokeMethod(this, [this, requestId, result]() { deliver(requestId, result); },
+                                             Qt::QueuedConnection);
+               });
+
+    return requestId;
+}
+
+void RoutingService::deliver(int requestId, std::shared_ptr<const RoutingResult> result)
+{
+    auto it = pending.find(requestId);
+    if (it == pending.end()) return;
+
+    Callback onReady = std::move(it->onReady);
+    pending.erase(it);
+
+    onReady(result);
+}
+
+void RoutingService::cancel(int requestId)
+{
+    auto it = pending.find(requestId);
+    if (it == pending.end()) return;
+
+    it->cancelled->store(true);
+    Callback onReady = std::move(it->onReady);
+    pending.erase(it);
+
+    onReady(nullptr);
+}
+
+void RoutingService::cancelAll()
+{
+    QHash<int, Request> cancelled;
+    cancelled.swap(pending);
+
+    for (Request& request : cancelled)
+    {
+        request.cancelled->store(true);
+        request.onReady(nullptr);
+    }
+}
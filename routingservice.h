@@ -0,0 +1,82 @@
+#ifndef ROUTINGSERVICE_H
+#define ROUTINGSERVICE_H
+
+#include <QObject>
+#include <QHash>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "dijkstra.h"
+
+class NetworkScene;
+class RoutingState;
+class TopologySnapshot;
+
+struct RoutingResult
+{
+    std::shared_ptr<const TopologySnapshot> snapshot;
+    ShortestPathTree tree;
+    bool minHops;
+
+    // Досяжні вузли (індекси знімка), впорядковані за id
+    std::vector<int> reachable;
+
+    // Перший крок від джерела до кожного вузла (індекс знімка, -1 якщо недосяжний) - це і є FIB вузла
+    std::vector<int> firstHop;
+
+    // Запасний перший крок (loop-free alternate) на випадок відмови основного; порожньо, якщо не рахувався
+    std::vector<int> backupHop;
+
+    std::vector<int> pathTo(int targetIndex) const;
+
+    static std::shared_ptr<RoutingResult> compute(std::shared_ptr<const TopologySnapshot> graph, int sourceIndex,
+                                                  bool minHops, const std::atomic<bool> *cancelled = nullptr);
+
+    // Потребує дерев усіх вузлів одного знімка (індекс - індекс вузла у знімку)
+    static void assignAlternates(const std::vector<std::shared_ptr<RoutingResult>>& all, const std::atomic<bool> *cancelled = nullptr);
+};
+
+// Рахує маршрути у пулі потоків над незмінним знімком топології; готові дерева бере з актуального
+// покоління RoutingState. Зворотний виклик завжди виконується рівно один раз у GUI-потоці; nullptr означає скасування
+class RoutingService : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void(std::shared_ptr<const RoutingResult>)>;
+
+    RoutingService(NetworkScene *scene, RoutingState *state, QObject *parent = nullptr);
+    ~RoutingService();
+
+    int requestTree(int sourceId, bool minHops, Callback onReady);
+
+    void cancel(int requestId);
+    void cancelAll();
+
+    // Знімок поточної топології, який не треба захоплювати зі сцени заново
+    void seed(std::shared_ptr<const TopologySnapshot> graph);
+
+private:
+    struct Request
+    {
+        Callback onReady;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    NetworkScene *scene;
+    RoutingState *state;
+    QThreadPool pool;
+
+    std::shared_ptr<const TopologySnapshot> snapshot;
+    quint64 snapshotVersion;
+
+    QHash<int, Request> pending;
+    int nextRequestId;
+
+    std::shared_ptr<const TopologySnapshot> currentSnapshot();
+    void deliver(int requestId, std::shared_ptr<const RoutingResult> result);
+};
+
+#endif // ROUTINGSERVICE_H
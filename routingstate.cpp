@@ -0,0 +1,214 @@
+#include "routingstate.h"
+#include "network.h"
+#include "networkscene.h"
+#include "topologysnapshot.h"
+
+#include <climits>
+#include <thread>
+
+namespace
+{
+
+struct WeightChange
+{
+    int source;
+    int dest;
+    int oldWeight;
+    int newWeight;
+};
+
+// Знімки з тими самими вузлами й каналами, що відрізняються лише вагами
+bool weightChanges(const TopologySnapshot& before, const TopologySnapshot& after, std::vector<WeightChange>& changes)
+{
+    if (before.nodeCount() != after.nodeCount() || before.edgeCount() != after.edgeCount()) return false;
+
+    for (quint32 i = 0; i < after.nodeCount(); ++i)
+        if (before.nodes()[i].id != after.nodes()[i].id) return false;
+
+    for (quint32 i = 0; i < after.edgeCount(); ++i)
+    {
+        const SnapshotEdge& x = before.edges()[i];
+        const SnapshotEdge& y = after.edges()[i];
+        if (x.source != y.source || x.dest != y.dest || x.type != y.type) return false;
+        if (x.weight != y.weight) changes.push_back({y.source, y.dest, x.weight, y.weight});
+    }
+
+    return true;
+}
+
+// Дерево не змінюється, якщо подорожчав канал поза ним або подешевшав канал, що не скорочує жодного шляху.
+// За метрикою кроків відстані від ваг не залежать, але вартість шляхів у дереві зміниться, якщо канал у ньому
+bool treeAffected(const ShortestPathTree& tree, bool minHops, const std::vector<WeightChange>& changes)
+{
+    for (const WeightChange& change : changes)
+    {
+        int u = change.source;
+        int v = change.dest;
+        if (tree.parent[v] == u || tree.parent[u] == v) return true;
+        if (minHops || change.newWeight > change.oldWeight) continue;
+
+        if (tree.dist[u] != INT_MAX && (long long)tree.dist[u] + change.newWeight < tree.dist[v]) return true;
+        if (tree.dist[v] != INT_MAX && (long long)tree.dist[v] + change.newWeight < tree.dist[u]) return true;
+    }
+
+    return false;
+}
+
+}
+
+std::shared_ptr<const RoutingResult> RoutingGeneration::result(int sourceId) const
+{
+    if (!snapshot || results.empty()) return nullptr;
+
+    int index = snapshot->indexOf(sourceId);
+    return index >= 0 ? results[index] : nullptr;
+}
+
+RoutingState::RoutingState(NetworkScene *scene, QObject *parent)
+    : QObject(parent), scene(scene), active(0), useMinHops(false), nextSerial(1), seededVersion(0)
+{
+    pool.setMaxThreadCount(1);
+
+    rebuildTimer = new QTimer(this);
+    rebuildTimer->setSingleShot(true);
+    rebuildTimer->setInterval(rebuildDelayMs);
+    connect(rebuildTimer, &QTimer::timeout, this, &RoutingState::rebuild);
+
+    connect(scene, &NetworkScene::topologyChanged, this, &RoutingState::scheduleRebuild);
+    scheduleRebuild();
+}
+
+RoutingState::~RoutingState()
+{
+    if (building) building->store(true);
+    pool.waitForDone();
+}
+
+// Читач позначає слот лічильником і перевіряє, що слот досі активний;
+// видавець чекає лише на читачів неактивного слота, які встигли лише скопіювати вказівник
+std::shared_ptr<const RoutingGeneration> RoutingState::current() const
+{
+    for (;;)
+    {
+        int index = active.load();
+        const Slot& slot = buffers[index];
+
+        slot.readers.fetch_add(1);
+        if (active.load() == index)
+        {
+            std::shared_ptr<const RoutingGeneration> generation = slot.generation;
+            slot.readers.fetch_sub(1);
+            return generation;
+        }
+        slot.readers.fetch_sub(1);
+    }
+}
+
+void RoutingState::publish(std::shared_ptr<const RoutingGeneration> generation)
+{
+    std::lock_guard<std::mutex> lock(publishMutex);
+
+    int index = active.load();
+    if (buffers[index].generation && buffers[index].generation->serial >= generation->serial) return;
+
+    Slot& next = buffers[1 - index];
+    while (next.readers.load() != 0)
+        std::this_thread::yield();
+
+    next.generation = std::move(generation);
+    active.store(1 - index);
+}
+
+bool RoutingState::isFresh(const RoutingGeneration& generation) const
+{
+    return generation.minHops == useMinHops && generation.topologyVersion == scene->topologyVersion();
+}
+
+void RoutingState::seed(std::shared_ptr<const TopologySnapshot> snapshot)
+{
+    seeded = std::move(snapshot);
+    seededVersion = scene->topologyVersion();
+}
+
+void RoutingState::setMinHops(bool minHops)
+{
+    if (useMinHops == minHops) return;
+
+    useMinHops = minHops;
+    scheduleRebuild();
+}
+
+void RoutingState::setRebuildDelay(int ms)
+{
+    rebuildTimer->setInterval(qMax(0, ms));
+}
+
+void RoutingState::scheduleRebuild()
+{
+    if (!rebuildTimer->isActive())
+        rebuildTimer->start();
+}
+
+void RoutingState::rebuild()
+{
+    if (building) building->store(true);
+    building = std::make_shared<std::atomic<bool>>(false);
+
+    auto generation = std::make_shared<RoutingGeneration>();
+    generation->serial = nextSerial++;
+    generation->topologyVersion = scene->topologyVersion();
+    generation->minHops = useMinHops;
+    if (seeded && seededVersion == generation->topologyVersion)
+        generation->snapshot = seeded;
+    else
+        generation->snapshot = TopologySnapshot::fromTopology(Network::capture(scene, true));
+    seeded.reset();
+
+    std::shared_ptr<std::atomic<bool>> cancelled = building;
+
+    // Попереднє покоління з тією самою метрикою дозволяє не перераховувати дерева, яких зміна ваг не зачепила
+    std::shared_ptr<const RoutingGeneration> previous = current();
+    if (previous && (previous->minHops != useMinHops || previous->results.empty())) previous.reset();
+
+    pool.start([this, generation, previous, cancelled]()
+               {
+                   const TopologySnapshot *graph = generation->snapshot.get();
+
+                   if (graph && graph->nodeCount() <= (quint32)allSourcesLimit)
+                   {
+                       std::vector<WeightChange> changes;
+                       bool incremental = previous && graph && weightChanges(*previous->snapshot, *graph, changes);
+
+                       std::vector<std::shared_ptr<RoutingResult>> trees;
+                       trees.reserve(graph->nodeCount());
+                       for (quint32 i = 0; i < graph->nodeCount(); ++i)
+                       {
+                           if (cancelled->load()) return;
+
+                           if (incremental && !treeAffected(previous->results[i]->tree, generation->minHops, changes))
+                           {
+                               auto reused = std::make_shared<RoutingResult>(*previous->results[i]);
+                               reused->snapshot = generation->snapshot;
+                               trees.push_back(reused);
+                               generation->reusedTrees++;
+                               continue;
+                           }
+
+                           trees.push_back(RoutingResult::compute(generation->snapshot, i, generation->minHops, cancelled.get()));
+                       }
+
+                       // Запасні кроки рахуються з уже готових дерев сусідів, тож перемикання при відмові - O(1)
+                       RoutingResult::assignAlternates(trees, cancelled.get());
+                       if (cancelled->load()) return;
+
+                       generation->results.assign(trees.begin(), trees.end());
+                   }
+
+                   if (cancelled->load()) return;
+
+                   quint64 serial = generation->serial;
+                   publish(generation);
+
+                   QMetaObject::invokeMethod(this, [this, serial]() { emit published(serial); }, Qt::QueuedConnection);
+               });
+}
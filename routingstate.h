@@ -0,0 +1,92 @@
+#ifndef ROUTINGSTATE_H
+#define ROUTINGSTATE_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "routingservice.h"
+
+class NetworkScene;
+class TopologySnapshot;
+
+// Незмінне покоління маршрутизації: знімок топології, метрика і дерева для всіх джерел
+struct RoutingGeneration
+{
+    quint64 serial;
+    quint64 topologyVersion;
+    bool minHops;
+    std::shared_ptr<const TopologySnapshot> snapshot;
+
+    // Індекс - індекс вузла у знімку; порожньо, якщо граф більший за allSourcesLimit
+    std::vector<std::shared_ptr<const RoutingResult>> results;
+
+    // Скільки дерев перенесено з попереднього покоління без перерахунку
+    int reusedTrees = 0;
+
+    std::shared_ptr<const RoutingResult> result(int sourceId) const;
+};
+
+// Перераховує маршрути після змін топології у фоні й публікує нове покоління
+// перемиканням між двома слотами (RCU). Читачі не беруть блокувань
+class RoutingState : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RoutingState(NetworkScene *scene, QObject *parent = nullptr);
+    ~RoutingState();
+
+    // Для більших графів таблиці рахуються на запит через RoutingService
+    static const int allSourcesLimit = 1024;
+    static const int rebuildDelayMs = 50;
+
+    // Безпечно викликати з будь-якого потоку
+    std::shared_ptr<const RoutingGeneration> current() const;
+
+    // Затримка SPF: скільки після зміни топології чекати перед перерахунком
+    int rebuildDelay() const { return rebuildTimer->interval(); }
+    void setRebuildDelay(int ms);
+
+    bool minHops() const { return useMinHops; }
+    void setMinHops(bool minHops);
+
+    // Покоління відповідає поточній топології й метриці; лише з GUI-потоку
+    bool isFresh(const RoutingGeneration& generation) const;
+
+    // Знімок, що вже описує поточну топологію (наприклад, відкритий файл): перше покоління візьме його замість захоплення сцени
+    void seed(std::shared_ptr<const TopologySnapshot> snapshot);
+
+signals:
+    void published(quint64 serial);
+
+private:
+    struct Slot
+    {
+        std::shared_ptr<const RoutingGeneration> generation;
+        mutable std::atomic<int> readers{0};
+    };
+
+    NetworkScene *scene;
+    QThreadPool pool;
+    QTimer *rebuildTimer;
+
+    Slot buffers[2];
+    std::atomic<int> active;
+    std::mutex publishMutex;
+
+    bool useMinHops;
+    quint64 nextSerial;
+    std::shared_ptr<const TopologySnapshot> seeded;
+    quint64 seededVersion;
+    std::shared_ptr<std::atomic<bool>> building;
+
+    void scheduleRebuild();
+    void rebuild();
+    void publish(std::shared_ptr<const RoutingGeneration> generation);
+};
+
+#endif // ROUTINGSTATE_H
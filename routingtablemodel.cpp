@@ -0,0 +1,62 @@
+#include "routingtablemodel.h"
+#include "topologysnapshot.h"
+
+RoutingTableModel::RoutingTableModel(std::shared_ptr<const RoutingResult> result, QObject *parent)
+    : QAbstractTableModel(parent), result(std::move(result))
+{
+    sourceId = this->result->snapshot->nodes()[this->result->tree.source].id;
+}
+
+int RoutingTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : (int)result->reachable.size();
+}
+
+int RoutingTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 4;
+}
+
+QVariant RoutingTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    if (role == Qt::TextAlignmentRole) return int(Qt::AlignCenter);
+    if (role != Qt::DisplayRole) return QVariant();
+
+    int target = result->reachable[index.row()];
+    const SnapshotNode *nodes = result->snapshot->nodes();
+
+    switch (index.column())
+    {
+    case 0:
+        return QString::number(sourceId) + " -> " + QString::number(nodes[target].id);
+    case 1:
+        return QString::number(nodes[result->firstHop[target]].id);
+    case 2:
+    {
+        std::vector<int> path = result->pathTo(target);
+
+        QString pathStr = "";
+        for (size_t k = 0; k < path.size(); ++k)
+        {
+            pathStr += QString::number(path[k]);
+            if (k < path.size() - 1) pathStr += " -> ";
+        }
+        return pathStr;
+    }
+    case 3:
+        return result->tree.cost[target];
+    }
+
+    return QVariant();
+}
+
+QVariant RoutingTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    static const char *titles[] = {"Direction", "Next Hop", "Full Path", "Metric"};
+    return (section >= 0 && section < 4) ? QString(titles[section]) : QVariant();
+}
@@ -0,0 +1,26 @@
+#ifndef ROUTINGTABLEMODEL_H
+#define ROUTINGTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <memory>
+#include "routingservice.h"
+
+// Рядки таблиці маршрутизації формуються з дерева найкоротших шляхів лише тоді, коли їх показують
+class RoutingTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit RoutingTableModel(std::shared_ptr<const RoutingResult> result, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    std::shared_ptr<const RoutingResult> result;
+    int sourceId;
+};
+
+#endif // ROUTINGTABLEMODEL_H
@@ -0,0 +1,34 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <QElapsedTimer>
+
+struct Telemetry
+{
+    int runId = 0;
+    QElapsedTimer clock;
+
+    qint64 bytesSent = 0;
+    qint64 payloadDelivered = 0;
+    qint64 packetsSent = 0;
+    qint64 retransmissions = 0;
+    int inFlight = 0;
+
+    void reset()
+    {
+        runId++;
+        bytesSent = 0;
+        payloadDelivered = 0;
+        packetsSent = 0;
+        retransmissions = 0;
+        inFlight = 0;
+        clock.start();
+    }
+
+    double simTime() const
+    {
+        return clock.isValid() ? clock.elapsed() / 1000.0 : 0.0;
+    }
+};
+
+#endif // TELEMETRY_H
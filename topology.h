@@ -0,0 +1,44 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <vector>
+
+// Мбіт/с; стільки смуги має канал, якщо її не задано явно
+const double defaultLinkCapacity = 100;
+
+// Найбільша вага (і ефективна вартість) каналу: 16 ваг - "нескінченність" дистанційно-векторної
+// маршрутизації - і суми ваг уздовж шляхів мають уміщатися в int з запасом
+const int maxLinkWeight = 1 << 24;
+
+enum EdgeType
+{
+    Duplex,
+    HalfDuplex
+};
+
+struct TopologyNode
+{
+    int id;
+    double x;
+    double y;
+    int region;
+};
+
+// source і dest - індекси у Topology::nodes, а не id вузлів
+struct TopologyEdge
+{
+    int source;
+    int dest;
+    int weight;
+    EdgeType type;
+    double capacity = defaultLinkCapacity;
+    int mtu = 0;                    // байт; 0 - канал не обмежує розмір пакета
+};
+
+struct Topology
+{
+    std::vector<TopologyNode> nodes;
+    std::vector<TopologyEdge> edges;
+};
+
+#endif // TOPOLOGY_H
@@ -0,0 +1,387 @@
+#include "topologygenerator.h"
+#include "counterrng.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <unordered_set>
+
+namespace
+{
+
+// M_PI не входить до стандарту C++
+constexpr double pi = 3.14159265358979323846;
+
+// Кожен регіон має власний лічильниковий потік, тож граф не залежить від кількості потоків.
+// Власні перетворення замість std::*_distribution: їхній результат залежить від реалізації бібліотеки
+using RegionRng = CounterRng;
+
+struct RegionGraph
+{
+    std::vector<TopologyNode> nodes;
+    std::vector<TopologyEdge> edges;
+    std::unordered_set<uint64_t> linked;
+};
+
+int randomWeight(RegionRng& rng)
+{
+    static const int weights[] = {3, 5, 6, 7, 8, 10, 11, 15, 18, 21};
+    return weights[rng.below(10)];
+}
+
+bool addEdge(RegionGraph& graph, int a, int b, RegionRng& rng, const GeneratorParams& params)
+{
+    if (a == b) return false;
+
+    uint64_t key = ((uint64_t)std::min(a, b) << 32) | (uint32_t)std::max(a, b);
+    if (!graph.linked.insert(key).second) return false;
+
+    int weight = randomWeight(rng);
+    EdgeType type = rng.uniform() < params.halfDuplexRatio ? HalfDuplex : Duplex;
+
+    if (type == HalfDuplex)
+    {
+        weight = weight * 1.5;
+    }
+
+    graph.edges.push_back({a, b, weight, type});
+    return true;
+}
+
+void placeUniform(RegionGraph& graph, int n, double side, RegionRng& rng)
+{
+    graph.nodes.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+        graph.nodes[i].x = (rng.uniform() - 0.5) * side;
+        graph.nodes[i].y = (rng.uniform() - 0.5) * side;
+    }
+}
+
+void buildRingChords(RegionGraph& graph, int n, double side, RegionRng& rng, const GeneratorParams& params)
+{
+    placeUniform(graph, n, side, rng);
+
+    if (n < 2) return;
+
+    for (int i = 0; i < n; ++i)
+        addEdge(graph, i, (i + 1) % n, rng, params);
+
+    long long chords = std::llround(n * params.averageDegree / 2.0) - n;
+    long long attempts = chords * 4;
+
+    while (chords > 0 && attempts-- > 0)
+    {
+        if (addEdge(graph, rng.below(n), rng.below(n), rng, params))
+            chords--;
+    }
+}
+
+// Ймовірність зв'язку beta * exp(-d / (alpha * L)) моделюється вибором відстані з експоненційного
+// розподілу і пошуком найближчого вузла у сітці - O(E) замість перебору всіх пар
+void buildWaxman(RegionGraph& graph, int n, double side, RegionRng& rng, const GeneratorParams& params)
+{
+    placeUniform(graph, n, side, rng);
+
+    if (n < 2) return;
+
+    int cells = std::max(1, (int)std::sqrt(n / 2.0));
+    double cellSize = side / cells;
+
+    auto cellOf = [&](double v) {
+        int c = (int)((v + side / 2) / cellSize);
+        return std::min(std::max(c, 0), cells - 1);
+    };
+
+    std::vector<int> cellStart(cells * cells + 1, 0);
+    std::vector<int> cellNodes(n);
+
+    for (int i = 0; i < n; ++i)
+        cellStart[cellOf(graph.nodes[i].y) * cells + cellOf(graph.nodes[i].x) + 1]++;
+    for (int c = 0; c < cells * cells; ++c)
+        cellStart[c + 1] += cellStart[c];
+
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < n; ++i)
+        cellNodes[fill[cellOf(graph.nodes[i].y) * cells + cellOf(graph.nodes[i].x)]++] = i;
+
+    // Зміїний обхід клітинок дає зв'язне дерево з короткими ребрами
+    int previous = -1;
+    for (int row = 0; row < cells; ++row)
+    {
+        for (int k = 0; k < cells; ++k)
+        {
+            int col = (row % 2 == 0) ? k : cells - 1 - k;
+            int c = row * cells + col;
+            for (int idx = cellStart[c]; idx < cellStart[c + 1]; ++idx)
+            {
+                if (previous >= 0) addEdge(graph, previous, cellNodes[idx], rng, params);
+                previous = cellNodes[idx];
+            }
+        }
+    }
+
+    long long extra = std::llround(n * params.averageDegree / 2.0) - (n - 1);
+    long long attempts = extra * 20;
+    double scale = params.waxmanAlpha * side * std::sqrt(2.0);
+
+    while (extra > 0 && attempts-- > 0)
+    {
+        int a = rng.below(n);
+        double distance = -std::log(1.0 - rng.uniform()) * scale;
+        double angle = rng.uniform() * 2 * pi;
+
+        double tx = graph.nodes[a].x + distance * std::cos(angle);
+        double ty = graph.nodes[a].y + distance * std::sin(angle);
+        if (std::fabs(tx) > side / 2 || std::fabs(ty) > side / 2) continue;
+
+        int cx = cellOf(tx);
+        int cy = cellOf(ty);
+        int best = -1;
+        double bestDist = 0;
+
+        for (int dy = -1; dy <= 1; ++dy)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                int x = cx + dx;
+                int y = cy + dy;
+                if (x < 0 || y < 0 || x >= cells || y >= cells) continue;
+
+                int c = y * cells + x;
+                for (int idx = cellStart[c]; idx < cellStart[c + 1]; ++idx)
+                {
+                    int b = cellNodes[idx];
+                    double ddx = graph.nodes[b].x - tx;
+                    double ddy = graph.nodes[b].y - ty;
+                    double d = ddx * ddx + ddy * ddy;
+                    if (b != a && (best < 0 || d < bestDist))
+                    {
+                        best = b;
+                        bestDist = d;
+                    }
+                }
+            }
+        }
+
+        if (best < 0 || rng.uniform() >= params.waxmanBeta) continue;
+
+        if (addEdge(graph, a, best, rng, params))
+            extra--;
+    }
+}
+
+void buildBarabasiAlbert(RegionGraph& graph, int n, double side, RegionRng& rng, const GeneratorParams& params)
+{
+    placeUniform(graph, n, side, rng);
+
+    int m = std::max(1, (int)std::llround(params.averageDegree / 2.0));
+    int seedNodes = std::min(n, m + 1);
+
+    std::vector<int> endpoints;
+    endpoints.reserve((size_t)n * m * 2);
+
+    for (int i = 0; i < seedNodes; ++i)
+    {
+        for (int j = i + 1; j < seedNodes; ++j)
+        {
+            if (addEdge(graph, i, j, rng, params))
+            {
+                endpoints.push_back(i);
+                endpoints.push_back(j);
+            }
+        }
+    }
+
+    std::vector<int> targets;
+    for (int v = seedNodes; v < n; ++v)
+    {
+        targets.clear();
+        int attempts = m * 10;
+
+        while ((int)targets.size() < m && attempts-- > 0)
+        {
+            int t = endpoints[rng.below((int)endpoints.size())];
+            if (std::find(targets.begin(), targets.end(), t) == targets.end())
+                targets.push_back(t);
+        }
+
+        for (int t : targets)
+        {
+            if (addEdge(graph, v, t, rng, params))
+            {
+                endpoints.push_back(v);
+                endpoints.push_back(t);
+            }
+        }
+    }
+}
+
+void buildFatTree(RegionGraph& graph, double side, RegionRng& rng, const GeneratorParams& params)
+{
+    int k = std::max(2, params.fatTreeK - params.fatTreeK % 2);
+    int half = k / 2;
+    int cores = half * half;
+    int n = cores + k * k;
+
+    graph.nodes.resize(n);
+
+    auto place = [&](int index, int slot, int slots, int layer) {
+        graph.nodes[index].x = ((slot + 0.5) / slots - 0.5) * side;
+        graph.nodes[index].y = (layer / 2.0 - 0.5) * side;
+    };
+
+    for (int c = 0; c < cores; ++c)
+        place(c, c, cores, 0);
+
+    for (int p = 0; p < k; ++p)
+    {
+        int agg = cores + p * k;
+        int edge = agg + half;
+
+        for (int i = 0; i < half; ++i)
+        {
+            place(agg + i, p * half + i, k * half, 1);
+            place(edge + i, p * half + i, k * half, 2);
+        }
+
+        for (int i = 0; i < half; ++i)
+            for (int j = 0; j < half; ++j)
+                addEdge(graph, edge + i, agg + j, rng, params);
+
+        for (int j = 0; j < half; ++j)
+            for (int i = 0; i < half; ++i)
+                addEdge(graph, agg + j, j * half + i, rng, params);
+    }
+}
+
+RegionGraph buildRegion(int region, const GeneratorParams& params)
+{
+    RegionRng rng(params.seed, region);
+    RegionGraph graph;
+
+    int n = TopologyGenerator::nodesInRegion(params);
+    double side = params.nodeSpacing * std::sqrt((double)std::max(n, 1));
+
+    switch (params.model)
+    {
+    case Waxman:
+        buildWaxman(graph, n, side, rng, params);
+        break;
+    case BarabasiAlbert:
+        buildBarabasiAlbert(graph, n, side, rng, params);
+        break;
+    case FatTree:
+        buildFatTree(graph, side, rng, params);
+        break;
+    case RingChords:
+    default:
+        buildRingChords(graph, n, side, rng, params);
+        break;
+    }
+
+    for (auto& node : graph.nodes)
+        node.region = region;
+
+    graph.linked.clear();
+    return graph;
+}
+
+}
+
+int TopologyGenerator::nodesInRegion(const GeneratorParams& params)
+{
+    if (params.model == FatTree)
+    {
+        int k = std::max(2, params.fatTreeK - params.fatTreeK % 2);
+        return k * k / 4 + k * k;
+    }
+    return std::max(1, params.nodesPerRegion);
+}
+
+int64_t TopologyGenerator::totalNodes(const GeneratorParams& params)
+{
+    return (int64_t)nodesInRegion(params) * std::max(1, params.regions);
+}
+
+Topology TopologyGenerator::generate(const GeneratorParams& params)
+{
+    Topology topology;
+    if (totalNodes(params) > maxNodes) return topology;
+
+    int regions = std::max(1, params.regions);
+    std::vector<RegionGraph> graphs(regions);
+
+    int workers = params.threads > 0 ? params.threads : (int)std::thread::hardware_concurrency();
+    workers = std::max(1, std::min(workers, regions));
+
+    std::atomic<int> nextRegion(0);
+    auto worker = [&]() {
+        for (int r = nextRegion++; r < regions; r = nextRegion++)
+            graphs[r] = buildRegion(r, params);
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < workers; ++i)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool)
+        t.join();
+
+    int n = nodesInRegion(params);
+    double side = params.nodeSpacing * std::sqrt((double)n);
+    double gap = side * 1.5;
+    int columns = (int)std::ceil(std::sqrt((double)regions));
+    int rows = (regions + columns - 1) / columns;
+
+    size_t totalNodes = 0;
+    size_t totalEdges = 0;
+    for (const auto& g : graphs)
+    {
+        totalNodes += g.nodes.size();
+        totalEdges += g.edges.size();
+    }
+
+    topology.nodes.reserve(totalNodes);
+    topology.edges.reserve(totalEdges + (size_t)regions * params.interRegionLinks);
+
+    std::vector<int> regionOffset(regions);
+    for (int r = 0; r < regions; ++r)
+    {
+        int offset = (int)topology.nodes.size();
+        regionOffset[r] = offset;
+
+        double cx = (r % columns - (columns - 1) / 2.0) * gap;
+        double cy = (r / columns - (rows - 1) / 2.0) * gap;
+
+        for (const auto& node : graphs[r].nodes)
+            topology.nodes.push_back({offset + (int)(&node - graphs[r].nodes.data()) + 1, node.x + cx, node.y + cy, r});
+
+        for (const auto& edge : graphs[r].edges)
+            topology.edges.push_back({edge.source + offset, edge.dest + offset, edge.weight, edge.type});
+
+        graphs[r] = RegionGraph();
+    }
+
+    if (regions < 2) return topology;
+
+    RegionRng rng(params.seed, regions);
+    RegionGraph links;
+    int pairs = (regions == 2) ? 1 : regions;
+
+    for (int r = 0; r < pairs; ++r)
+    {
+        int other = (r + 1) % regions;
+
+        for (int l = 0; l < params.interRegionLinks; ++l)
+        {
+            int a = regionOffset[r] + (l == 0 ? 0 : rng.below(n));
+            int b = regionOffset[other] + (l == 0 ? 0 : rng.below(n));
+            addEdge(links, a, b, rng, params);
+        }
+    }
+
+    topology.edges.insert(topology.edges.end(), links.edges.begin(), links.edges.end());
+    return topology;
+}
@@ -0,0 +1,46 @@
+#ifndef TOPOLOGYGENERATOR_H
+#define TOPOLOGYGENERATOR_H
+
+#include "topology.h"
+#include <cstdint>
+
+enum TopologyModel
+{
+    RingChords,
+    Waxman,
+    BarabasiAlbert,
+    FatTree
+};
+
+struct GeneratorParams
+{
+    int regions = 3;
+    int nodesPerRegion = 9;
+    TopologyModel model = RingChords;
+
+    double averageDegree = 3.0;
+    int interRegionLinks = 1;
+    double halfDuplexRatio = 0.3;
+
+    double waxmanAlpha = 0.15;
+    double waxmanBeta = 0.4;
+    int fatTreeK = 4;
+
+    double nodeSpacing = 130.0;
+    uint64_t seed = 1;
+    int threads = 0;
+};
+
+class TopologyGenerator
+{
+public:
+    // Ідентифікатори й індекси вузлів - int, а сцена з мільйонами елементів уже непрацездатна
+    static const int64_t maxNodes = 4000000;
+
+    // Порожня топологія, якщо вузлів більше за maxNodes
+    static Topology generate(const GeneratorParams& params);
+    static int nodesInRegion(const GeneratorParams& params);
+    static int64_t totalNodes(const GeneratorParams& params);
+};
+
+#endif // TOPOLOGYGENERATOR_H
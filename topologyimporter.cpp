@@ -0,0 +1,388 @@
+#include "topologyimporter.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QTextStream>
+#include <QXmlStreamReader>
+#include <cmath>
+
+namespace
+{
+
+const int defaultWeight = 10;
+const double gridSpacing = 130.0;
+const double geoScale = 40.0;
+
+int parseWeight(const QString& value)
+{
+    bool ok = false;
+    double weight = value.trimmed().toDouble(&ok);
+    if (!ok || !(weight > 0)) return defaultWeight;
+
+    // Обмеження до перетворення в int: ваги з файлу можуть бути довільно великими
+    return (int)std::lround(qBound(1.0, weight, (double)maxLinkWeight));
+}
+
+EdgeType parseType(const QString& value)
+{
+    QString v = value.trimmed().toLower();
+    if (v.contains("half") || v == "hd" || v == "h") return HalfDuplex;
+    return Duplex;
+}
+
+// Зіставляє текстові імена вузлів з id/індексами, не тримаючи в пам'яті нічого, крім самої топології
+class TopologyBuilder
+{
+public:
+    explicit TopologyBuilder(Topology& topology) : topology(topology), nextId(1) {}
+
+    int node(const QString& name)
+    {
+        auto it = indexByName.constFind(name);
+        if (it != indexByName.constEnd()) return it.value();
+
+        bool numeric = false;
+        int id = name.toInt(&numeric);
+        if (!numeric || id <= 0 || usedIds.contains(id))
+        {
+            while (usedIds.contains(nextId)) nextId++;
+            id = nextId;
+        }
+        usedIds.insert(id);
+
+        int index = (int)topology.nodes.size();
+        topology.nodes.push_back({id, 0.0, 0.0, 0});
+        positioned.push_back(false);
+        indexByName.insert(name, index);
+        return index;
+    }
+
+    void setPosition(int index, double x, double y)
+    {
+        topology.nodes[index].x = x;
+        topology.nodes[index].y = y;
+        positioned[index] = true;
+    }
+
+    void setRegion(int index, const QString& region)
+    {
+        bool numeric = false;
+        int value = region.toInt(&numeric);
+        if (!numeric)
+        {
+            if (!regions.contains(region)) regions.insert(region, regions.size());
+            value = regions.value(region);
+        }
+        topology.nodes[index].region = value;
+    }
+
+    bool addEdge(int a, int b, int weight, EdgeType type)
+    {
+        if (a == b) return false;
+
+        quint64 key = ((quint64)qMin(a, b) << 32) | (quint32)qMax(a, b);
+        if (linked.contains(key)) return false;
+        linked.insert(key);
+
+        topology.edges.push_back({a, b, weight, type});
+        return true;
+    }
+
+    void finish()
+    {
+        int unplaced = 0;
+        for (bool p : positioned)
+            if (!p) unplaced++;
+        if (unplaced == 0) return;
+
+        int columns = (int)std::ceil(std::sqrt((double)unplaced));
+        int k = 0;
+        for (size_t i = 0; i < positioned.size(); ++i)
+        {
+            if (positioned[i]) continue;
+            topology.nodes[i].x = (k % columns - columns / 2.0) * gridSpacing;
+            topology.nodes[i].y = (k / columns - columns / 2.0) * gridSpacing;
+            k++;
+        }
+    }
+
+private:
+    Topology& topology;
+    QHash<QString, int> indexByName;
+    QHash<QString, int> regions;
+    QSet<int> usedIds;
+    QSet<quint64> linked;
+    std::vector<bool> positioned;
+    int nextId;
+};
+
+enum KeyRole
+{
+    RoleNone,
+    RoleWeight,
+    RoleType,
+    RoleX,
+    RoleY,
+    RoleLongitude,
+    RoleLatitude,
+    RoleRegion
+};
+
+KeyRole roleFor(const QString& attrName)
+{
+    QString name = attrName.toLower();
+
+    if (name == "weight" || name == "cost" || name == "metric" || name == "latency" || name == "delay") return RoleWeight;
+    if (name == "type" || name == "duplex" || name == "linktype" || name == "edgetype") return RoleType;
+    if (name == "x") return RoleX;
+    if (name == "y") return RoleY;
+    if (name == "longitude" || name == "lon") return RoleLongitude;
+    if (name == "latitude" || name == "lat") return RoleLatitude;
+    if (name == "region" || name == "as" || name == "country") return RoleRegion;
+    return RoleNone;
+}
+
+}
+
+ImportFormat TopologyImporter::detectFormat(const QString& path)
+{
+    QString suffix = QFileInfo(path).suffix().toLower();
+
+    if (suffix == "graphml" || suffix == "xml") return GraphML;
+    if (suffix == "cch") return Rocketfuel;
+    return EdgeList;
+}
+
+bool TopologyImporter::importFile(const QString& path, Topology& topology, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    return import(&file, detectFormat(path), topology, error);
+}
+
+bool TopologyImporter::import(QIODevice *device, ImportFormat format, Topology& topology, QString *error)
+{
+    topology = Topology();
+
+    bool ok = false;
+    switch (format)
+    {
+    case GraphML:
+        ok = readGraphML(device, topology, error);
+        break;
+    case Rocketfuel:
+        ok = readRocketfuel(device, topology, error);
+        break;
+    case EdgeList:
+    default:
+        ok = readEdgeList(device, topology, error);
+        break;
+    }
+
+    if (ok && topology.nodes.empty())
+    {
+        if (error) *error = "Файл не містить жодного вузла";
+        return false;
+    }
+
+    return ok;
+}
+
+bool TopologyImporter::readGraphML(QIODevice *device, Topology& topology, QString *error)
+{
+    TopologyBuilder builder(topology);
+    QXmlStreamReader xml(device);
+
+    QHash<QString, KeyRole> nodeKeys;
+    QHash<QString, KeyRole> edgeKeys;
+
+    int currentNode = -1;
+    bool inEdge = false;
+    int edgeSource = -1;
+    int edgeDest = -1;
+    int edgeWeight = defaultWeight;
+    EdgeType edgeType = Duplex;
+
+    double x = 0, y = 0;
+    bool hasX = false, hasY = false;
+
+    while (!xml.atEnd())
+    {
+        xml.readNext();
+
+        if (xml.isStartElement())
+        {
+            QStringView name = xml.name();
+
+            if (name == QLatin1String("key"))
+            {
+                QXmlStreamAttributes attrs = xml.attributes();
+                KeyRole role = roleFor(attrs.value("attr.name").toString());
+                QString target = attrs.value("for").toString();
+                QString id = attrs.value("id").toString();
+
+                if (target == "node" || target == "all") nodeKeys.insert(id, role);
+                if (target == "edge" || target == "all") edgeKeys.insert(id, role);
+            }
+            else if (name == QLatin1String("node"))
+            {
+                currentNode = builder.node(xml.attributes().value("id").toString());
+                hasX = hasY = false;
+            }
+            else if (name == QLatin1String("edge"))
+            {
+                QXmlStreamAttributes attrs = xml.attributes();
+                edgeSource = builder.node(attrs.value("source").toString());
+                edgeDest = builder.node(attrs.value("target").toString());
+                edgeWeight = defaultWeight;
+                edgeType = Duplex;
+                inEdge = true;
+            }
+            else if (name == QLatin1String("data"))
+            {
+                QString key = xml.attributes().value("key").toString();
+                QString value = xml.readElementText();
+
+                if (inEdge)
+                {
+                    KeyRole role = edgeKeys.value(key, RoleNone);
+                    if (role == RoleWeight) edgeWeight = parseWeight(value);
+                    else if (role == RoleType) edgeType = parseType(value);
+                }
+                else if (currentNode >= 0)
+                {
+                    KeyRole role = nodeKeys.value(key, RoleNone);
+                    bool ok = false;
+                    double v = value.toDouble(&ok);
+
+                    if ((role == RoleX || role == RoleLongitude) && ok)
+                    {
+                        x = role == RoleX ? v : v * geoScale;
+                        hasX = true;
+                    }
+                    else if ((role == RoleY || role == RoleLatitude) && ok)
+                    {
+                        y = role == RoleY ? v : -v * geoScale;
+                        hasY = true;
+                    }
+                    else if (role == RoleRegion)
+                    {
+                        builder.setRegion(currentNode, value.trimmed());
+                    }
+                }
+            }
+        }
+        else if (xml.isEndElement())
+        {
+            QStringView name = xml.name();
+
+            if (name == QLatin1String("node"))
+            {
+                if (currentNode >= 0 && hasX && hasY) builder.setPosition(currentNode, x, y);
+                currentNode = -1;
+            }
+            else if (name == QLatin1String("edge"))
+            {
+                builder.addEdge(edgeSource, edgeDest, edgeWeight, edgeType);
+                inEdge = false;
+            }
+        }
+    }
+
+    if (xml.hasError())
+    {
+        if (error) *error = "GraphML, рядок " + QString::number(xml.lineNumber()) + ": " + xml.errorString();
+        return false;
+    }
+
+    builder.finish();
+    return true;
+}
+
+// Рядки виду "u v [вага] [тип]"; так само читаються файли ваг/затримок Rocketfuel ("місто,uid місто,uid затримка")
+bool TopologyImporter::readEdgeList(QIODevice *device, Topology& topology, QString *error)
+{
+    TopologyBuilder builder(topology);
+    QTextStream in(device);
+
+    int lineNumber = 0;
+    QString line;
+
+    while (in.readLineInto(&line))
+    {
+        lineNumber++;
+
+        QString trimmed = line.simplified();
+        if (trimmed.isEmpty() || trimmed.startsWith('#') || trimmed.startsWith('%')) continue;
+
+        QStringList tokens = trimmed.split(' ', Qt::SkipEmptyParts);
+
+        if (tokens.size() < 2)
+        {
+            if (error) *error = "Рядок " + QString::number(lineNumber) + ": очікується щонайменше два вузли";
+            return false;
+        }
+
+        int a = builder.node(tokens[0]);
+        int b = builder.node(tokens[1]);
+        int weight = tokens.size() > 2 ? parseWeight(tokens[2]) : defaultWeight;
+        EdgeType type = tokens.size() > 3 ? parseType(tokens[3]) : Duplex;
+
+        builder.addEdge(a, b, weight, type);
+    }
+
+    builder.finish();
+    return true;
+}
+
+// Формат карт Rocketfuel (.cch): "uid @місто [+] [bb] (n) [&ext] -> <nuid-1> <nuid-2> ... {-euid} =name rn"
+bool TopologyImporter::readRocketfuel(QIODevice *device, Topology& topology, QString *error)
+{
+    Q_UNUSED(error);
+
+    TopologyBuilder builder(topology);
+    QTextStream in(device);
+    QString line;
+
+    while (in.readLineInto(&line))
+    {
+        QStringList tokens = line.simplified().split(' ', Qt::SkipEmptyParts);
+        if (tokens.size() < 2 || tokens[0].startsWith('-') || tokens[0].startsWith('#')) continue;
+
+        int self = builder.node(tokens[0]);
+        bool neighbours = false;
+
+        for (int i = 1; i < tokens.size(); ++i)
+        {
+            const QString& token = tokens[i];
+
+            if (token.startsWith('@') && !neighbours)
+            {
+                builder.setRegion(self, token.mid(1));
+            }
+            else if (token == "->")
+            {
+                neighbours = true;
+            }
+            else if (neighbours && token.startsWith('<') && token.endsWith('>'))
+            {
+                builder.addEdge(self, builder.node(token.mid(1, token.size() - 2)), defaultWeight, Duplex);
+            }
+            else if (token.startsWith('='))
+            {
+                break;
+            }
+        }
+    }
+
+    builder.finish();
+    return true;
+}
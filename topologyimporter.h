@@ -0,0 +1,29 @@
+#ifndef TOPOLOGYIMPORTER_H
+#define TOPOLOGYIMPORTER_H
+
+#include <QIODevice>
+#include <QString>
+#include "topology.h"
+
+enum ImportFormat
+{
+    GraphML,
+    EdgeList,
+    Rocketfuel
+};
+
+class TopologyImporter
+{
+public:
+    static ImportFormat detectFormat(const QString& path);
+
+    static bool importFile(const QString& path, Topology& topology, QString *error = nullptr);
+    static bool import(QIODevice *device, ImportFormat format, Topology& topology, QString *error = nullptr);
+
+private:
+    static bool readGraphML(QIODevice *device, Topology& topology, QString *error);
+    static bool readEdgeList(QIODevice *device, Topology& topology, QString *error);
+    static bool readRocketfuel(QIODevice *device, Topology& topology, QString *error);
+};
+
+#endif // TOPOLOGYIMPORTER_H
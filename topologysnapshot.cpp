@@ -0,0 +1,363 @@
+#include "topologysnapshot.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace
+{
+
+const char snapshotMagic[8] = {'N', 'R', 'S', 'N', 'A', 'P', 0, 0};
+const quint32 snapshotVersion = 2;
+
+quint64 align8(quint64 value)
+{
+    return (value + 7) & ~quint64(7);
+}
+
+SnapshotHeader computeLayout(quint32 nodeCount, quint32 edgeCount)
+{
+    SnapshotHeader layout;
+    std::memcpy(layout.magic, snapshotMagic, sizeof(layout.magic));
+    layout.version = snapshotVersion;
+    layout.headerSize = sizeof(SnapshotHeader);
+    layout.nodeCount = nodeCount;
+    layout.edgeCount = edgeCount;
+
+    layout.nodesOffset = align8(sizeof(SnapshotHeader));
+    layout.edgesOffset = layout.nodesOffset + quint64(nodeCount) * sizeof(SnapshotNode);
+    layout.idIndexOffset = align8(layout.edgesOffset + quint64(edgeCount) * sizeof(SnapshotEdge));
+    layout.arcOffsetsOffset = layout.idIndexOffset + quint64(nodeCount) * sizeof(SnapshotIdEntry);
+    layout.arcsOffset = align8(layout.arcOffsetsOffset + (quint64(nodeCount) + 1) * sizeof(quint32));
+    layout.fileSize = layout.arcsOffset + quint64(edgeCount) * 2 * sizeof(SnapshotArc);
+
+    return layout;
+}
+
+}
+
+SnapshotWriter::SnapshotWriter() : data(nullptr), nodesWritten(0), edgesWritten(0)
+{
+    std::memset(&layout, 0, sizeof(layout));
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    close();
+}
+
+void SnapshotWriter::prepare(quint32 nodeCount, quint32 edgeCount)
+{
+    layout = computeLayout(nodeCount, edgeCount);
+    nodesWritten = 0;
+    edgesWritten = 0;
+    error.clear();
+}
+
+bool SnapshotWriter::open(const QString& path, quint32 nodeCount, quint32 edgeCount)
+{
+    close();
+    prepare(nodeCount, edgeCount);
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+    {
+        error = file.errorString();
+        return false;
+    }
+
+    // Файл одразу отримує кінцевий розмір і заповнюється напряму через відображення в пам'ять
+    if (!file.resize(layout.fileSize) || !(data = file.map(0, layout.fileSize)))
+    {
+        error = file.errorString();
+        file.close();
+        return false;
+    }
+
+    return true;
+}
+
+void SnapshotWriter::openBuffer(QByteArray *buffer, quint32 nodeCount, quint32 edgeCount)
+{
+    close();
+    prepare(nodeCount, edgeCount);
+
+    buffer->fill(0, layout.fileSize);
+    data = reinterpret_cast<uchar*>(buffer->data());
+}
+
+bool SnapshotWriter::addNode(int id, double x, double y, int region)
+{
+    if (!data || nodesWritten >= layout.nodeCount) return false;
+
+    SnapshotNode *node = reinterpret_cast<SnapshotNode*>(data + layout.nodesOffset) + nodesWritten;
+    node->id = id;
+    node->region = region;
+    node->x = x;
+    node->y = y;
+
+    nodesWritten++;
+    return true;
+}
+
+bool SnapshotWriter::addEdge(int source, int dest, int weight, EdgeType type, double capacity, int mtu)
+{
+    if (!data || edgesWritten >= layout.edgeCount) return false;
+    if (source < 0 || dest < 0 || (quint32)source >= layout.nodeCount || (quint32)dest >= layout.nodeCount) return false;
+
+    SnapshotEdge *edge = reinterpret_cast<SnapshotEdge*>(data + layout.edgesOffset) + edgesWritten;
+    edge->source = source;
+    edge->dest = dest;
+    edge->weight = weight;
+    edge->type = type;
+    edge->capacity = capacity;
+    edge->mtu = mtu;
+    edge->reserved = 0;
+
+    edgesWritten++;
+    return true;
+}
+
+bool SnapshotWriter::finish()
+{
+    if (!data) return false;
+
+    if (nodesWritten != layout.nodeCount || edgesWritten != layout.edgeCount)
+    {
+        error = "Кількість записаних вузлів або ребер не збігається із заявленою";
+        close();
+        return false;
+    }
+
+    quint32 n = layout.nodeCount;
+    const SnapshotNode *nodes = reinterpret_cast<const SnapshotNode*>(data + layout.nodesOffset);
+    const SnapshotEdge *edges = reinterpret_cast<const SnapshotEdge*>(data + layout.edgesOffset);
+
+    SnapshotIdEntry *idIndex = reinterpret_cast<SnapshotIdEntry*>(data + layout.idIndexOffset);
+    for (quint32 i = 0; i < n; ++i)
+        idIndex[i] = {nodes[i].id, (qint32)i};
+
+    std::sort(idIndex, idIndex + n, [](const SnapshotIdEntry& a, const SnapshotIdEntry& b) {
+        return a.id < b.id;
+    });
+
+    for (quint32 i = 1; i < n; ++i)
+    {
+        if (idIndex[i].id == idIndex[i - 1].id)
+        {
+            error = "Повторюваний id вузла: " + QString::number(idIndex[i].id);
+            close();
+            return false;
+        }
+    }
+
+    // CSR будується на місці: лічильники степенів -> префіксні суми -> розкладка дуг
+    quint32 *offsets = reinterpret_cast<quint32*>(data + layout.arcOffsetsOffset);
+    SnapshotArc *arcs = reinterpret_cast<SnapshotArc*>(data + layout.arcsOffset);
+
+    std::fill(offsets, offsets + n + 1, 0);
+    for (quint32 e = 0; e < layout.edgeCount; ++e)
+    {
+        offsets[edges[e].source + 1]++;
+        offsets[edges[e].dest + 1]++;
+    }
+    for (quint32 i = 0; i < n; ++i)
+        offsets[i + 1] += offsets[i];
+
+    for (quint32 e = 0; e < layout.edgeCount; ++e)
+    {
+        arcs[offsets[edges[e].source]++] = {edges[e].dest, (qint32)e};
+        arcs[offsets[edges[e].dest]++] = {edges[e].source, (qint32)e};
+    }
+    for (quint32 i = n; i > 0; --i)
+        offsets[i] = offsets[i - 1];
+    offsets[0] = 0;
+
+    // Заголовок пишеться останнім, тож недописаний файл не пройде перевірку
+    std::memcpy(data, &layout, sizeof(layout));
+
+    close();
+    return true;
+}
+
+void SnapshotWriter::close()
+{
+    if (file.isOpen())
+    {
+        if (data) file.unmap(data);
+        file.close();
+    }
+    data = nullptr;
+}
+
+TopologySnapshot::TopologySnapshot()
+    : header(nullptr), nodeData(nullptr), edgeData(nullptr), idIndex(nullptr), arcOffsetData(nullptr), arcData(nullptr)
+{
+}
+
+TopologySnapshot::~TopologySnapshot()
+{
+}
+
+bool TopologySnapshot::attach(const uchar *data, quint64 size, QString *error)
+{
+    auto fail = [&](const QString& message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    if (!data || size < sizeof(SnapshotHeader)) return fail("Файл замалий для знімка топології");
+    if (reinterpret_cast<quintptr>(data) % 8 != 0) return fail("Невирівняні дані знімка");
+
+    const SnapshotHeader *h = reinterpret_cast<const SnapshotHeader*>(data);
+
+    if (std::memcmp(h->magic, snapshotMagic, sizeof(snapshotMagic)) != 0) return fail("Файл не є знімком топології");
+    if (h->version != snapshotVersion) return fail("Непідтримувана версія знімка: " + QString::number(h->version));
+
+    SnapshotHeader expected = computeLayout(h->nodeCount, h->edgeCount);
+    if (h->headerSize != expected.headerSize || h->nodesOffset != expected.nodesOffset ||
+        h->edgesOffset != expected.edgesOffset || h->idIndexOffset != expected.idIndexOffset ||
+        h->arcOffsetsOffset != expected.arcOffsetsOffset || h->arcsOffset != expected.arcsOffset ||
+        h->fileSize != expected.fileSize || h->fileSize > size ||
+        h->nodeCount > (quint32)INT_MAX || h->edgeCount > (quint32)INT_MAX / 2)
+    {
+        return fail("Пошкоджений заголовок знімка");
+    }
+
+    const quint32 *offsets = reinterpret_cast<const quint32*>(data + h->arcOffsetsOffset);
+    if (offsets[0] != 0 || offsets[h->nodeCount] != h->edgeCount * 2) return fail("Пошкоджена секція суміжності");
+
+    // Маршрутизація індексує масиви знімка без перевірок, тож кожен індекс перевіряється тут за O(N + E)
+    const qint32 n = (qint32)h->nodeCount;
+    const qint32 m = (qint32)h->edgeCount;
+
+    for (quint32 i = 0; i < h->nodeCount; ++i)
+        if (offsets[i] > offsets[i + 1]) return fail("Пошкоджена секція суміжності");
+
+    const SnapshotEdge *edges = reinterpret_cast<const SnapshotEdge*>(data + h->edgesOffset);
+    for (quint32 e = 0; e < h->edgeCount; ++e)
+        if (edges[e].source < 0 || edges[e].source >= n || edges[e].dest < 0 || edges[e].dest >= n ||
+            edges[e].weight < 1 || edges[e].weight > maxLinkWeight || !(edges[e].capacity >= 0) || edges[e].mtu < 0)
+            return fail("Пошкоджена секція каналів");
+
+    // Дуга вузла i веде до іншого кінця свого ребра
+    const SnapshotArc *arcs = reinterpret_cast<const SnapshotArc*>(data + h->arcsOffset);
+    for (qint32 i = 0; i < n; ++i)
+    {
+        for (quint32 a = offsets[i]; a < offsets[i + 1]; ++a)
+        {
+            if (arcs[a].neighbor < 0 || arcs[a].neighbor >= n || arcs[a].edge < 0 || arcs[a].edge >= m)
+                return fail("Пошкоджена секція суміжності");
+
+            const SnapshotEdge& edge = edges[arcs[a].edge];
+            if (!(edge.source == i && edge.dest == arcs[a].neighbor) && !(edge.dest == i && edge.source == arcs[a].neighbor))
+                return fail("Пошкоджена секція суміжності");
+        }
+    }
+
+    const SnapshotIdEntry *ids = reinterpret_cast<const SnapshotIdEntry*>(data + h->idIndexOffset);
+    for (quint32 i = 0; i < h->nodeCount; ++i)
+    {
+        if (ids[i].index < 0 || ids[i].index >= n || (i > 0 && ids[i - 1].id >= ids[i].id))
+            return fail("Пошкоджений індекс вузлів");
+    }
+
+    header = h;
+    nodeData = reinterpret_cast<const SnapshotNode*>(data + h->nodesOffset);
+    edgeData = reinterpret_cast<const SnapshotEdge*>(data + h->edgesOffset);
+    idIndex = reinterpret_cast<const SnapshotIdEntry*>(data + h->idIndexOffset);
+    arcOffsetData = offsets;
+    arcData = reinterpret_cast<const SnapshotArc*>(data + h->arcsOffset);
+
+    return true;
+}
+
+std::shared_ptr<const TopologySnapshot> TopologySnapshot::open(const QString& path, QString *error)
+{
+    std::shared_ptr<TopologySnapshot> snapshot(new TopologySnapshot());
+
+    snapshot->file.setFileName(path);
+    if (!snapshot->file.open(QIODevice::ReadOnly))
+    {
+        if (error) *error = snapshot->file.errorString();
+        return nullptr;
+    }
+
+    qint64 size = snapshot->file.size();
+    const uchar *data = size > 0 ? snapshot->file.map(0, size) : nullptr;
+
+    if (!data)
+    {
+        if (error) *error = snapshot->file.errorString();
+        return nullptr;
+    }
+
+    if (!snapshot->attach(data, size, error)) return nullptr;
+
+    return snapshot;
+}
+
+std::shared_ptr<const TopologySnapshot> TopologySnapshot::fromTopology(const Topology& topology)
+{
+    std::shared_ptr<TopologySnapshot> snapshot(new TopologySnapshot());
+
+    SnapshotWriter writer;
+    writer.openBuffer(&snapshot->buffer, topology.nodes.size(), topology.edges.size());
+
+    for (const TopologyNode& node : topology.nodes)
+        writer.addNode(node.id, node.x, node.y, node.region);
+    for (const TopologyEdge& edge : topology.edges)
+        writer.addEdge(edge.source, edge.dest, edge.weight, edge.type, edge.capacity, edge.mtu);
+
+    if (!writer.finish()) return nullptr;
+
+    const uchar *data = reinterpret_cast<const uchar*>(snapshot->buffer.constData());
+    if (!snapshot->attach(data, snapshot->buffer.size(), nullptr)) return nullptr;
+
+    return snapshot;
+}
+
+bool TopologySnapshot::save(const Topology& topology, const QString& path, QString *error)
+{
+    SnapshotWriter writer;
+    bool ok = writer.open(path, topology.nodes.size(), topology.edges.size());
+
+    for (size_t i = 0; ok && i < topology.nodes.size(); ++i)
+        ok = writer.addNode(topology.nodes[i].id, topology.nodes[i].x, topology.nodes[i].y, topology.nodes[i].region);
+    for (size_t i = 0; ok && i < topology.edges.size(); ++i)
+        ok = writer.addEdge(topology.edges[i].source, topology.edges[i].dest, topology.edges[i].weight, topology.edges[i].type,
+                            topology.edges[i].capacity, topology.edges[i].mtu);
+
+    if (ok) ok = writer.finish();
+
+    if (!ok && error)
+        *error = writer.errorString().isEmpty() ? "Некоректна топологія" : writer.errorString();
+
+    return ok;
+}
+
+int TopologySnapshot::indexOf(int id) const
+{
+    const SnapshotIdEntry *end = idIndex + header->nodeCount;
+    const SnapshotIdEntry *it = std::lower_bound(idIndex, end, id, [](const SnapshotIdEntry& entry, int value) {
+        return entry.id < value;
+    });
+
+    return (it != end && it->id == id) ? it->index : -1;
+}
+
+Topology TopologySnapshot::toTopology() const
+{
+    Topology topology;
+    topology.nodes.reserve(nodeCount());
+    topology.edges.reserve(edgeCount());
+
+    for (quint32 i = 0; i < nodeCount(); ++i)
+        topology.nodes.push_back({nodeData[i].id, nodeData[i].x, nodeData[i].y, nodeData[i].region});
+
+    for (quint32 e = 0; e < edgeCount(); ++e)
+        topology.edges.push_back({edgeData[e].source, edgeData[e].dest, edgeData[e].weight, (EdgeType)edgeData[e].type,
+                                  edgeData[e].capacity, edgeData[e].mtu});
+
+    return topology;
+}
@@ -0,0 +1,126 @@
+#ifndef TOPOLOGYSNAPSHOT_H
+#define TOPOLOGYSNAPSHOT_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <memory>
+#include "topology.h"
+
+// Формат знімка (little-endian, всі секції вирівняні на 8 байт):
+// заголовок | вузли | ребра | індекс id | зміщення суміжності (N + 1) | дуги суміжності (2E)
+// Секція суміжності - готовий CSR-граф, тому файл після mmap використовується для маршрутизації без розбору
+
+struct SnapshotHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;
+    quint32 nodeCount;
+    quint32 edgeCount;
+    quint64 nodesOffset;
+    quint64 edgesOffset;
+    quint64 idIndexOffset;
+    quint64 arcOffsetsOffset;
+    quint64 arcsOffset;
+    quint64 fileSize;
+};
+
+struct SnapshotNode
+{
+    qint32 id;
+    qint32 region;
+    double x;
+    double y;
+};
+
+struct SnapshotEdge
+{
+    qint32 source;
+    qint32 dest;
+    qint32 weight;
+    qint32 type;
+    double capacity;    // Мбіт/с
+    qint32 mtu;         // байт; 0 - канал не обмежує розмір пакета
+    qint32 reserved;
+};
+
+struct SnapshotIdEntry
+{
+    qint32 id;
+    qint32 index;
+};
+
+struct SnapshotArc
+{
+    qint32 neighbor;
+    qint32 edge;
+};
+
+class SnapshotWriter
+{
+public:
+    SnapshotWriter();
+    ~SnapshotWriter();
+
+    bool open(const QString& path, quint32 nodeCount, quint32 edgeCount);
+    void openBuffer(QByteArray *buffer, quint32 nodeCount, quint32 edgeCount);
+
+    bool addNode(int id, double x, double y, int region = 0);
+    bool addEdge(int source, int dest, int weight, EdgeType type, double capacity = defaultLinkCapacity, int mtu = 0);
+    bool finish();
+
+    QString errorString() const { return error; }
+
+private:
+    QFile file;
+    uchar *data;
+    SnapshotHeader layout;
+    quint32 nodesWritten;
+    quint32 edgesWritten;
+    QString error;
+
+    void prepare(quint32 nodeCount, quint32 edgeCount);
+    void close();
+};
+
+class TopologySnapshot
+{
+public:
+    ~TopologySnapshot();
+
+    static std::shared_ptr<const TopologySnapshot> open(const QString& path, QString *error = nullptr);
+    static std::shared_ptr<const TopologySnapshot> fromTopology(const Topology& topology);
+    static bool save(const Topology& topology, const QString& path, QString *error = nullptr);
+
+    quint32 nodeCount() const { return header->nodeCount; }
+    quint32 edgeCount() const { return header->edgeCount; }
+
+    const SnapshotNode *nodes() const { return nodeData; }
+    const SnapshotEdge *edges() const { return edgeData; }
+    const quint32 *arcOffsets() const { return arcOffsetData; }
+    const SnapshotArc *arcs() const { return arcData; }
+    const SnapshotIdEntry *idOrder() const { return idIndex; }
+
+    int indexOf(int id) const;
+    Topology toTopology() const;
+
+private:
+    TopologySnapshot();
+    TopologySnapshot(const TopologySnapshot&) = delete;
+    TopologySnapshot& operator=(const TopologySnapshot&) = delete;
+
+    bool attach(const uchar *data, quint64 size, QString *error);
+
+    QFile file;
+    QByteArray buffer;
+
+    const SnapshotHeader *header;
+    const SnapshotNode *nodeData;
+    const SnapshotEdge *edgeData;
+    const SnapshotIdEntry *idIndex;
+    const quint32 *arcOffsetData;
+    const SnapshotArc *arcData;
+};
+
+#endif // TOPOLOGYSNAPSHOT_H
@@ -0,0 +1,129 @@
+#include "workload.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+WorkloadGenerator::WorkloadGenerator(const Topology& topology, const WorkloadParams& params)
+    : params(params), arrivalRng(params.seed, UINT32_MAX), clock(0), phaseEnd(0), nextId(1)
+{
+    std::map<int, int> regionIndex;
+    for (const TopologyNode& node : topology.nodes)
+    {
+        auto it = regionIndex.find(node.region);
+        if (it == regionIndex.end())
+        {
+            it = regionIndex.insert({node.region, (int)regionNodes.size()}).first;
+            regionNodes.emplace_back();
+        }
+        regionNodes[it->second].push_back(node.id);
+    }
+
+    int r = (int)regionNodes.size();
+    matrix.assign((size_t)r * r, 0.0);
+
+    // Гравітаційна модель: попит пропорційний добутку "мас" регіонів (кількості вузлів);
+    // усередині регіону трафік можливий лише за наявності двох вузлів
+    double total = 0;
+    for (int i = 0; i < r; ++i)
+    {
+        for (int j = 0; j < r; ++j)
+        {
+            double ni = regionNodes[i].size();
+            double nj = regionNodes[j].size();
+            if (i == j && ni < 2) continue;
+
+            double d = params.demand == GravityDemand ? ni * nj : 1.0;
+            if (params.demand == GravityDemand && i == j) d = ni * (ni - 1);
+
+            matrix[i * r + j] = d;
+            total += d;
+        }
+    }
+
+    cumulative.resize(matrix.size());
+    double sum = 0;
+    for (size_t k = 0; k < matrix.size(); ++k)
+    {
+        if (total > 0) matrix[k] /= total;
+        sum += matrix[k];
+        cumulative[k] = sum;
+    }
+
+    if (params.arrivals == OnOffArrivals)
+        phaseEnd = exponential(params.onMean);
+}
+
+double WorkloadGenerator::exponential(double mean)
+{
+    return -std::log(1.0 - arrivalRng.uniform()) * mean;
+}
+
+int WorkloadGenerator::flowBytes(CounterRng& rng) const
+{
+    double u = 1.0 - rng.uniform();
+    double size = params.minFlowBytes / std::pow(u, 1.0 / params.paretoAlpha);
+    return (int)std::min(size, (double)params.maxFlowBytes);
+}
+
+double WorkloadGenerator::meanFlowBytes() const
+{
+    double a = params.paretoAlpha;
+    double lo = params.minFlowBytes;
+    double hi = params.maxFlowBytes;
+    if (hi <= lo) return lo;
+
+    // Середнє Парето, обрізаного зверху значенням hi
+    double tail = std::pow(lo / hi, a);
+    if (std::fabs(a - 1.0) < 1e-9) return lo * std::log(hi / lo) + hi * tail;
+    return a * lo / (a - 1.0) * (1.0 - std::pow(lo / hi, a - 1.0)) + hi * tail;
+}
+
+bool WorkloadGenerator::next(Flow& flow)
+{
+    double rate = params.peakRate * params.load;
+    if (rate <= 0 || cumulative.empty() || cumulative.back() <= 0) return false;
+
+    if (params.arrivals == PoissonArrivals)
+    {
+        clock += exponential(1.0 / rate);
+    }
+    else
+    {
+        // Під час "on" інтенсивність підвищена так, щоб середня дорівнювала rate
+        double onRate = rate * (params.onMean + params.offMean) / params.onMean;
+        double t = clock + exponential(1.0 / onRate);
+
+        // Надходження після кінця "on" переноситься в наступний період: експоненційний розподіл без пам'яті
+        while (t > phaseEnd)
+        {
+            double onStart = phaseEnd + exponential(params.offMean);
+            phaseEnd = onStart + exponential(params.onMean);
+            t = onStart + exponential(1.0 / onRate);
+        }
+        clock = t;
+    }
+
+    if (clock > params.duration) return false;
+
+    CounterRng rng(params.seed, nextId);
+
+    double pick = rng.uniform() * cumulative.back();
+    size_t cell = std::upper_bound(cumulative.begin(), cumulative.end(), pick) - cumulative.begin();
+    cell = std::min(cell, cumulative.size() - 1);
+
+    int r = (int)regionNodes.size();
+    const std::vector<int>& from = regionNodes[cell / r];
+    const std::vector<int>& to = regionNodes[cell % r];
+
+    flow.id = nextId++;
+    flow.start = clock;
+    flow.sourceId = from[rng.below((int)from.size())];
+    do
+    {
+        flow.destId = to[rng.below((int)to.size())];
+    } while (flow.destId == flow.sourceId);
+    flow.bytes = flowBytes(rng);
+
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <cstdint>
+#include <vector>
+#include "counterrng.h"
+#include "topology.h"
+
+enum DemandModel
+{
+    UniformDemand,
+    GravityDemand
+};
+
+enum ArrivalProcess
+{
+    PoissonArrivals,
+    OnOffArrivals
+};
+
+struct WorkloadParams
+{
+    DemandModel demand = GravityDemand;
+    ArrivalProcess arrivals = PoissonArrivals;
+
+    double peakRate = 20.0;         // потоків за секунду при 100% навантаження
+    double load = 0.7;              // частка пікового навантаження
+
+    double onMean = 1.0;            // on/off: середні тривалості періодів, с
+    double offMean = 2.0;
+
+    double paretoAlpha = 1.2;       // розміри потоків: обмежений Парето
+    int minFlowBytes = 1000;
+    int maxFlowBytes = 10000000;
+
+    double duration = 30.0;         // с
+    uint64_t seed = 1;
+};
+
+struct Flow
+{
+    uint32_t id;
+    double start;                   // с від початку навантаження
+    int sourceId;
+    int destId;
+    int bytes;
+};
+
+// Потоки генеруються по одному в порядку часу, тож навантаження будь-якої тривалості не матеріалізується в пам'яті.
+// Атрибути потоку залежать лише від (seed, id потоку), моменти надходження - від окремого потоку RNG
+class WorkloadGenerator
+{
+public:
+    WorkloadGenerator(const Topology& topology, const WorkloadParams& params);
+
+    bool next(Flow& flow);
+
+    int regionCount() const { return (int)regionNodes.size(); }
+    double demand(int from, int to) const { return matrix[from * regionNodes.size() + to]; }
+    double meanFlowBytes() const;
+
+private:
+    WorkloadParams params;
+
+    std::vector<std::vector<int>> regionNodes;
+    std::vector<double> matrix;             // нормовані попити регіон -> регіон
+    std::vector<double> cumulative;
+
+    CounterRng arrivalRng;
+    double clock;
+    double phaseEnd;        // кінець поточного періоду "on"
+    uint32_t nextId;
+
+    double exponential(double mean);
+    int flowBytes(CounterRng& rng) const;
+};
+
+#endif // WORKLOAD_H